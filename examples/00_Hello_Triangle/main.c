@@ -15,7 +15,7 @@ int main() {
   vertices[2] = (vec3){-0.5, -0.5, 0.0};
 
   unsigned indices_id = 0;
-  unsigned * indices = GpuCallocIndices(3, &indices_id);
+  unsigned short * indices = GpuCallocIndices16(3, &indices_id);
   indices[0] = 0;
   indices[1] = 1;
   indices[2] = 2;
@@ -45,7 +45,7 @@ int main() {
 
   unsigned ppo = GpuPpo(vert, frag);
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
       switch (event.type) {
@@ -58,7 +58,7 @@ int main() {
     GpuClear();
     GpuBindPpo(ppo);
     GpuBindTextures(0, 16, textures);
-    GpuBindIndices(indices_id);
+    GpuBindIndices(indices_id, gpu_u16_e);
     GpuBindCommands(commands_id);
     GpuDraw(gpu_triangles_e, 0, 1);
     GpuSwap(dpy, win);
@@ -3,46 +3,31 @@
 enum {MAX_STR = 10000};
 
 struct {
-  char mesh_ib     [MAX_STR];
-  char mesh_id     [MAX_STR];
-  char mesh_normals[MAX_STR];
-  char mesh_uv     [MAX_STR];
-  char mesh_vb     [MAX_STR];
+  char mesh        [MAX_STR];
   char xform_r     [MAX_STR];
   char xform_s     [MAX_STR];
   char xform_t     [MAX_STR];
 } g_resources = {
-  .mesh_ib      = "meshes/MeshIB.binary",
-  .mesh_id      = "meshes/MeshID.binary",
-  .mesh_normals = "meshes/MeshNormals.binary",
-  .mesh_uv      = "meshes/MeshUV.binary",
-  .mesh_vb      = "meshes/MeshVB.binary",
+  .mesh         = "meshes/Mesh.gpumesh",
   .xform_r      = "meshes/XformsRotationQuaternion.binary",
   .xform_s      = "meshes/XformsScale.binary",
   .xform_t      = "meshes/XformsTranslation.binary",
 };
 
-#define GPUMESH_NO_HEADER_IMPORT
-#include "meshes/MeshIBVB.h"
-#include "meshes/MeshID.h"
-#include "meshes/MeshNormals.h"
-#include "meshes/MeshUV.h"
 #include "meshes/Xforms.h"
 
-struct gpu_cmd_t g_draw_commands[e_draw_count] = {0};
-
 int main() {
   Display * dpy = NULL;
   Window win = 0;
   GpuWindow("Mesh Loading", sizeof("Mesh Loading"), 1280, 720, 4, NULL, &dpy, &win);
   GpuSetDebugCallback(GpuDebugCallback);
 
-  unsigned di_buf = 0;
-  unsigned ib_buf = 0;
-  unsigned vb_tex = SimpleMeshUploadIBVB(g_resources.mesh_ib, g_resources.mesh_vb, 0, 0, 0, &di_buf, &ib_buf, NULL, (unsigned *)g_draw_commands);
-  unsigned uv_tex = SimpleMeshUploadUV(g_resources.mesh_uv, 0, NULL);
-  unsigned id_tex = SimpleMeshUploadID(g_resources.mesh_id, 0, NULL);
-  unsigned normals_tex = SimpleMeshUploadNormals(g_resources.mesh_normals, 0, NULL);
+  struct gpu_mesh_t mesh = {0};
+  GpuLoadMeshFile(g_resources.mesh, 0, 0, &mesh);
+  unsigned vb_tex = GpuMeshTex(&mesh, "position");
+  unsigned uv_tex = GpuMeshTex(&mesh, "uv");
+  unsigned id_tex = GpuMeshTex(&mesh, "id");
+  unsigned normals_tex = GpuMeshTex(&mesh, "normal");
   unsigned xform_s_tex = SimpleMeshUploadXformsScale(g_resources.xform_s, 0, NULL);
   unsigned xform_r_tex = SimpleMeshUploadXformsRotationQuaternion(g_resources.xform_r, 0, NULL);
   unsigned xform_t_tex = SimpleMeshUploadXformsTranslation(g_resources.xform_t, 0, NULL);
@@ -66,6 +51,9 @@ int main() {
       "layout(binding = 5) uniform samplerBuffer  s_xfr;"           "\n"
       "layout(binding = 6) uniform samplerBuffer  s_xft;"           "\n"
       ""                                                            "\n"
+      "layout(location = 0) uniform vec3 u_aabb_min;"               "\n"
+      "layout(location = 1) uniform vec3 u_aabb_max;"               "\n"
+      ""                                                            "\n"
       "layout(location = 0) out vec2 g_uv;"                         "\n"
       ""                                                            "\n"
       "vec4 qinv(vec4 v) {"                                         "\n"
@@ -83,7 +71,7 @@ int main() {
       "}"                                                           "\n"
       ""                                                            "\n"
       "void main() {"                                               "\n"
-      "  vec3 pos = texelFetch(s_vb,  gl_VertexID).xyz;"            "\n"
+      "  vec3 pos = GpuDecodePosition(texelFetch(s_vb, gl_VertexID), u_aabb_min, u_aabb_max);" "\n"
       "  int  id  = texelFetch(s_id,  gl_VertexID).x;"              "\n"
       "  g_uv     = texelFetch(s_uv,  gl_VertexID).xy;"             "\n"
       "  vec3 xfs = texelFetch(s_xfs, id).xyz;"                     "\n"
@@ -111,9 +99,12 @@ int main() {
       "  g_color = vec4(g_uv.x, g_uv.y, 1, 1);"                     "\n"
       "}"                                                           "\n");
 
+  GpuV3F(vert, 0, 1, mesh.aabb_min);
+  GpuV3F(vert, 1, 1, mesh.aabb_max);
+
   unsigned ppo = GpuPpo(vert, frag);
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
       switch (event.type) {
@@ -124,7 +115,11 @@ int main() {
       }
     }
     GpuClear();
-    MeshDraw(ppo, 0, 16, textures, ib_buf, di_buf, 0, e_draw_count);
+    GpuBindPpo(ppo);
+    GpuBindTextures(0, 16, textures);
+    GpuBindIndices(mesh.idb, mesh.index_type);
+    GpuBindCommands(mesh.dib);
+    GpuDraw(gpu_triangles_e, 0, mesh.cmd_count);
     GpuSwap(dpy, win);
   }
 
@@ -19,11 +19,7 @@ typedef struct { float x, y, z, w; } vec4;
 enum {MAX_STR = 10000};
 
 struct {
-  char mesh_ib     [MAX_STR];
-  char mesh_id     [MAX_STR];
-  char mesh_normals[MAX_STR];
-  char mesh_uv     [MAX_STR];
-  char mesh_vb     [MAX_STR];
+  char mesh        [MAX_STR];
   char textures    [MAX_STR];
   char cubemaps    [MAX_STR];
   char vs_cube     [MAX_STR];
@@ -33,13 +29,9 @@ struct {
   char vs_quad     [MAX_STR];
   char fs_quad     [MAX_STR];
 } g_resources = {
-  .mesh_ib      = "meshes/MeshIB.binary",
-  .mesh_id      = "meshes/MeshID.binary",
-  .mesh_normals = "meshes/MeshNormals.binary",
-  .mesh_uv      = "meshes/MeshUV.binary",
-  .mesh_vb      = "meshes/MeshVB.binary",
-  .textures     = "textures/textures.binary",
-  .cubemaps     = "textures/cubemaps.binary",
+  .mesh         = "meshes/Mesh.gpumesh",
+  .textures     = "textures/textures.gpuimg",
+  .cubemaps     = "textures/cubemaps.gpuimg",
   .vs_cube      = "shaders/cube.vert",
   .fs_cube      = "shaders/cube.frag",
   .vs_mesh      = "shaders/mesh.vert",
@@ -91,42 +83,36 @@ static inline unsigned long GetTimeMs() {
   return tv.tv_sec * 1000UL + tv.tv_usec / 1000UL;
 }
 
-#define GPUMESH_NO_HEADER_IMPORT
-#include "meshes/MeshIBVB.h"
-#include "meshes/MeshID.h"
-#include "meshes/MeshNormals.h"
-#include "meshes/MeshUV.h"
-
-struct gpu_cmd_t g_draw_commands[e_draw_count];
-
 int main() {
   GpuSysGetLibcProcedureAddresses();
   ProfCalloc = g_gpulib_libc.calloc;
   ProfFree = g_gpulib_libc.free;
   profAlloc(1000000);
 
-  char scancodes[256 * 5] = {0};
   Display * dpy = NULL;
   Window win = 0;
-  GpuWindow("Instancing and MRT", sizeof("Instancing and MRT"), 1280, 720, 4, scancodes, &dpy, &win);
+  GpuWindow("Instancing and MRT", sizeof("Instancing and MRT"), 1280, 720, 4, NULL, &dpy, &win);
   GpuSetDebugCallback(GpuDebugCallback);
 
   profB("Mesh upload");
-  unsigned di_buf = 0;
-  unsigned ib_buf = 0;
-  unsigned vb_tex = SimpleMeshUploadIBVB(g_resources.mesh_ib, g_resources.mesh_vb, 0xC2, 0, 0, &di_buf, &ib_buf, NULL, (unsigned *)g_draw_commands);
-  unsigned ib_tex = SimpleMeshUploadID(g_resources.mesh_id, 0, NULL);
-  unsigned no_tex = SimpleMeshUploadNormals(g_resources.mesh_normals, 0, NULL);
-  unsigned uv_tex = SimpleMeshUploadUV(g_resources.mesh_uv, 0, NULL);
+  struct gpu_mesh_t mesh = {0};
+  GpuLoadMeshFile(g_resources.mesh, 0, 0xC2, &mesh);
+  unsigned vb_tex = GpuMeshTex(&mesh, "position");
+  unsigned ib_tex = GpuMeshTex(&mesh, "id");
+  unsigned no_tex = GpuMeshTex(&mesh, "normal");
+  unsigned uv_tex = GpuMeshTex(&mesh, "uv");
   profE("Mesh upload");
 
-  {
-    glBindBuffer(0x8F3F, di_buf);
-    struct gpu_cmd_t * cmds = glMapBufferRange(0x8F3F, 0, e_draw_count * sizeof(struct gpu_cmd_t), 0xC2);
-    cmds[0].instance_count = 30;
-    cmds[1].instance_count = 30;
-    cmds[2].instance_count = 30;
-    glBindBuffer(0x8F3F, 0);
+  // One command per instance, instance_first selects its position and GpuMeshLod its level of detail every frame. The
+  // shader reads instance_first through gl_BaseInstanceARB, without GL_ARB_shader_draw_parameters every mesh is drawn
+  // whole with 30 instances.
+  int has_draw_parameters = GpuSysIsExtensionSupported("GL_ARB_shader_draw_parameters");
+  unsigned instance_cmds_id = 0;
+  struct gpu_cmd_t * instance_cmds = GpuMallocCommands(30 + 30 + 30, &instance_cmds_id);
+  int instance_cmds_count = has_draw_parameters ? 30 + 30 + 30 : mesh.cmd_count;
+  for (int i = 0; i < mesh.cmd_count && !has_draw_parameters; i += 1) {
+    instance_cmds[i] = mesh.cmds[i];
+    instance_cmds[i].instance_count = 30;
   }
 
   unsigned instance_pos_id = 0;
@@ -140,11 +126,13 @@ int main() {
 
   unsigned instance_pos_tex = GpuCast(instance_pos_id, gpu_xyz_f32_e, 0, (30 + 30 + 30) * sizeof(vec3));
 
-  unsigned textures = GpuCallocImg(gpu_srgb_b8_e, 512, 512, 3, 4);
-  unsigned skyboxes = GpuCallocCbm(gpu_srgb_b8_e, 512, 512, 2, 4);
-
-  GpuLoadRgbImgBinary(textures, 512, 512, 3, g_resources.textures);
-  GpuLoadRgbCbmBinary(skyboxes, 512, 512, 2, g_resources.cubemaps);
+  // Baked by textures/textures_cubemaps_to_binaries.sh with tools/gpuimage, mipmaps included
+  unsigned textures = GpuLoadImgFile(g_resources.textures, NULL);
+  unsigned skyboxes = GpuLoadImgFile(g_resources.cubemaps, NULL);
+  if (textures == 0 || skyboxes == 0) {
+    print(GPULIB_MAX_PRINT_BYTES, "Can't load %s or %s, run textures/textures_cubemaps_to_binaries.sh\n", g_resources.textures, g_resources.cubemaps);
+    return 1;
+  }
 
   unsigned mrt_msi_depth = GpuCallocMsi(gpu_d_f32_e, 1280, 720, 1, 4);
   unsigned mrt_msi_color = GpuCallocMsi(gpu_srgba_b8_e, 1280, 720, 1, 4);
@@ -200,30 +188,14 @@ int main() {
   float fov = 1.f / tandegdiv2(85.f);
   float fov_x = fov / (1280 / 720.f);
   float fov_y = fov;
-
-  char key_d = 0;
-  char key_a = 0;
-  char key_e = 0;
-  char key_q = 0;
-  char key_w = 0;
-  char key_s = 0;
-  char key_1 = 0;
-  char key_2 = 0;
-  char key_3 = 0;
-  char key_4 = 0;
-  char key_5 = 0;
-  char key_6 = 0;
-  char key_7 = 0;
-  char key_8 = 0;
-  char key_9 = 0;
-  char key_0 = 0;
+  float pixels_per_unit = fov_y * 720 / 2.f;
 
   GpuSysSetRelativeMouseMode(dpy, win, 1);
 
   unsigned long t_init = GetTimeMs();
   unsigned long t_prev = GetTimeMs();
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     profB("Frame");
     unsigned long t_curr = GetTimeMs();
     double dt = ((t_curr - t_prev) * 60.0) / 1000.0;
@@ -233,6 +205,7 @@ int main() {
     profB("Events");
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
+      GpuEvent(&event);
       switch (event.type) {
         break; case ClientMessage: {
           if (event.xclient.data.l[0] == quit) {
@@ -241,44 +214,6 @@ int main() {
             goto exit;
           }
         }
-        break; case KeyPress: {
-          char * scancode = &scancodes[event.xkey.keycode * 5];
-          if (nstreq(4, scancode, "AC03")) key_d = 1;
-          if (nstreq(4, scancode, "AC01")) key_a = 1;
-          if (nstreq(4, scancode, "AD03")) key_e = 1;
-          if (nstreq(4, scancode, "AD01")) key_q = 1;
-          if (nstreq(4, scancode, "AD02")) key_w = 1;
-          if (nstreq(4, scancode, "AC02")) key_s = 1;
-          if (nstreq(4, scancode, "AE01")) key_1 = 1;
-          if (nstreq(4, scancode, "AE02")) key_2 = 1;
-          if (nstreq(4, scancode, "AE03")) key_3 = 1;
-          if (nstreq(4, scancode, "AE04")) key_4 = 1;
-          if (nstreq(4, scancode, "AE05")) key_5 = 1;
-          if (nstreq(4, scancode, "AE06")) key_6 = 1;
-          if (nstreq(4, scancode, "AE07")) key_7 = 1;
-          if (nstreq(4, scancode, "AE08")) key_8 = 1;
-          if (nstreq(4, scancode, "AE09")) key_9 = 1;
-          if (nstreq(4, scancode, "AE10")) key_0 = 1;
-        }
-        break; case KeyRelease: {
-          char * scancode = &scancodes[event.xkey.keycode * 5];
-          if (nstreq(4, scancode, "AC03")) key_d = 0;
-          if (nstreq(4, scancode, "AC01")) key_a = 0;
-          if (nstreq(4, scancode, "AD03")) key_e = 0;
-          if (nstreq(4, scancode, "AD01")) key_q = 0;
-          if (nstreq(4, scancode, "AD02")) key_w = 0;
-          if (nstreq(4, scancode, "AC02")) key_s = 0;
-          if (nstreq(4, scancode, "AE01")) key_1 = 0;
-          if (nstreq(4, scancode, "AE02")) key_2 = 0;
-          if (nstreq(4, scancode, "AE03")) key_3 = 0;
-          if (nstreq(4, scancode, "AE04")) key_4 = 0;
-          if (nstreq(4, scancode, "AE05")) key_5 = 0;
-          if (nstreq(4, scancode, "AE06")) key_6 = 0;
-          if (nstreq(4, scancode, "AE07")) key_7 = 0;
-          if (nstreq(4, scancode, "AE08")) key_8 = 0;
-          if (nstreq(4, scancode, "AE09")) key_9 = 0;
-          if (nstreq(4, scancode, "AE10")) key_0 = 0;
-        }
         break; case GenericEvent: {
           if (XGetEventData(dpy, &event.xcookie) &&
               event.xcookie.evtype == XI_RawMotion)
@@ -306,29 +241,40 @@ int main() {
     cam_rot = qmul(cam_rot, (vec4){sindegdiv2(my), 0, 0, cosdegdiv2(my)});
     cam_rot = qmul((vec4){0, sindegdiv2(mx), 0, cosdegdiv2(mx)}, cam_rot);
 
-    if (key_d) cam_pos = v3addv4(cam_pos, qrot((vec4){0.05f, 0, 0}, cam_rot));
-    if (key_a) cam_pos = v3subv4(cam_pos, qrot((vec4){0.05f, 0, 0}, cam_rot));
-    if (key_e) cam_pos = v3addv4(cam_pos, qrot((vec4){0, 0.05f, 0}, cam_rot));
-    if (key_q) cam_pos = v3subv4(cam_pos, qrot((vec4){0, 0.05f, 0}, cam_rot));
-    if (key_w) cam_pos = v3addv4(cam_pos, qrot((vec4){0, 0, 0.05f}, cam_rot));
-    if (key_s) cam_pos = v3subv4(cam_pos, qrot((vec4){0, 0, 0.05f}, cam_rot));
+    if (GpuKeyDown(gpu_key_d_e)) cam_pos = v3addv4(cam_pos, qrot((vec4){0.05f, 0, 0}, cam_rot));
+    if (GpuKeyDown(gpu_key_a_e)) cam_pos = v3subv4(cam_pos, qrot((vec4){0.05f, 0, 0}, cam_rot));
+    if (GpuKeyDown(gpu_key_e_e)) cam_pos = v3addv4(cam_pos, qrot((vec4){0, 0.05f, 0}, cam_rot));
+    if (GpuKeyDown(gpu_key_q_e)) cam_pos = v3subv4(cam_pos, qrot((vec4){0, 0.05f, 0}, cam_rot));
+    if (GpuKeyDown(gpu_key_w_e)) cam_pos = v3addv4(cam_pos, qrot((vec4){0, 0, 0.05f}, cam_rot));
+    if (GpuKeyDown(gpu_key_s_e)) cam_pos = v3subv4(cam_pos, qrot((vec4){0, 0, 0.05f}, cam_rot));
     profE("Camera");
 
     static int show_pass = 0;
-    if (key_1) show_pass = 1;
-    if (key_2) show_pass = 2;
-    if (key_3) show_pass = 3;
-    if (key_4) show_pass = 4;
-    if (key_5) show_pass = 5;
-    if (key_6) show_pass = 6;
-    if (key_7) show_pass = 7;
-    if (key_8) show_pass = 8;
+    if (GpuKeyPressed(gpu_key_1_e)) show_pass = 1;
+    if (GpuKeyPressed(gpu_key_2_e)) show_pass = 2;
+    if (GpuKeyPressed(gpu_key_3_e)) show_pass = 3;
+    if (GpuKeyPressed(gpu_key_4_e)) show_pass = 4;
+    if (GpuKeyPressed(gpu_key_5_e)) show_pass = 5;
+    if (GpuKeyPressed(gpu_key_6_e)) show_pass = 6;
+    if (GpuKeyPressed(gpu_key_7_e)) show_pass = 7;
+    if (GpuKeyPressed(gpu_key_8_e)) show_pass = 8;
 
     profB("Instance pos update");
     for (int i = 0; i < (30 + 30 + 30); i += 1)
       instance_pos[i].y = fsin((t_curr - t_init) * 0.0015 + i * 0.5) * 0.3;
     profE("Instance pos update");
 
+    static int lod = 1;
+    if (GpuKeyPressed(gpu_key_l_e)) lod = !lod;
+
+    profB("Levels of detail");
+    for (int i = 0; i < (30 + 30 + 30) && has_draw_parameters; i += 1) {
+      GpuMeshLod(&mesh, i / 30, &cam_pos.x, &instance_pos[i].x, pixels_per_unit, lod ? 1.f : 0.f, &instance_cmds[i]);
+      instance_cmds[i].instance_count = 1;
+      instance_cmds[i].instance_first = i;
+    }
+    profE("Levels of detail");
+
     profB("Uniforms");
     GpuV3F(mesh_vert, 0, 1, &cam_pos.x);
     GpuV4F(mesh_vert, 1, 1, &cam_rot.x);
@@ -343,8 +289,8 @@ int main() {
     GpuF32(cube_vert, 2, 1, &fov_y);
 
     static int cube_index = 0;
-    if (key_9) { cube_index = 1; show_pass = 0; }
-    if (key_0) { cube_index = 0; show_pass = 0; }
+    if (GpuKeyPressed(gpu_key_9_e)) { cube_index = 1; show_pass = 0; }
+    if (GpuKeyPressed(gpu_key_0_e)) { cube_index = 0; show_pass = 0; }
     GpuI32(mesh_frag, 2, 1, &cube_index);
     GpuI32(cube_frag, 0, 1, &cube_index);
 
@@ -364,10 +310,10 @@ int main() {
     }
     GpuBindTextures(0, 16, texture_ids);
     GpuBindSamplers(0, 16, sampler_ids);
-    GpuBindCommands(di_buf);
-    GpuBindIndices(ib_buf);
+    GpuBindCommands(instance_cmds_id);
+    GpuBindIndices(mesh.idb, mesh.index_type);
     GpuBindPpo(mesh_ppo);
-    GpuDraw(gpu_triangles_e, 0, e_draw_count);
+    GpuDraw(gpu_triangles_e, 0, instance_cmds_count);
     GpuBindFbo(0);
 
     GpuBlit(mrt_msi_fbo, 0, 0, 0, 1280, 720,
@@ -7,6 +7,7 @@
 #extension GL_ARB_shading_language_packing   : enable
 #extension GL_ARB_explicit_uniform_location  : enable
 #extension GL_ARB_fragment_coord_conventions : enable
+#extension GL_ARB_shader_draw_parameters     : enable
 out gl_PerVertex { vec4 gl_Position; };
 
 layout(location = 0) uniform vec3  g_cam_pos;
@@ -39,7 +40,11 @@ void main() {
   g_uv     = texelFetch(s_uv,     gl_VertexID).xy;
   g_normal = texelFetch(s_normal, gl_VertexID).xyz;
 
+#ifdef GL_ARB_shader_draw_parameters
+  g_pos += texelFetch(s_instance_pos, gl_BaseInstanceARB + gl_InstanceID).xyz;
+#else
   g_pos += texelFetch(s_instance_pos, (g_index * 30) + gl_InstanceID).xyz;
+#endif
 
   vec3 mv = g_pos;
   mv -= g_cam_pos;
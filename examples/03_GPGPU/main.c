@@ -9,18 +9,7 @@ int main() {
   int dim_x = 800;
   int dim_y = 450;
 
-  char vert_string[4096] = GPU_VERT_HEAD
-      "const vec2 g_tri[] = vec2[]("                    "\n"
-      "  vec2(-1,-1),"                                  "\n"
-      "  vec2(-1, 3),"                                  "\n"
-      "  vec2( 3,-1)"                                   "\n"
-      ");"                                              "\n"
-      ""                                                "\n"
-      "void main() {"                                   "\n"
-      "  gl_Position = vec4(g_tri[gl_VertexID], 0, 1);" "\n"
-      "}"                                               "\n";
-
-  char frag_string[4096] = GPU_FRAG_HEAD
+  char frag_string[4096] = GPU_KERNEL_HEAD
       "layout(location = 0) out vec4 g_color;"       "\n"
       ""                                             "\n"
       "void main() {"                                "\n"
@@ -50,14 +39,12 @@ int main() {
       "  g_color = C;"                               "\n"
       "}"                                            "\n";
 
-  unsigned vert = GpuVert(vert_string);
-  unsigned frag = GpuFrag(frag_string);
-  unsigned ppo  = GpuPpo(vert, frag);
+  unsigned frag = 0;
+  unsigned ppo  = GpuKernel(frag_string, &frag);
 
   unsigned img_tex = GpuCallocImg(gpu_rgba_f32_e, dim_x, dim_y, 1, 1);
-  unsigned fbo = GpuFbo(img_tex, 0, 0, 0, 0, 0, 0, 0, 0, 0);
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
       switch (event.type) {
@@ -68,17 +55,13 @@ int main() {
       }
     }
 
-    if (GpuDebugVert(&vert, vert_string, sizeof(vert_string)) ||
-        GpuDebugFrag(&frag, frag_string, sizeof(frag_string))) {
+    if (GpuDebugFrag(&frag, frag_string, sizeof(frag_string))) {
       glDeleteProgramPipelines(1, &ppo);
-      ppo = GpuPpo(vert, frag);
+      ppo = GpuPpo(GpuKernelVert(), frag);
     }
 
     GpuClear();
-    GpuBindPpo(ppo);
-    GpuViewport(0, 0, dim_x, dim_y);
-    GpuBindFbo(fbo);
-    GpuDrawOnce(gpu_triangles_e, 0, 3, 1);
+    GpuKernelRun(ppo, img_tex, 0, 0, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, 0, dim_x, dim_y);
     GpuBindFbo(0);
     GpuViewport(0, 0, 1280, 720);
 
@@ -2,13 +2,12 @@
 #include "../../gpulib_imgui.h"
 
 int main() {
-  char scancodes[256 * 5] = {0};
   Display * dpy = NULL;
   Window win = 0;
-  GpuWindow("Dear ImGui", sizeof("Dear ImGui"), 1280, 720, 4, scancodes, &dpy, &win);
+  GpuWindow("Dear ImGui", sizeof("Dear ImGui"), 1280, 720, 4, NULL, &dpy, &win);
   GpuSetDebugCallback(GpuDebugCallback);
 
-  ImguiInit(dpy, win, scancodes);
+  ImguiInit(dpy, win);
 
   struct ImGuiIO    * io    = igGetIO();
   struct ImGuiStyle * style = igGetStyle();
@@ -19,7 +18,7 @@ int main() {
 
   ImFontAtlas_AddFontFromFileTTF(io->Fonts, "NotoSans.ttf", 24, NULL, NULL);
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
       ImguiProcessEvent(&event);
@@ -6,31 +6,22 @@
 enum {MAX_STR = 10000};
 
 struct {
-  char mesh_ib [MAX_STR];
-  char mesh_vb [MAX_STR];
-  char mesh_uv [MAX_STR];
+  char mesh [MAX_STR];
 } g_resources = {
-  .mesh_ib = "meshes/MeshIB.binary",
-  .mesh_vb = "meshes/MeshVB.binary",
-  .mesh_uv = "meshes/MeshUV.binary",
+  .mesh = "meshes/Mesh.gpumesh",
 };
 
-#define GPUMESH_NO_HEADER_IMPORT
-#include "meshes/MeshIBVB.h"
-#include "meshes/MeshUV.h"
-
-struct gpu_cmd_t g_draw_commands[e_draw_count];
-
 int main() {
   Display * dpy = NULL;
   Window win = 0;
   GpuWindow("Drawing Text", sizeof("Drawing Text"), 1280, 720, 4, NULL, &dpy, &win);
   GpuSetDebugCallback(GpuDebugCallback);
 
-  unsigned di_buf = 0;
-  unsigned ib_buf = 0;
-  unsigned vb_tex = SimpleMeshUploadIBVB(g_resources.mesh_ib, g_resources.mesh_vb, 0, 0, 0, &di_buf, &ib_buf, NULL, &g_draw_commands[0].count);
-  unsigned uv_tex = SimpleMeshUploadUV(g_resources.mesh_uv, 0, NULL);
+  // One command per printable character from '!' to '~'
+  struct gpu_mesh_t mesh = {0};
+  GpuLoadMeshFile(g_resources.mesh, 0, 0, &mesh);
+  unsigned vb_tex = GpuMeshTex(&mesh, "position");
+  unsigned uv_tex = GpuMeshTex(&mesh, "uv");
 
   unsigned textures[16] = {
     vb_tex,
@@ -42,9 +33,12 @@ int main() {
   unsigned chars_id = 0;
   auto chars = GpuCallocCommands(countof(text), &chars_id);
   for (int i = 0; i < countof(text); i += 1) {
+    int cmd = text[i] - 33;
+    if (cmd < 0 || cmd >= mesh.cmd_count)
+      continue;
     chars[i].instance_count = 1;
-    chars[i].first = g_draw_commands[text[i] - 33].first;
-    chars[i].count = g_draw_commands[text[i] - 33].count;
+    chars[i].first = mesh.cmds[cmd].first;
+    chars[i].count = mesh.cmds[cmd].count;
   }
 
   unsigned vert = GpuVert(GPU_VERT_HEAD
@@ -80,7 +74,7 @@ int main() {
 
   unsigned ppo = GpuPpo(vert, frag);
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
       switch (event.type) {
@@ -93,7 +87,7 @@ int main() {
     GpuClear();
     GpuBindPpo(ppo);
     GpuBindTextures(0, 16, textures);
-    GpuBindIndices(ib_buf);
+    GpuBindIndices(mesh.idb, mesh.index_type);
     GpuBindCommands(chars_id);
     for (int i = 0; i < countof(text); i += 1) {
       float character_index = (float)i;
@@ -44,7 +44,7 @@ int main() {
   unsigned frag = GpuFrag(frag_string);
   unsigned ppo  = GpuPpo(vert, frag);
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     for (XEvent event = {0}; XPending(dpy);) {
       XNextEvent(dpy, &event);
       switch (event.type) {
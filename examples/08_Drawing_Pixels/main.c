@@ -54,7 +54,7 @@ int main() {
   unsigned long t_init = GetTimeMs();
   unsigned long t_prev = GetTimeMs();
 
-  for (Atom quit = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);;) {
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
     unsigned long t_curr = GetTimeMs();
     double dt = ((t_curr - t_prev) * 60.0) / 1000.0;
 
@@ -113,7 +113,7 @@ static int AppStep(void * state, Display * dpy, Window win, char * scancodes) {
   GpuClear();
   GpuBindPpo(s->ppo);
   GpuBindTextures(0, 16, s->textures);
-  GpuBindIndices(s->indices_id);
+  GpuBindIndices(s->indices_id, gpu_u32_e);
   GpuBindCommands(s->commands_id);
   GpuDraw(gpu_triangles_e, 0, 1);
 
@@ -60,7 +60,7 @@ int main() {
   GpuWindow("Hot Reload OpenGL", sizeof("Hot Reload OpenGL"), 1280, 720, 4, scancodes, &dpy, &win);
   GpuSetDebugCallback(GpuDebugCallback);
 
-  ImguiInit(dpy, win, scancodes);
+  ImguiInit(dpy, win);
 
   struct app_t app = {0};
   for (;;) {
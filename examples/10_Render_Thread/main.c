@@ -0,0 +1,98 @@
+#include "../../gpulib_thread.h"
+
+typedef struct { float x, y, z; } vec3;
+
+enum {INSTANCE_COUNT = 64 * 1024};
+
+static inline unsigned long GetTimeMs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000UL + tv.tv_usec / 1000UL;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Render Thread", sizeof("Render Thread"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  unsigned vertices_id = 0;
+  vec3 * vertices = GpuCalloc(3 * sizeof(vec3), &vertices_id);
+  vertices[0] = (vec3){ 0.0,    0.004, 0.0};
+  vertices[1] = (vec3){ 0.004, -0.004, 0.0};
+  vertices[2] = (vec3){-0.004, -0.004, 0.0};
+
+  unsigned instance_pos_id = 0;
+  vec3 * instance_pos = GpuCalloc(INSTANCE_COUNT * sizeof(vec3), &instance_pos_id);
+  vec3 * instance_pos_cpu = g_gpulib_libc.calloc(INSTANCE_COUNT, sizeof(vec3));
+
+  unsigned textures[16] = {0};
+  textures[0] = GpuCast(vertices_id, gpu_xyz_f32_e, 0, 3 * sizeof(vec3));
+  textures[1] = GpuCast(instance_pos_id, gpu_xyz_f32_e, 0, INSTANCE_COUNT * sizeof(vec3));
+
+  unsigned vert = GpuVert(GPU_VERT_HEAD
+      "layout(binding = 0) uniform samplerBuffer s_pos;"                "\n"
+      "layout(binding = 1) uniform samplerBuffer s_ipos;"               "\n"
+      ""                                                                "\n"
+      "void main() {"                                                   "\n"
+      "  vec3 pos = texelFetch(s_pos, gl_VertexID).xyz;"                "\n"
+      "  vec3 ipos = texelFetch(s_ipos, gl_InstanceID).xyz;"            "\n"
+      "  gl_Position = vec4(pos + ipos, 1);"                            "\n"
+      "}"                                                               "\n");
+
+  unsigned frag = GpuFrag(GPU_FRAG_HEAD
+      "layout(location = 0) uniform vec3 u_color;" "\n"
+      ""                                           "\n"
+      "layout(location = 0) out vec4 g_color;"     "\n"
+      ""                                           "\n"
+      "void main() {"                              "\n"
+      "  g_color = vec4(u_color, 1);"              "\n"
+      "}"                                          "\n");
+
+  unsigned ppo = GpuPpo(vert, frag);
+
+  // From here on the GL context belongs to the render thread, this thread only records frames
+  GpuThreadStart(dpy, win, 3, 4 * 1024 * 1024);
+
+  unsigned long t_init = GetTimeMs();
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      GpuEvent(&event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    float t = (GetTimeMs() - t_init) * 0.001f;
+
+    for (int i = 0; i < INSTANCE_COUNT; i += 1) {
+      float a = i * 0.0031f + t * 0.2f;
+      float r = 0.1f + 0.8f * ((i & 1023) / 1024.f);
+      for (int j = 0; j < 4; j += 1)
+        r += 0.01f * fsin(t * (j + 1) + i * 0.013f * (j + 1));
+      instance_pos_cpu[i] = (vec3){fcos(a) * r * (720 / 1280.f), fsin(a) * r, 0};
+    }
+
+    float color[3] = {0.5f + 0.5f * fsin(t), 0.5f, 1};
+
+    struct gpu_frame_t * frame = GpuFrameBegin();
+    GpuFrameCopy(frame, instance_pos, instance_pos_cpu, INSTANCE_COUNT * sizeof(vec3));
+    GpuFrameV3F(frame, frag, 0, 1, color);
+    GpuFrameClear(frame);
+    GpuFrameBindPpo(frame, ppo);
+    GpuFrameBindTextures(frame, 0, 16, textures);
+    GpuFrameDrawOnce(frame, gpu_triangles_e, 0, 3, INSTANCE_COUNT);
+    GpuFrameSubmit(frame);
+  }
+
+exit:;
+  GpuThreadStop();
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
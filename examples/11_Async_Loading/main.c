@@ -0,0 +1,143 @@
+#include "../../gpulib_thread.h"
+
+enum {MAX_STR = 10000};
+
+struct {
+  char mesh        [MAX_STR];
+  char xform_r     [MAX_STR];
+  char xform_s     [MAX_STR];
+  char xform_t     [MAX_STR];
+} g_resources = {
+  .mesh         = "../01_Mesh_Loading/meshes/Mesh.gpumesh",
+  .xform_r      = "../01_Mesh_Loading/meshes/XformsRotationQuaternion.binary",
+  .xform_s      = "../01_Mesh_Loading/meshes/XformsScale.binary",
+  .xform_t      = "../01_Mesh_Loading/meshes/XformsTranslation.binary",
+};
+
+#include "../01_Mesh_Loading/meshes/Xforms.h"
+
+struct {
+  struct gpu_mesh_t mesh;
+  unsigned textures[16];
+} g_mesh = {0};
+
+char g_vert[] = GPU_VERT_HEAD
+    "layout(binding = 0) uniform samplerBuffer  s_vb;"            "\n"
+    "layout(binding = 1) uniform isamplerBuffer s_id;"            "\n"
+    "layout(binding = 2) uniform samplerBuffer  s_uv;"            "\n"
+    "layout(binding = 3) uniform samplerBuffer  s_normals;"       "\n"
+    "layout(binding = 4) uniform samplerBuffer  s_xfs;"           "\n"
+    "layout(binding = 5) uniform samplerBuffer  s_xfr;"           "\n"
+    "layout(binding = 6) uniform samplerBuffer  s_xft;"           "\n"
+    ""                                                            "\n"
+    "layout(location = 0) uniform vec3 u_aabb_min;"               "\n"
+    "layout(location = 1) uniform vec3 u_aabb_max;"               "\n"
+    ""                                                            "\n"
+    "layout(location = 0) out vec2 g_uv;"                         "\n"
+    ""                                                            "\n"
+    "vec4 qinv(vec4 v) {"                                         "\n"
+    "  return vec4(-v.xyz, v.w);"                                 "\n"
+    "}"                                                           "\n"
+    ""                                                            "\n"
+    "vec4 qmul(vec4 a, vec4 b) {"                                 "\n"
+    "  vec3 c = a.xyz * b.w + b.xyz * a.w + cross(a.xyz, b.xyz);" "\n"
+    "  float d = a.w * b.w - dot(a.xyz, b.xyz);"                  "\n"
+    "  return vec4(c, d);"                                        "\n"
+    "}"                                                           "\n"
+    ""                                                            "\n"
+    "vec3 qrot(vec3 p, vec4 q) {"                                 "\n"
+    "  return qmul(qmul(q, vec4(p, 0)), qinv(q)).xyz;"            "\n"
+    "}"                                                           "\n"
+    ""                                                            "\n"
+    "void main() {"                                               "\n"
+    "  vec3 pos = GpuDecodePosition(texelFetch(s_vb, gl_VertexID), u_aabb_min, u_aabb_max);" "\n"
+    "  int  id  = texelFetch(s_id,  gl_VertexID).x;"              "\n"
+    "  g_uv     = texelFetch(s_uv,  gl_VertexID).xy;"             "\n"
+    "  vec3 xfs = texelFetch(s_xfs, id).xyz;"                     "\n"
+    "  vec4 xfr = texelFetch(s_xfr, id).xyzw;"                    "\n"
+    "  vec3 xft = texelFetch(s_xft, id).xyz;"                     "\n"
+    ""                                                            "\n"
+    "  pos *= xfs;"                                               "\n"
+    "  pos  = qrot(pos, xfr);"                                    "\n"
+    "  pos += xft;"                                               "\n"
+    ""                                                            "\n"
+    "  pos -= vec3(0, 2.5, 0);"                                   "\n"
+    ""                                                            "\n"
+    "  pos.x *= 0.613861;"                                        "\n"
+    "  pos.y *= 1.091309;"                                        "\n"
+    ""                                                            "\n"
+    "  gl_Position = vec4(pos, pos.z + 0.1);"                     "\n"
+    "}"                                                           "\n";
+
+char g_frag[] = GPU_FRAG_HEAD
+    "layout(location = 0) in vec2 g_uv;"                          "\n"
+    ""                                                            "\n"
+    "layout(location = 0) out vec4 g_color;"                      "\n"
+    ""                                                            "\n"
+    "void main() {"                                               "\n"
+    "  g_color = vec4(g_uv.x, g_uv.y, 1, 1);"                     "\n"
+    "}"                                                           "\n";
+
+// Runs on the loader thread
+static void UploadMesh(void * userdata) {
+  GpuLoadMeshFile(g_resources.mesh, 0, 0, &g_mesh.mesh);
+  g_mesh.textures[0] = GpuMeshTex(&g_mesh.mesh, "position");
+  g_mesh.textures[1] = GpuMeshTex(&g_mesh.mesh, "id");
+  g_mesh.textures[2] = GpuMeshTex(&g_mesh.mesh, "uv");
+  g_mesh.textures[3] = GpuMeshTex(&g_mesh.mesh, "normal");
+  g_mesh.textures[4] = SimpleMeshUploadXformsScale(g_resources.xform_s, 0, NULL);
+  g_mesh.textures[5] = SimpleMeshUploadXformsRotationQuaternion(g_resources.xform_r, 0, NULL);
+  g_mesh.textures[6] = SimpleMeshUploadXformsTranslation(g_resources.xform_t, 0, NULL);
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Async Loading", sizeof("Async Loading"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  GpuLoaderStart(dpy);
+
+  unsigned vert = 0;
+  unsigned frag = 0;
+  struct gpu_load_t mesh_load = {0};
+  struct gpu_load_t vert_load = {0};
+  struct gpu_load_t frag_load = {0};
+  GpuLoaderCall(&mesh_load, UploadMesh, NULL);
+  GpuLoaderVert(&vert_load, g_vert, &vert);
+  GpuLoaderFrag(&frag_load, g_frag, &frag);
+
+  unsigned ppo = 0;
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+    // Pipeline objects are not shared between contexts, so the ppo is made here once both programs are ready
+    if (ppo == 0 && GpuLoaderReady(&vert_load) && GpuLoaderReady(&frag_load))
+      ppo = GpuPpo(vert, frag);
+    GpuClear();
+    if (ppo != 0 && GpuLoaderReady(&mesh_load)) {
+      GpuV3F(vert, 0, 1, g_mesh.mesh.aabb_min);
+      GpuV3F(vert, 1, 1, g_mesh.mesh.aabb_max);
+      GpuBindPpo(ppo);
+      GpuBindTextures(0, 16, g_mesh.textures);
+      GpuBindIndices(g_mesh.mesh.idb, g_mesh.mesh.index_type);
+      GpuBindCommands(g_mesh.mesh.dib);
+      GpuDraw(gpu_triangles_e, 0, g_mesh.mesh.cmd_count);
+    }
+    GpuSwap(dpy, win);
+  }
+
+exit:;
+  GpuLoaderStop();
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
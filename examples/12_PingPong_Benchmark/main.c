@@ -0,0 +1,80 @@
+#include "../../gpulib.h"
+
+enum {DIM = 512, ITERATIONS_PER_FRAME = 64};
+
+static inline unsigned long GetTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("PingPong Benchmark", sizeof("PingPong Benchmark"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+  GpuDisable(0x0BE2); // GL_BLEND
+
+  // Jacobi iteration of the heat equation with a hot square in the middle, alpha holds the per-texel change
+  unsigned ppo = GpuKernel(GPU_KERNEL_HEAD
+      "layout(binding = 0) uniform sampler2DArray s_prev;"                        "\n"
+      ""                                                                          "\n"
+      "layout(location = 0) out vec4 g_next;"                                     "\n"
+      ""                                                                          "\n"
+      "void main() {"                                                             "\n"
+      "  ivec2 size = textureSize(s_prev, 0).xy;"                                 "\n"
+      "  ivec2 p = ivec2(gl_FragCoord.xy);"                                       "\n"
+      "  float c = texelFetch(s_prev, ivec3(p, 0), 0).r;"                         "\n"
+      "  float l = texelFetch(s_prev, ivec3(max(p - ivec2(1, 0), 0), 0), 0).r;"   "\n"
+      "  float r = texelFetch(s_prev, ivec3(min(p + ivec2(1, 0), size - 1), 0), 0).r;" "\n"
+      "  float d = texelFetch(s_prev, ivec3(max(p - ivec2(0, 1), 0), 0), 0).r;"   "\n"
+      "  float u = texelFetch(s_prev, ivec3(min(p + ivec2(0, 1), size - 1), 0), 0).r;" "\n"
+      "  float n = (l + r + d + u) * 0.25;"                                       "\n"
+      "  if (all(greaterThan(p, size * 7 / 16)) && all(lessThan(p, size * 9 / 16)))" "\n"
+      "    n = 1;"                                                                "\n"
+      "  g_next = vec4(n, n, n, abs(n - c));"                                     "\n"
+      "}"                                                                         "\n", NULL);
+
+  struct gpu_pingpong_t pingpong = {0};
+  GpuPingPong(&pingpong, gpu_rgba_f32_e, DIM, DIM, 1);
+
+  unsigned long iterations = 0;
+  unsigned long t_prev = GetTimeUs();
+  float metric[4] = {0};
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    GpuPingPongRun(&pingpong, ppo, ITERATIONS_PER_FRAME, 0, NULL, NULL);
+    iterations += ITERATIONS_PER_FRAME;
+
+    if (GpuPingPongMetricReady(&pingpong, metric) || pingpong.read_fence == NULL)
+      GpuPingPongMetric(&pingpong);
+
+    GpuBindFbo(0);
+    GpuViewport(0, 0, 1280, 720);
+    GpuClear();
+    GpuBlitToScreen(GpuKernelFbo(GpuPingPongImg(&pingpong), 0, 0, 0, 0, 0, 0, 0), 0, 0, 0, DIM, DIM, 0, 0, DIM, DIM);
+    GpuSwap(dpy, win);
+
+    unsigned long t_curr = GetTimeUs();
+    if (t_curr - t_prev >= 1000000UL) {
+      print(GPULIB_MAX_PRINT_BYTES, "%dx%d: %.1f iterations/s, mean change %g\n", DIM, DIM, iterations * 1000000.0 / (t_curr - t_prev), metric[3]);
+      iterations = 0;
+      t_prev = t_curr;
+    }
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
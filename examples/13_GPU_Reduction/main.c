@@ -0,0 +1,95 @@
+#include "../../gpulib_compute.h"
+
+enum {COUNT = 1024 * 1024, DIM = 1024};
+
+static inline unsigned long GetTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("GPU Reduction", sizeof("GPU Reduction"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  unsigned values_id = 0;
+  float * values = GpuMalloc(COUNT * sizeof(float), &values_id);
+  float * values_cpu = g_gpulib_libc.calloc(COUNT, sizeof(float));
+  for (unsigned i = 0, seed = 1; i < COUNT; i += 1) {
+    seed = seed * 1664525u + 1013904223u;
+    values_cpu[i] = (seed >> 8) / (float)(1 << 24) - 0.5f;
+  }
+  memcpy(values, values_cpu, COUNT * sizeof(float));
+  unsigned values_tex = GpuCast(values_id, gpu_x_f32_e, 0, COUNT * sizeof(float));
+
+  unsigned img = GpuMallocImg(gpu_r_f32_e, DIM, DIM, 1, 1);
+  GpuSet(img, 0, 0, 0, DIM, DIM, 1, 0, gpu_r_e, gpu_f32_e, values_cpu);
+
+  struct gpu_reduce_t reduce_buf = {0};
+  struct gpu_reduce_t reduce_img = {0};
+
+  unsigned long t_prev = GetTimeUs();
+  unsigned long t_buf = 0;
+  unsigned long t_img = 0;
+  unsigned long reductions = 0;
+  float buf_max = 0;
+  float img_max = 0;
+  unsigned buf_max_index = 0;
+  unsigned img_max_index = 0;
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    // Both reductions are in flight at once, their results are picked up on a later frame
+    if (reduce_buf.fence == NULL || GpuReduceReady(&reduce_buf, &buf_max, &buf_max_index)) {
+      unsigned long t = GetTimeUs();
+      GpuReduceBuf(&reduce_buf, gpu_reduce_argmax_e, gpu_f32_e, values_tex, COUNT);
+      t_buf += GetTimeUs() - t;
+      reductions += 1;
+    }
+    if (reduce_img.fence == NULL || GpuReduceReady(&reduce_img, &img_max, &img_max_index)) {
+      unsigned long t = GetTimeUs();
+      GpuReduceImg(&reduce_img, gpu_reduce_argmax_e, gpu_f32_e, img, DIM, DIM);
+      t_img += GetTimeUs() - t;
+    }
+
+    GpuClear();
+    GpuSwap(dpy, win);
+
+    unsigned long t_curr = GetTimeUs();
+    if (t_curr - t_prev >= 1000000UL) {
+      unsigned long t = GetTimeUs();
+      float cpu_max = values_cpu[0];
+      unsigned cpu_max_index = 0;
+      for (unsigned i = 1; i < COUNT; i += 1) {
+        if (values_cpu[i] > cpu_max) {
+          cpu_max = values_cpu[i];
+          cpu_max_index = i;
+        }
+      }
+      unsigned long t_cpu = GetTimeUs() - t;
+      print(GPULIB_MAX_PRINT_BYTES, "argmax of %d floats: buf %g at %u, img %g at %u, cpu %g at %u\n", COUNT, buf_max, buf_max_index, img_max, img_max_index, cpu_max, cpu_max_index);
+      print(GPULIB_MAX_PRINT_BYTES, "%.1f reductions/s, submit us: buf %.1f, img %.1f, cpu loop us: %lu\n",
+          reductions * 1000000.0 / (t_curr - t_prev), t_buf / (double)(reductions + !reductions), t_img / (double)(reductions + !reductions), t_cpu);
+      t_buf = 0;
+      t_img = 0;
+      reductions = 0;
+      t_prev = GetTimeUs();
+    }
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "../../gpulib_compute.h"
+
+enum {COUNT = 1024 * 1024};
+
+static inline unsigned long GetTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Scan Benchmark", sizeof("Scan Benchmark"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  unsigned values_id = 0;
+  unsigned flags_id = 0;
+  unsigned * values = GpuMalloc(COUNT * sizeof(unsigned), &values_id);
+  unsigned * flags  = GpuMalloc(COUNT * sizeof(unsigned), &flags_id);
+  unsigned * values_cpu = g_gpulib_libc.calloc(COUNT, sizeof(unsigned));
+  unsigned * flags_cpu  = g_gpulib_libc.calloc(COUNT, sizeof(unsigned));
+  unsigned * output_cpu = g_gpulib_libc.calloc(COUNT, sizeof(unsigned));
+  for (unsigned i = 0, seed = 1; i < COUNT; i += 1) {
+    seed = seed * 1664525u + 1013904223u;
+    values_cpu[i] = (seed >> 16) & 1023;
+    flags_cpu[i] = (seed >> 28) < 4;
+  }
+  memcpy(values, values_cpu, COUNT * sizeof(unsigned));
+  memcpy(flags, flags_cpu, COUNT * sizeof(unsigned));
+  unsigned values_tex = GpuCast(values_id, gpu_x_u32_e, 0, COUNT * sizeof(unsigned));
+  unsigned flags_tex  = GpuCast(flags_id,  gpu_x_u32_e, 0, COUNT * sizeof(unsigned));
+
+  unsigned output_id = 0;
+  unsigned * output = GpuMallocRead(COUNT * sizeof(unsigned), &output_id);
+  unsigned output_xfb = GpuXfb(output_id, 0, COUNT * sizeof(unsigned), 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+  struct gpu_scan_t scan = {0};
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    unsigned long t_0 = GetTimeUs();
+    GpuScan(&scan, gpu_u32_e, 0, values_tex, COUNT, output_xfb);
+    GpuFinish();
+    unsigned long t_1 = GetTimeUs();
+    unsigned kept = 0;
+    GpuCompact(&scan, gpu_u32_e, values_tex, flags_tex, COUNT, output_xfb);
+    while (!GpuCompactReady(&scan, &kept)) {}
+    unsigned long t_2 = GetTimeUs();
+    for (unsigned i = 0, sum = 0; i < COUNT; i += 1) {
+      output_cpu[i] = sum;
+      sum += values_cpu[i];
+    }
+    unsigned long t_3 = GetTimeUs();
+    unsigned kept_cpu = 0;
+    for (unsigned i = 0; i < COUNT; i += 1) {
+      output_cpu[kept_cpu] = values_cpu[i];
+      kept_cpu += flags_cpu[i];
+    }
+    unsigned long t_4 = GetTimeUs();
+
+    print(GPULIB_MAX_PRINT_BYTES, "%d elements, Melements/s: GPU scan %.1f, CPU scan %.1f, GPU compact %.1f (kept %u), CPU compact %.1f (kept %u), last %u\n", COUNT,
+        COUNT / (double)(t_1 - t_0), COUNT / (double)(t_3 - t_2), COUNT / (double)(t_2 - t_1), kept, COUNT / (double)(t_4 - t_3), kept_cpu, kept > 0 ? output[kept - 1] : 0);
+
+    GpuClear();
+    GpuSwap(dpy, win);
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
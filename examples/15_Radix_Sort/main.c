@@ -0,0 +1,96 @@
+#include "../../gpulib_compute.h"
+
+enum {COUNT = 1024 * 1024};
+
+static inline unsigned long GetTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Radix Sort", sizeof("Radix Sort"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  unsigned keys_id = 0;
+  unsigned values_id = 0;
+  unsigned * keys   = GpuMalloc(COUNT * sizeof(unsigned), &keys_id);
+  unsigned * values = GpuMalloc(COUNT * sizeof(unsigned), &values_id);
+  unsigned * keys_cpu = g_gpulib_libc.calloc(COUNT, sizeof(unsigned));
+
+  // The sorted keys and values are copied into a readable buffer with a pass-through transform feedback draw
+  unsigned sorted_id = 0;
+  unsigned * sorted = GpuMallocRead(2 * COUNT * sizeof(unsigned), &sorted_id);
+  unsigned sorted_xfb = GpuXfb(sorted_id, 0, COUNT * sizeof(unsigned), sorted_id, COUNT * sizeof(unsigned), COUNT * sizeof(unsigned), 0, 0, 0, 0, 0, 0);
+  unsigned copy_textures[2] = {
+    GpuCast(keys_id,   gpu_x_u32_e, 0, COUNT * sizeof(unsigned)),
+    GpuCast(values_id, gpu_x_u32_e, 0, COUNT * sizeof(unsigned)),
+  };
+  unsigned copy_ppo = GpuPpo(GpuVertXfb(GPU_VERT_HEAD
+      "layout(binding = 0) uniform usamplerBuffer s_keys;"   "\n"
+      "layout(binding = 1) uniform usamplerBuffer s_values;" "\n"
+      ""                                                     "\n"
+      "flat out uint g_key;"                                 "\n"
+      "flat out uint g_value;"                               "\n"
+      ""                                                     "\n"
+      "void main() {"                                        "\n"
+      "  g_key = texelFetch(s_keys, gl_VertexID).x;"         "\n"
+      "  g_value = texelFetch(s_values, gl_VertexID).x;"     "\n"
+      "}"                                                    "\n", "g_key", "g_value", NULL, NULL), 0);
+
+  struct gpu_sort_t sort = {0};
+
+  for (unsigned frame = 0, seed = 1;; frame += 1) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == g_gpulib_x11.wm_delete_window)
+            goto exit;
+        }
+      }
+    }
+
+    for (unsigned i = 0; i < COUNT; i += 1) {
+      seed = seed * 1664525u + 1013904223u;
+      keys_cpu[i] = seed ^ (seed >> 15);
+      keys[i] = keys_cpu[i];
+      values[i] = i;
+    }
+
+    unsigned long t_0 = GetTimeUs();
+    GpuSort(&sort, keys_id, values_id, COUNT, 32);
+    GpuFinish();
+    unsigned long t_1 = GetTimeUs();
+
+    GpuBindPpo(copy_ppo);
+    GpuBindTextures(0, 2, copy_textures);
+    GpuBindXfb(sorted_xfb);
+    GpuDrawOnceXfb(gpu_points_e, 0, COUNT, 1);
+    GpuBindXfb(0);
+    GpuFinish();
+
+    // Keys must be ascending, equal keys must keep their original order and every value must point at its key
+    unsigned errors = 0;
+    for (unsigned i = 0; i < COUNT; i += 1) {
+      unsigned key = sorted[i];
+      unsigned value = sorted[COUNT + i];
+      if (value >= COUNT || keys_cpu[value] != key)
+        errors += 1;
+      else if (i > 0 && (sorted[i - 1] > key || (sorted[i - 1] == key && sorted[COUNT + i - 1] > value)))
+        errors += 1;
+    }
+
+    print(GPULIB_MAX_PRINT_BYTES, "Frame %u: sorted %d keys with values, %.2f Mkeys/s, %u errors\n", frame, COUNT, COUNT / (double)(t_1 - t_0), errors);
+
+    GpuClear();
+    GpuSwap(dpy, win);
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include "../../gpulib_compute.h"
+
+enum {DIM_X = 1280, DIM_Y = 720, BINS = 64};
+
+static inline unsigned long GetTimeMs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000UL + tv.tv_usec / 1000UL;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Luminance Histogram", sizeof("Luminance Histogram"), DIM_X, DIM_Y, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+  GpuDisable(0x0BE2); // GL_BLEND
+
+  // HDR scene whose brightness drifts over time, luminance goes to the second attachment
+  unsigned scene_frag = 0;
+  unsigned scene_ppo = GpuKernel(GPU_KERNEL_HEAD
+      "layout(location = 0) uniform float u_time;"                                 "\n"
+      ""                                                                           "\n"
+      "layout(location = 0) out vec4 g_color;"                                     "\n"
+      "layout(location = 1) out vec4 g_luminance;"                                 "\n"
+      ""                                                                           "\n"
+      "void main() {"                                                              "\n"
+      "  vec2 uv = gl_FragCoord.xy / vec2(1280, 720);"                             "\n"
+      "  float light = exp2(3 * sin(u_time * 0.3));"                               "\n"
+      "  vec3 c = vec3(uv, 0.5 + 0.5 * sin(u_time + uv.x * 10)) * light;"          "\n"
+      "  c += 8 * light * smoothstep(0.1, 0.0, length(uv - vec2(0.5 + 0.3 * sin(u_time), 0.5)));" "\n"
+      "  g_color = vec4(c, 1);"                                                    "\n"
+      "  g_luminance = vec4(dot(c, vec3(0.2126, 0.7152, 0.0722)));"                "\n"
+      "}"                                                                          "\n", &scene_frag);
+
+  // Tonemaps with the CPU-side exposure and draws the histogram bars straight from the bins image
+  unsigned display_frag = 0;
+  unsigned display_ppo = GpuKernel(GPU_KERNEL_HEAD
+      "layout(binding = 0) uniform sampler2DArray s_color;"                        "\n"
+      "layout(binding = 1) uniform sampler2DArray s_bins;"                         "\n"
+      ""                                                                           "\n"
+      "layout(location = 0) uniform float u_exposure;"                             "\n"
+      "layout(location = 1) uniform float u_max_count;"                            "\n"
+      ""                                                                           "\n"
+      "layout(location = 0) out vec4 g_color;"                                     "\n"
+      ""                                                                           "\n"
+      "void main() {"                                                              "\n"
+      "  ivec2 p = ivec2(gl_FragCoord.xy);"                                        "\n"
+      "  vec3 c = texelFetch(s_color, ivec3(p, 0), 0).rgb * u_exposure;"           "\n"
+      "  c = c / (1 + c);"                                                         "\n"
+      "  if (p.x < 64 * 4 && p.y < 128) {"                                         "\n"
+      "    float count = texelFetch(s_bins, ivec3(p.x / 4, 0, 0), 0).r;"           "\n"
+      "    c = mix(c * 0.25, vec3(1, 0.8, 0.2), float(p.y < 128 * count / u_max_count));" "\n"
+      "  }"                                                                        "\n"
+      "  g_color = vec4(c, 1);"                                                    "\n"
+      "}"                                                                          "\n", &display_frag);
+
+  unsigned color = GpuCallocImg(gpu_rgba_f32_e, DIM_X, DIM_Y, 1, 1);
+  unsigned luminance = GpuCallocImg(gpu_r_f32_e, DIM_X, DIM_Y, 1, 1);
+  unsigned display = GpuCallocImg(gpu_rgba_b8_e, DIM_X, DIM_Y, 1, 1);
+
+  // Luminance in log2 space would be typical, a linear range keeps the example short
+  float range[4] = {0, 16, 0, 1};
+  float bins[BINS] = {0};
+  float exposure = 1;
+  float max_count = 1;
+  struct gpu_histogram_t histogram = {0};
+
+  unsigned long t_init = GetTimeMs();
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    float t = (GetTimeMs() - t_init) * 0.001f;
+    GpuF32(scene_frag, 0, 1, &t);
+    GpuKernelRun(scene_ppo, color, 0, luminance, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, 0, DIM_X, DIM_Y);
+
+    // The previous histogram drives the exposure, the next one is issued without waiting for it
+    if (histogram.fence == NULL || GpuHistogramReady(&histogram, bins)) {
+      float total = 0;
+      max_count = 1;
+      for (int i = 0; i < BINS; i += 1) {
+        total += bins[i];
+        max_count = bins[i] > max_count ? bins[i] : max_count;
+      }
+      int median = 0;
+      for (float sum = bins[0]; median < BINS - 1 && sum < total * 0.5f;)
+        sum += bins[++median];
+      float target = 0.25f / ((median + 0.5f) * (range[1] / BINS));
+      exposure += (target - exposure) * 0.1f;
+      GpuHistogramImg(&histogram, gpu_f32_e, luminance, DIM_X, DIM_Y, BINS, 1, range);
+    }
+
+    unsigned textures[2] = {color, histogram.img};
+    GpuF32(display_frag, 0, 1, &exposure);
+    GpuF32(display_frag, 1, 1, &max_count);
+    GpuKernelRun(display_ppo, display, 0, 0, 0, 0, 0, 0, 0, 2, textures, NULL, 0, 0, DIM_X, DIM_Y);
+
+    GpuBindFbo(0);
+    GpuViewport(0, 0, DIM_X, DIM_Y);
+    GpuClear();
+    GpuBlitToScreen(GpuKernelFbo(display, 0, 0, 0, 0, 0, 0, 0), 0, 0, 0, DIM_X, DIM_Y, 0, 0, DIM_X, DIM_Y);
+    GpuSwap(dpy, win);
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include "../../gpulib.h"
+
+enum {MAX_PARTICLES = 256 * 1024, SPAWN_PER_FRAME = 1024};
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Transform Feedback Particles", sizeof("Transform Feedback Particles"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  // Two particle buffers of xy position and xy velocity, each frame reads one and appends to the other
+  unsigned particles_id[2] = {0};
+  unsigned particles_tex[2] = {0};
+  unsigned particles_xfb[2] = {0};
+  for (int i = 0; i < 2; i += 1) {
+    GpuMalloc(MAX_PARTICLES * 4 * sizeof(float), &particles_id[i]);
+    particles_tex[i] = GpuCast(particles_id[i], gpu_xyzw_f32_e, 0, MAX_PARTICLES * 4 * sizeof(float));
+    particles_xfb[i] = GpuXfb(particles_id[i], 0, MAX_PARTICLES * 4 * sizeof(float), 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  }
+
+  unsigned sim = GpuVertXfb(GPU_VERT_HEAD
+      "layout(binding = 0) uniform samplerBuffer s_particles;"                    "\n"
+      ""                                                                          "\n"
+      "layout(location = 0) uniform float u_dt;"                                  "\n"
+      "layout(location = 1) uniform int u_spawn;"                                 "\n"
+      "layout(location = 2) uniform int u_seed;"                                  "\n"
+      ""                                                                          "\n"
+      "flat out vec4 g_particle;"                                                 "\n"
+      ""                                                                          "\n"
+      "float Hash(uint x) {"                                                      "\n"
+      "  x ^= x >> 16; x *= 0x7feb352du;"                                         "\n"
+      "  x ^= x >> 15; x *= 0x846ca68bu;"                                         "\n"
+      "  x ^= x >> 16;"                                                           "\n"
+      "  return float(x) / 4294967295.0;"                                         "\n"
+      "}"                                                                         "\n"
+      ""                                                                          "\n"
+      "vec4 Spawn(uint seed) {"                                                   "\n"
+      "  return vec4(0, -1, (Hash(seed) - 0.5) * 0.8, 1.4 + 0.6 * Hash(seed ^ 0x9e3779b9u));" "\n"
+      "}"                                                                         "\n"
+      ""                                                                          "\n"
+      "void main() {"                                                             "\n"
+      "  uint seed = uint(u_seed) * 0x10000u + uint(gl_VertexID);"                "\n"
+      "  if (u_spawn != 0) {"                                                     "\n"
+      "    g_particle = Spawn(seed);"                                             "\n"
+      "    return;"                                                               "\n"
+      "  }"                                                                       "\n"
+      "  vec4 p = texelFetch(s_particles, gl_VertexID);"                          "\n"
+      "  p.zw += vec2(0, -1) * u_dt;"                                             "\n"
+      "  p.xy += p.zw * u_dt;"                                                    "\n"
+      "  g_particle = p.y < -1 ? Spawn(seed) : p;"                                "\n"
+      "}"                                                                         "\n",
+      "g_particle", NULL, NULL, NULL);
+
+  unsigned vert = GpuVert(GPU_VERT_HEAD
+      "layout(binding = 0) uniform samplerBuffer s_particles;"                    "\n"
+      ""                                                                          "\n"
+      "void main() {"                                                             "\n"
+      "  gl_Position = vec4(texelFetch(s_particles, gl_VertexID).xy * vec2(720.0 / 1280.0, 1), 0, 1);" "\n"
+      "}"                                                                         "\n");
+
+  unsigned frag = GpuFrag(GPU_FRAG_HEAD
+      "layout(location = 0) out vec4 g_color;"                                    "\n"
+      ""                                                                          "\n"
+      "void main() {"                                                             "\n"
+      "  g_color = vec4(1, 0.6, 0.2, 0.5);"                                       "\n"
+      "}"                                                                         "\n");
+
+  unsigned sim_ppo = GpuPpo(sim, 0);
+  unsigned draw_ppo = GpuPpo(vert, frag);
+
+  float dt = 1 / 60.f;
+  GpuF32(sim, 0, 1, &dt);
+
+  // GpuDrawXfbResult needs a finished capture, start both buffers out empty
+  GpuBindPpo(sim_ppo);
+  for (int i = 0; i < 2; i += 1) {
+    GpuBindXfb(particles_xfb[i]);
+    GpuXfbBegin(gpu_points_e);
+    GpuXfbEnd();
+  }
+
+  for (int frame = 0, curr = 0;; frame += 1, curr ^= 1) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == g_gpulib_x11.wm_delete_window)
+            goto exit;
+        }
+      }
+    }
+
+    GpuClear();
+
+    int spawn = 0;
+    GpuI32(sim, 1, 1, &spawn);
+    GpuI32(sim, 2, 1, &frame);
+    GpuBindPpo(sim_ppo);
+    GpuBindTextures(0, 1, &particles_tex[curr]);
+    GpuBindXfb(particles_xfb[curr ^ 1]);
+    GpuXfbBegin(gpu_points_e);
+
+    // Advance however many particles the last frame captured, the CPU never learns the count
+    GpuDrawXfbResult(gpu_points_e, particles_xfb[curr]);
+
+    // Draw the last frame's particles while the capture is paused, the sim program has to be current again to resume
+    GpuXfbPause();
+    GpuBindPpo(draw_ppo);
+    GpuDrawXfbResult(gpu_points_e, particles_xfb[curr]);
+    GpuBindPpo(sim_ppo);
+    GpuXfbResume();
+
+    // New particles append after the advanced ones, once the buffer is full the overflow isn't captured
+    spawn = 1;
+    GpuI32(sim, 1, 1, &spawn);
+    GpuDrawOnce(gpu_points_e, 0, SPAWN_PER_FRAME, 1);
+    GpuXfbEnd();
+    GpuBindXfb(0);
+
+    GpuSwap(dpy, win);
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include "../../gpulib_graph.h"
+
+enum {DIM = 512, SMALL = 8};
+
+static inline unsigned long GetTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+struct blur_t {
+  unsigned frag;
+  float direction[2];
+};
+
+static void SetTime(void * userdata) {
+  float t = GetTimeUs() % 100000000UL * 0.000001f;
+  GpuF32(((unsigned *)userdata)[0], 0, 1, &t);
+}
+
+static void SetBlur(void * userdata) {
+  struct blur_t * blur = userdata;
+  GpuV2F(blur->frag, 0, 1, blur->direction);
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Job Graph", sizeof("Job Graph"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  unsigned noise_frag = 0;
+  unsigned noise = GpuKernel(GPU_KERNEL_HEAD
+      "layout(location = 0) uniform float u_time;"                                    "\n"
+      ""                                                                              "\n"
+      "layout(location = 0) out vec4 g_color;"                                        "\n"
+      ""                                                                              "\n"
+      "void main() {"                                                                 "\n"
+      "  vec2 p = gl_FragCoord.xy / 32.0;"                                            "\n"
+      "  float v = sin(p.x + u_time) * cos(p.y - u_time * 0.7) * 0.5 + 0.5;"          "\n"
+      "  float n = fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5);" "\n"
+      "  g_color = vec4(v, n, 1.0 - v, 1);"                                           "\n"
+      "}"                                                                             "\n", &noise_frag);
+
+  struct blur_t blur[2] = {{.direction = {1, 0}}, {.direction = {0, 1}}};
+  char * blur_string = GPU_KERNEL_HEAD
+      "layout(binding = 0) uniform sampler2DArray s_img;"                                        "\n"
+      "layout(location = 0) uniform vec2 u_direction;"                                           "\n"
+      ""                                                                                         "\n"
+      "layout(location = 0) out vec4 g_color;"                                                   "\n"
+      ""                                                                                         "\n"
+      "void main() {"                                                                            "\n"
+      "  vec4 sum = vec4(0);"                                                                    "\n"
+      "  for (int i = -4; i <= 4; i += 1)"                                                       "\n"
+      "    sum += texelFetch(s_img, ivec3(gl_FragCoord.xy + u_direction * float(i), 0), 0);"     "\n"
+      "  g_color = sum / 9.0;"                                                                   "\n"
+      "}"                                                                                        "\n";
+  unsigned blur_h = GpuKernel(blur_string, &blur[0].frag);
+  unsigned blur_v = GpuKernel(blur_string, &blur[1].frag);
+
+  unsigned tonemap_frag = 0;
+  unsigned tonemap = GpuKernel(GPU_KERNEL_HEAD
+      "layout(binding = 0) uniform sampler2DArray s_img;"                      "\n"
+      ""                                                                       "\n"
+      "layout(location = 0) out vec4 g_color;"                                 "\n"
+      ""                                                                       "\n"
+      "void main() {"                                                          "\n"
+      "  vec4 c = texelFetch(s_img, ivec3(gl_FragCoord.xy, 0), 0);"            "\n"
+      "  g_color = vec4(c.rgb / (c.rgb + 0.25) * 1.25, 1);"                    "\n"
+      "}"                                                                      "\n", &tonemap_frag);
+
+  unsigned small_frag = 0;
+  unsigned small = GpuKernel(GPU_KERNEL_HEAD
+      "layout(binding = 0) uniform sampler2DArray s_img;"                                 "\n"
+      ""                                                                                  "\n"
+      "layout(location = 0) out vec4 g_color;"                                            "\n"
+      ""                                                                                  "\n"
+      "void main() {"                                                                     "\n"
+      "  ivec2 base = ivec2(gl_FragCoord.xy) * 64;"                                       "\n"
+      "  vec4 sum = vec4(0);"                                                             "\n"
+      "  for (int y = 0; y < 64; y += 8)"                                                 "\n"
+      "    for (int x = 0; x < 64; x += 8)"                                               "\n"
+      "      sum += texelFetch(s_img, ivec3(base + ivec2(x, y), 0), 0);"                  "\n"
+      "  g_color = sum / 64.0;"                                                           "\n"
+      "}"                                                                                 "\n", &small_frag);
+
+  unsigned output = GpuMallocImg(gpu_rgba_f32_e, DIM, DIM, 1, 1);
+  unsigned output_fbo = GpuFbo(output, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+  // The noise image is dead once the horizontal blur read it, so the vertical blur target reuses its texture
+  struct gpu_graph_t graph = {0};
+  int noise_img = GpuGraphTransientImg(&graph, gpu_rgba_f32_e, DIM, DIM);
+  int blur_img = GpuGraphTransientImg(&graph, gpu_rgba_f32_e, DIM, DIM);
+  int blurred_img = GpuGraphTransientImg(&graph, gpu_rgba_f32_e, DIM, DIM);
+  int output_img = GpuGraphImg(&graph, gpu_rgba_f32_e, output, DIM, DIM);
+  int small_img = GpuGraphTransientImg(&graph, gpu_rgba_f32_e, SMALL, SMALL);
+  GpuGraphKernel(&graph, noise, 0, 0, NULL, 1, &noise_img, SetTime, &noise_frag);
+  GpuGraphKernel(&graph, blur_h, 0, 1, &noise_img, 1, &blur_img, SetBlur, &blur[0]);
+  GpuGraphKernel(&graph, blur_v, 0, 1, &blur_img, 1, &blurred_img, SetBlur, &blur[1]);
+  GpuGraphKernel(&graph, tonemap, 0, 1, &blurred_img, 1, &output_img, NULL, NULL);
+  GpuGraphKernel(&graph, small, 0, 1, &output_img, 1, &small_img, NULL, NULL);
+  int small_readback = GpuGraphReadback(&graph, small_img, gpu_rgba_e, gpu_f32_e);
+  GpuGraphCompile(&graph);
+
+  print(GPULIB_MAX_PRINT_BYTES, "order:");
+  for (int i = 0; i < graph.jobs_count; i += 1)
+    print(GPULIB_MAX_PRINT_BYTES, " %d", graph.order[i]);
+  print(GPULIB_MAX_PRINT_BYTES, ", %d FBO and %d PPO switches, %d pooled objects for 4 transients\n", graph.fbo_switches, graph.ppo_switches, graph.pool_count);
+
+  unsigned long t_prev = GetTimeUs();
+  unsigned long t_run = 0;
+  unsigned long runs = 0;
+  float average[4] = {0};
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    unsigned long t = GetTimeUs();
+    GpuGraphRun(&graph);
+    t_run += GetTimeUs() - t;
+    runs += 1;
+
+    // The only fence in the graph, read a frame or more later without stalling
+    float * small_ptr = NULL;
+    if (GpuGraphReady(&graph, small_readback, (void **)&small_ptr)) {
+      for (int i = 0; i < 4; i += 1)
+        average[i] = 0;
+      for (int i = 0; i < SMALL * SMALL * 4; i += 1)
+        average[i % 4] += small_ptr[i] / (SMALL * SMALL);
+    }
+
+    GpuBindFbo(0);
+    GpuViewport(0, 0, 1280, 720);
+    GpuClear();
+    GpuBlitToScreen(output_fbo, 0, 0, 0, DIM, DIM, (1280 - 720) / 2, 0, 720, 720);
+    GpuSwap(dpy, win);
+
+    unsigned long t_curr = GetTimeUs();
+    if (t_curr - t_prev >= 1000000UL) {
+      print(GPULIB_MAX_PRINT_BYTES, "%.1f runs/s, submit us: %.1f, average color %.3f %.3f %.3f\n",
+          runs * 1000000.0 / (t_curr - t_prev), t_run / (double)(runs + !runs), average[0], average[1], average[2]);
+      t_run = 0;
+      runs = 0;
+      t_prev = GetTimeUs();
+    }
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "../../gpulib.h"
+
+enum {DIM = 2048, UPLOADS = 4};
+
+static inline unsigned long GetTimeUs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+
+struct layout_t {
+  char * name;
+  enum gpu_pix_format_e pixel_format;
+  enum gpu_pix_type_e pixel_type;
+  int bytes;
+};
+
+struct format_t {
+  char * name;
+  enum gpu_tex_format_e format;
+  unsigned tex;
+};
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Upload Benchmark", sizeof("Upload Benchmark"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  struct layout_t layouts[] = {
+    {"RGB/u8",    gpu_rgb_e,  gpu_u8_e,        3},
+    {"RGBA/u8",   gpu_rgba_e, gpu_u8_e,        4},
+    {"BGRA/u8",   gpu_bgra_e, gpu_u8_e,        4},
+    {"RGBA/8888", gpu_rgba_e, gpu_u8888_rev_e, 4},
+    {"BGRA/8888", gpu_bgra_e, gpu_u8888_rev_e, 4},
+  };
+  struct format_t formats[] = {
+    {"RGB8",         gpu_rgb_b8_e},
+    {"SRGB8",        gpu_srgb_b8_e},
+    {"RGBA8",        gpu_rgba_b8_e},
+    {"SRGB8_ALPHA8", gpu_srgba_b8_e},
+  };
+  enum {LAYOUTS = sizeof(layouts) / sizeof(layouts[0]), FORMATS = sizeof(formats) / sizeof(formats[0])};
+
+  for (int f = 0; f < FORMATS; f += 1)
+    formats[f].tex = GpuMallocImg(formats[f].format, DIM, DIM, 1, 1);
+  unsigned char * pixels = g_gpulib_libc.calloc(DIM * DIM, 4);
+  for (unsigned i = 0, seed = 1; i < DIM * DIM * 4; i += 1) {
+    seed = seed * 1664525u + 1013904223u;
+    pixels[i] = seed >> 24;
+  }
+  glPixelStorei(0x0CF5, 1); // GL_UNPACK_ALIGNMENT
+
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+
+    // MB/s of client memory, * marks the layout GpuPixLayout returns for the format
+    for (int f = 0; f < FORMATS; f += 1) {
+      enum gpu_pix_format_e fast_format = 0;
+      enum gpu_pix_type_e fast_type = 0;
+      GpuPixLayout(formats[f].format, &fast_format, &fast_type);
+      print(GPULIB_MAX_PRINT_BYTES, "%-12s", formats[f].name);
+      for (int l = 0; l < LAYOUTS; l += 1) {
+        GpuSet(formats[f].tex, 0, 0, 0, DIM, DIM, 1, 0, layouts[l].pixel_format, layouts[l].pixel_type, pixels);
+        GpuFinish();
+        unsigned long t = GetTimeUs();
+        for (int i = 0; i < UPLOADS; i += 1)
+          GpuSet(formats[f].tex, 0, 0, 0, DIM, DIM, 1, 0, layouts[l].pixel_format, layouts[l].pixel_type, pixels);
+        GpuFinish();
+        t = GetTimeUs() - t;
+        int fast = layouts[l].pixel_format == fast_format && layouts[l].pixel_type == fast_type;
+        print(GPULIB_MAX_PRINT_BYTES, " %s%s %.0f", fast ? "*" : " ", layouts[l].name, (double)DIM * DIM * layouts[l].bytes * UPLOADS / (double)(t + !t));
+      }
+      print(GPULIB_MAX_PRINT_BYTES, "\n");
+    }
+    print(GPULIB_MAX_PRINT_BYTES, "\n");
+
+    GpuClear();
+    GpuSwap(dpy, win);
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
@@ -0,0 +1,193 @@
+#include "../../gpulib.h"
+
+typedef struct { float x, y, z; }    vec3;
+typedef struct { float x, y, z, w; } vec4;
+
+enum {MAX_STR = 10000};
+
+struct {
+  char mesh [MAX_STR];
+} g_resources = {
+  .mesh = "../02_Instancing_and_MRT/meshes/Mesh.gpumesh",
+};
+
+static inline vec4 qmul(vec4 a, vec4 b) {
+  return (vec4){
+    a.x * b.w + b.x * a.w + (a.y * b.z - b.y * a.z),
+    a.y * b.w + b.y * a.w + (a.z * b.x - b.z * a.x),
+    a.z * b.w + b.z * a.w + (a.x * b.y - b.x * a.y),
+    a.w * b.w - (a.x * b.x + a.y * b.y + a.z * b.z)
+  };
+}
+
+static inline vec4 qinv(vec4 v) {
+  return (vec4){-v.x, -v.y, -v.z, v.w};
+}
+
+static inline vec4 qrot(vec4 p, vec4 v) {
+  return qmul(qmul(v, p), qinv(v));
+}
+
+static inline float tandegdiv2(float d) { return ftan(d * (M_PI / 180.0) / 2.0); }
+
+// Newton iterations, stdlib.h has no square root
+static inline float fsqrt(float x) {
+  float r = x > 1 ? x : 1;
+  for (int i = 0; i < 16; i += 1)
+    r = 0.5f * (r + x / r);
+  return r;
+}
+
+// The vertex shader divides by w = z + 0.1 after scaling x and y by fov_x and fov_y, so in view space the frustum is
+// fov * x + z + 0.1 >= 0 on each side, depth clamping leaves no near or far plane. Planes are then moved into mesh space.
+static inline void FrustumPlanes(vec3 cam_pos, vec4 cam_rot, float fov_x, float fov_y, float (* out_planes)[4]) {
+  float view[4][4] = {
+    { fov_x,      0, 1, 0.1f},
+    {-fov_x,      0, 1, 0.1f},
+    {     0,  fov_y, 1, 0.1f},
+    {     0, -fov_y, 1, 0.1f},
+  };
+  for (int i = 0; i < 4; i += 1) {
+    float length = fsqrt(view[i][0] * view[i][0] + view[i][1] * view[i][1] + view[i][2] * view[i][2]);
+    vec4 n = qrot((vec4){view[i][0] / length, view[i][1] / length, view[i][2] / length, 0}, cam_rot);
+    out_planes[i][0] = n.x;
+    out_planes[i][1] = n.y;
+    out_planes[i][2] = n.z;
+    out_planes[i][3] = view[i][3] / length - (n.x * cam_pos.x + n.y * cam_pos.y + n.z * cam_pos.z);
+  }
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Cluster Culling", sizeof("Cluster Culling"), 1280, 720, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  struct gpu_mesh_t mesh = {0};
+  GpuLoadMeshFile(g_resources.mesh, 0, 0, &mesh);
+  unsigned textures[16] = {
+    GpuMeshTex(&mesh, "position"),
+    GpuMeshTex(&mesh, "normal"),
+  };
+
+  // One command buffer per frame in flight, each filled only after the fence of the frame that last drew from it
+  unsigned dibs[2] = {0};
+  struct gpu_cmd_t * cmds[2] = {
+    GpuMallocCommands(mesh.cluster_count + 1, &dibs[0]),
+    GpuMallocCommands(mesh.cluster_count + 1, &dibs[1]),
+  };
+  void * fences[2] = {0};
+
+  unsigned vert = GpuVert(GPU_VERT_HEAD
+      "layout(binding = 0) uniform samplerBuffer s_pos;"     "\n"
+      "layout(binding = 1) uniform samplerBuffer s_normal;"  "\n"
+      ""                                                     "\n"
+      "layout(location = 0) uniform vec3  g_cam_pos;"        "\n"
+      "layout(location = 1) uniform vec4  g_cam_rot;"        "\n"
+      "layout(location = 2) uniform float g_fov_x;"          "\n"
+      "layout(location = 3) uniform float g_fov_y;"          "\n"
+      ""                                                     "\n"
+      "layout(location = 0) out vec3 g_normal;"              "\n"
+      ""                                                     "\n"
+      "vec4 qinv(vec4 v) {"                                  "\n"
+      "  return vec4(-v.xyz, v.w);"                          "\n"
+      "}"                                                    "\n"
+      ""                                                     "\n"
+      "vec3 qrot(vec3 p, vec4 v) {"                          "\n"
+      "  return fma(cross(v.xyz, fma(p, vec3(v.w), cross(v.xyz, p))), vec3(2), p);" "\n"
+      "}"                                                    "\n"
+      ""                                                     "\n"
+      "void main() {"                                        "\n"
+      "  vec3 pos = texelFetch(s_pos,    gl_VertexID).xyz;"  "\n"
+      "  g_normal = texelFetch(s_normal, gl_VertexID).xyz;"  "\n"
+      ""                                                     "\n"
+      "  vec3 mv = qrot(pos - g_cam_pos, qinv(g_cam_rot));"  "\n"
+      "  mv.x *= g_fov_x;"                                   "\n"
+      "  mv.y *= g_fov_y;"                                   "\n"
+      ""                                                     "\n"
+      "  gl_Position = vec4(mv, mv.z + 0.1);"                "\n"
+      "}"                                                    "\n");
+
+  unsigned frag = GpuFrag(GPU_FRAG_HEAD
+      "layout(location = 0) in vec3 g_normal;"               "\n"
+      ""                                                     "\n"
+      "layout(location = 0) out vec4 g_color;"               "\n"
+      ""                                                     "\n"
+      "void main() {"                                        "\n"
+      "  g_color = vec4(normalize(g_normal) * 0.5 + 0.5, 1);" "\n"
+      "}"                                                    "\n");
+
+  unsigned ppo = GpuPpo(vert, frag);
+
+  float fov = 1.f / tandegdiv2(85.f);
+  float fov_x = fov / (1280 / 720.f);
+  float fov_y = fov;
+
+  int cull = 1;
+  int triangle_count = 0;
+  for (int i = 0; i < mesh.cmd_count; i += 1)
+    triangle_count += mesh.cmds[i].count / 3;
+
+  int frame = 0;
+  for (Atom quit = g_gpulib_x11.wm_delete_window;;) {
+    for (XEvent event = {0}; XPending(dpy);) {
+      XNextEvent(dpy, &event);
+      GpuEvent(&event);
+      switch (event.type) {
+        break; case ClientMessage: {
+          if (event.xclient.data.l[0] == quit)
+            goto exit;
+        }
+      }
+    }
+    if (GpuKeyPressed(gpu_key_space_e))
+      cull = !cull;
+
+    // Orbits close enough for parts of the mesh to leave the screen
+    float angle = frame * 0.01f;
+    vec4 cam_rot = {0, fsin(angle / 2), 0, fcos(angle / 2)};
+    float cam_rot_length = fsqrt(cam_rot.y * cam_rot.y + cam_rot.w * cam_rot.w);
+    cam_rot.y /= cam_rot_length;
+    cam_rot.w /= cam_rot_length;
+    vec4 cam_back = qrot((vec4){0.6f, 0.3f, -1.4f, 0}, cam_rot);
+    vec3 cam_pos = {cam_back.x, cam_back.y, cam_back.z};
+
+    int f = frame & 1;
+    if (fences[f] != NULL) {
+      GpuFenceWait(fences[f], -1);
+      GpuFenceFree(fences[f]);
+    }
+    int cmd_count = mesh.cmd_count;
+    int visible = triangle_count;
+    if (cull) {
+      float planes[4][4];
+      FrustumPlanes(cam_pos, cam_rot, fov_x, fov_y, planes);
+      cmd_count = GpuMeshCull(&mesh, 0, mesh.cmd_count, &cam_pos.x, 4, planes, cmds[f]);
+      visible = 0;
+      for (int i = 0; i < cmd_count; i += 1)
+        visible += cmds[f][i].count / 3;
+    }
+    if (frame % 60 == 0)
+      print(GPULIB_MAX_PRINT_BYTES, "culling %s, %d of %d triangles\n", cull ? "on" : "off", visible, triangle_count);
+
+    GpuV3F(vert, 0, 1, &cam_pos.x);
+    GpuV4F(vert, 1, 1, &cam_rot.x);
+    GpuF32(vert, 2, 1, &fov_x);
+    GpuF32(vert, 3, 1, &fov_y);
+
+    GpuClear();
+    GpuBindPpo(ppo);
+    GpuBindTextures(0, 16, textures);
+    GpuBindIndices(mesh.idb, mesh.index_type);
+    GpuBindCommands(cull ? dibs[f] : mesh.dib);
+    GpuDraw(gpu_triangles_e, 0, cmd_count);
+    fences[f] = GpuFence();
+    GpuSwap(dpy, win);
+    frame += 1;
+  }
+
+exit:;
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return 0;
+}
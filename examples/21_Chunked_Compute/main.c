@@ -0,0 +1,72 @@
+#include "../../gpulib_compute.h"
+
+// A small window and a count that isn't a multiple of it, so both modes run several windows and a ragged tail
+enum {COUNT = 10007, WINDOW = 1000, RING = 3};
+
+static inline int Check(const char * mode, struct gpu_chunked_t * chunked, const unsigned * out, const unsigned * expect) {
+  int fails = 0;
+  for (int i = 0; i < COUNT; i += 1)
+    fails += out[i] != expect[i];
+  print(GPULIB_MAX_PRINT_BYTES, "%s: %d windows of %ld for %d elements, %d mismatches\n", mode, chunked->windows_count, (long)chunked->window_count, COUNT, fails);
+  return fails;
+}
+
+int main() {
+  Display * dpy = NULL;
+  Window win = 0;
+  GpuWindow("Chunked Compute", sizeof("Chunked Compute"), 640, 360, 4, NULL, &dpy, &win);
+  GpuSetDebugCallback(GpuDebugCallback);
+
+  unsigned * values_cpu = g_gpulib_libc.calloc(COUNT, sizeof(unsigned));
+  unsigned * expect = g_gpulib_libc.calloc(COUNT, sizeof(unsigned));
+  for (unsigned i = 0, seed = 1; i < COUNT; i += 1) {
+    seed = seed * 1664525u + 1013904223u;
+    values_cpu[i] = seed >> 8;
+    expect[i] = values_cpu[i] * 3u + i;
+  }
+
+  unsigned values_id = 0;
+  unsigned * values = GpuMalloc(COUNT * sizeof(unsigned), &values_id);
+  memcpy(values, values_cpu, COUNT * sizeof(unsigned));
+
+  unsigned out_id = 0;
+  unsigned * out = GpuMallocRead(COUNT * sizeof(unsigned), &out_id);
+
+  // The global index of an element is its window's first index plus gl_VertexID, the high half stays 0 here
+  unsigned kernel = GpuVertXfb(GPU_VERT_HEAD
+      "layout(binding = 0) uniform usamplerBuffer s_values;"                      "\n"
+      ""                                                                          "\n"
+      "layout(location = 0) uniform uint u_first[2];"                             "\n"
+      ""                                                                          "\n"
+      "flat out uint g_out;"                                                      "\n"
+      ""                                                                          "\n"
+      "void main() {"                                                             "\n"
+      "  uint i = u_first[0] + uint(gl_VertexID);"                                "\n"
+      "  g_out = u_first[1] == 0u ? texelFetch(s_values, gl_VertexID).x * 3u + i : 0u;" "\n"
+      "}"                                                                         "\n",
+      "g_out", NULL, NULL, NULL);
+  unsigned ppo = GpuPpo(kernel, 0);
+
+  int fails = 0;
+
+  struct gpu_chunked_t resident = {0};
+  GpuChunked(&resident, gpu_x_u32_e, values_id, COUNT, WINDOW);
+  memset(out, 0, COUNT * sizeof(unsigned));
+  GpuChunkedRun(&resident, ppo, kernel, 0, 0, out_id, sizeof(unsigned));
+  GpuFinish();
+  fails += Check("resident", &resident, out, expect);
+
+  struct gpu_chunked_t streamed = {0};
+  GpuChunkedStream(&streamed, gpu_x_u32_e, values_cpu, COUNT, WINDOW, RING);
+  memset(out, 0, COUNT * sizeof(unsigned));
+  if (!GpuChunkedRun(&streamed, ppo, kernel, 0, 0, out_id, sizeof(unsigned)))
+    print(GPULIB_MAX_PRINT_BYTES, "streamed: timed out waiting for an upload slot\n");
+  GpuFinish();
+  fails += Check("streamed", &streamed, out, expect);
+
+  print(GPULIB_MAX_PRINT_BYTES, "%s\n", fails == 0 ? "PASS" : "FAIL");
+
+  XDestroyWindow(dpy, win);
+  XCloseDisplay(dpy);
+  return fails != 0;
+}
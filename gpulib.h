@@ -1,5 +1,7 @@
 #pragma once
 
+#define GPULIB_INCLUDED
+
 #ifndef GPULIB_MAX_PRINT_BYTES
 #define GPULIB_MAX_PRINT_BYTES (4096)
 #endif
@@ -12,6 +14,17 @@
 #define profE(x)
 #endif
 
+// Tinyprofiler slot of the calling thread, 0 on the main thread, the render and loader threads of gpulib_thread.h take
+// their own. Threads whose slot is past TINYPROFILER_MAX_NUM_OF_THREADS don't profile.
+__thread int g_gpulib_prof_tid = 0;
+
+#if defined(USE_TINYPROFILER) && defined(profBmt)
+#undef profB
+#undef profE
+#define profB(x) do { if (g_gpulib_prof_tid < TINYPROFILER_MAX_NUM_OF_THREADS) profBmt(g_gpulib_prof_tid, x); } while (0)
+#define profE(x) do { if (g_gpulib_prof_tid < TINYPROFILER_MAX_NUM_OF_THREADS) profEmt(g_gpulib_prof_tid, x); } while (0)
+#endif
+
 #include <X11/extensions/Xrender.h>
 #include <X11/extensions/XInput2.h>
 #include <X11/XKBlib.h>
@@ -27,6 +40,112 @@ struct gpu_cmd_t {
   unsigned instance_first;
 };
 
+// Texture container: this header, then mipmap_count * layer_count * face_count subresource entries ordered by
+// mipmap, then layer, then face. Every subresource starts at a GPULIB_IMG_FILE_ALIGNMENT offset and holds one face of
+// one layer of one mipmap, tightly packed rows for uncompressed formats or S3TC blocks for compressed ones.
+#define GPULIB_IMG_FILE_MAGIC     (0x49555047) // "GPUI"
+#define GPULIB_IMG_FILE_VERSION   (1)
+#define GPULIB_IMG_FILE_ALIGNMENT (4096)
+
+struct gpu_img_file_t {
+  unsigned magic;
+  unsigned version;
+  unsigned format;       // enum gpu_tex_format_e
+  unsigned pixel_format; // enum gpu_pix_format_e, 0 for compressed formats
+  unsigned pixel_type;   // enum gpu_pix_type_e, 0 for compressed formats
+  int width;
+  int height;
+  int layer_count;
+  int face_count;        // 1 for images, 6 for cubemaps
+  int mipmap_count;
+  unsigned long file_bytes;
+};
+
+struct gpu_img_file_sub_t {
+  unsigned long bytes_first;
+  unsigned long bytes_count;
+};
+
+// Mesh pack: this header, stream_count stream entries, cmd_count draw commands, cmd_count command names, cluster_count
+// clusters ordered by command and lod_count levels of detail ordered by command and level. Every stream starts at a
+// GPULIB_MESH_FILE_ALIGNMENT offset. Vertex streams hold vertex_count elements fetched by gl_VertexID through texture
+// buffers, the index stream holds the indices of every command followed by those of their simplified levels. Quantized
+// positions are gpu_xyzw_b16_e fractions of the mesh bounds, quantized normals are gpu_xy_b8_e or gpu_xy_b16_e
+// octahedral encodings and quantized uvs are gpu_xy_f16_e, see GpuDecodePosition and GpuDecodeOctahedral.
+#define GPULIB_MESH_FILE_MAGIC      (0x4D555047) // "GPUM"
+#define GPULIB_MESH_FILE_VERSION    (4)
+#define GPULIB_MESH_FILE_ALIGNMENT  (4096)
+#define GPULIB_MESH_FILE_NAME_BYTES (32)
+
+#ifndef GPULIB_MAX_MESH_STREAMS
+#define GPULIB_MAX_MESH_STREAMS (16)
+#endif
+
+struct gpu_mesh_file_t {
+  unsigned magic;
+  unsigned version;
+  unsigned vertex_count;
+  unsigned index_type;   // enum gpu_pix_type_e
+  unsigned stream_count;
+  unsigned cmd_count;
+  unsigned long file_bytes;
+  float aabb_min[3];
+  float aabb_max[3];
+  unsigned cluster_count;
+  unsigned cluster_triangles; // most triangles in one cluster
+  unsigned lod_count;
+  unsigned lod_levels; // most levels of one command
+};
+
+struct gpu_mesh_file_stream_t {
+  char name[GPULIB_MESH_FILE_NAME_BYTES];
+  unsigned format;       // enum gpu_buf_format_e, 0 for the index stream
+  unsigned count;
+  unsigned long bytes_first;
+  unsigned long bytes_count;
+};
+
+// A run of triangles of one command with its bounding sphere and normal cone, cone_cutoff is the sine of the cone's half
+// angle or 1 when the triangles face too many ways for the cluster to ever be back facing, see GpuMeshCull
+struct gpu_mesh_cluster_t {
+  float center[3];
+  float radius;
+  float cone_axis[3];
+  float cone_cutoff;
+  unsigned cmd;
+  unsigned first;
+  unsigned count;
+};
+
+// A level of detail of command cmd, level 0 is the command itself. error estimates how far, in mesh units, the level's
+// surface strays from the command's, see GpuMeshLod
+struct gpu_mesh_lod_t {
+  unsigned cmd;
+  unsigned first;
+  unsigned count;
+  float error;
+};
+
+struct gpu_mesh_t {
+  int vertex_count;
+  unsigned index_type;
+  float aabb_min[3];
+  float aabb_max[3];
+  unsigned idb;
+  unsigned dib;
+  int stream_count;
+  char stream_names[GPULIB_MAX_MESH_STREAMS][GPULIB_MESH_FILE_NAME_BYTES];
+  unsigned bufs[GPULIB_MAX_MESH_STREAMS];
+  unsigned texs[GPULIB_MAX_MESH_STREAMS]; // 0 for the index stream
+  int cmd_count;
+  struct gpu_cmd_t * cmds;
+  char (* cmd_names)[GPULIB_MESH_FILE_NAME_BYTES];
+  int cluster_count;
+  struct gpu_mesh_cluster_t * clusters;
+  int lod_count;
+  struct gpu_mesh_lod_t * lods;
+};
+
 enum {
   gpu_depth_e = 0x0B71, // GL_DEPTH_TEST
 };
@@ -39,6 +158,7 @@ enum gpu_mode_e {
 
 enum gpu_buf_format_e {
   gpu_x_b8_e     = 0x8229, // GL_R8
+  gpu_x_b16_e    = 0x822A, // GL_R16
   gpu_x_f16_e    = 0x822D, // GL_R16F
   gpu_x_f32_e    = 0x822E, // GL_R32F
   gpu_x_i8_e     = 0x8231, // GL_R8I
@@ -48,6 +168,7 @@ enum gpu_buf_format_e {
   gpu_x_u16_e    = 0x8234, // GL_R16UI
   gpu_x_u32_e    = 0x8236, // GL_R32UI
   gpu_xy_b8_e    = 0x822B, // GL_RG8
+  gpu_xy_b16_e   = 0x822C, // GL_RG16
   gpu_xy_f16_e   = 0x822F, // GL_RG16F
   gpu_xy_f32_e   = 0x8230, // GL_RG32F
   gpu_xy_i8_e    = 0x8237, // GL_RG8I
@@ -60,6 +181,7 @@ enum gpu_buf_format_e {
   gpu_xyz_i32_e  = 0x8D83, // GL_RGB32I
   gpu_xyz_u32_e  = 0x8D71, // GL_RGB32UI
   gpu_xyzw_b8_e  = 0x8058, // GL_RGBA8
+  gpu_xyzw_b16_e = 0x805B, // GL_RGBA16
   gpu_xyzw_f16_e = 0x881A, // GL_RGBA16F
   gpu_xyzw_f32_e = 0x8814, // GL_RGBA32F
   gpu_xyzw_i8_e  = 0x8D8E, // GL_RGBA8I
@@ -77,6 +199,10 @@ enum gpu_tex_format_e {
   gpu_srgb_b8_e            = 0x8C41, // GL_SRGB8
   gpu_srgba_b8_e           = 0x8C43, // GL_SRGB8_ALPHA8
   gpu_rgba_f32_e           = 0x8814, // GL_RGBA32F
+  gpu_r_f32_e              = 0x822E, // GL_R32F
+  gpu_r_i32_e              = 0x8235, // GL_R32I
+  gpu_r_u32_e              = 0x8236, // GL_R32UI
+  gpu_rg_u32_e             = 0x823C, // GL_RG32UI
   gpu_rgb_s3tc_dxt1_b8_e   = 0x83F0, // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
   gpu_rgba_s3tc_dxt1_b8_e  = 0x83F1, // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
   gpu_rgba_s3tc_dxt3_b8_e  = 0x83F2, // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
@@ -112,6 +238,9 @@ enum gpu_pix_format_e {
   gpu_bgr_e  = 0x80E0, // GL_BGR
   gpu_rgba_e = 0x1908, // GL_RGBA
   gpu_bgra_e = 0x80E1, // GL_BGRA
+  gpu_r_e    = 0x1903, // GL_RED
+  gpu_ri_e   = 0x8D94, // GL_RED_INTEGER
+  gpu_rgi_e  = 0x8228, // GL_RG_INTEGER
 };
 
 enum gpu_pix_type_e {
@@ -122,6 +251,183 @@ enum gpu_pix_type_e {
   gpu_u16_e = 0x1403, // GL_UNSIGNED_SHORT
   gpu_u32_e = 0x1405, // GL_UNSIGNED_INT
   gpu_f32_e = 0x1406, // GL_FLOAT
+
+  gpu_u8888_rev_e = 0x8367, // GL_UNSIGNED_INT_8_8_8_8_REV, one 32-bit texel, the same bytes as gpu_u8_e on little-endian
+};
+
+enum gpu_key_e {
+  gpu_key_none_e,
+  gpu_key_esc_e,
+  gpu_key_tab_e,
+  gpu_key_enter_e,
+  gpu_key_backspace_e,
+  gpu_key_space_e,
+  gpu_key_capslock_e,
+  gpu_key_lshift_e,
+  gpu_key_rshift_e,
+  gpu_key_lctrl_e,
+  gpu_key_rctrl_e,
+  gpu_key_lalt_e,
+  gpu_key_ralt_e,
+  gpu_key_lsuper_e,
+  gpu_key_rsuper_e,
+  gpu_key_up_e,
+  gpu_key_down_e,
+  gpu_key_left_e,
+  gpu_key_right_e,
+  gpu_key_home_e,
+  gpu_key_end_e,
+  gpu_key_pgup_e,
+  gpu_key_pgdn_e,
+  gpu_key_insert_e,
+  gpu_key_delete_e,
+  gpu_key_f1_e,
+  gpu_key_f2_e,
+  gpu_key_f3_e,
+  gpu_key_f4_e,
+  gpu_key_f5_e,
+  gpu_key_f6_e,
+  gpu_key_f7_e,
+  gpu_key_f8_e,
+  gpu_key_f9_e,
+  gpu_key_f10_e,
+  gpu_key_f11_e,
+  gpu_key_f12_e,
+  gpu_key_1_e,
+  gpu_key_2_e,
+  gpu_key_3_e,
+  gpu_key_4_e,
+  gpu_key_5_e,
+  gpu_key_6_e,
+  gpu_key_7_e,
+  gpu_key_8_e,
+  gpu_key_9_e,
+  gpu_key_0_e,
+  gpu_key_a_e,
+  gpu_key_b_e,
+  gpu_key_c_e,
+  gpu_key_d_e,
+  gpu_key_e_e,
+  gpu_key_f_e,
+  gpu_key_g_e,
+  gpu_key_h_e,
+  gpu_key_i_e,
+  gpu_key_j_e,
+  gpu_key_k_e,
+  gpu_key_l_e,
+  gpu_key_m_e,
+  gpu_key_n_e,
+  gpu_key_o_e,
+  gpu_key_p_e,
+  gpu_key_q_e,
+  gpu_key_r_e,
+  gpu_key_s_e,
+  gpu_key_t_e,
+  gpu_key_u_e,
+  gpu_key_v_e,
+  gpu_key_w_e,
+  gpu_key_x_e,
+  gpu_key_y_e,
+  gpu_key_z_e,
+  gpu_key_grave_e,
+  gpu_key_minus_e,
+  gpu_key_equal_e,
+  gpu_key_lbracket_e,
+  gpu_key_rbracket_e,
+  gpu_key_backslash_e,
+  gpu_key_semicolon_e,
+  gpu_key_apostrophe_e,
+  gpu_key_comma_e,
+  gpu_key_period_e,
+  gpu_key_slash_e,
+  gpu_key_count_e,
+};
+
+// XKB key names are layout independent, gpu_key_a_e is the key at the QWERTY A position.
+static char g_gpulib_key_names[gpu_key_count_e][5] = {
+  [gpu_key_esc_e]        = "ESC",
+  [gpu_key_tab_e]        = "TAB",
+  [gpu_key_enter_e]      = "RTRN",
+  [gpu_key_backspace_e]  = "BKSP",
+  [gpu_key_space_e]      = "SPCE",
+  [gpu_key_capslock_e]   = "CAPS",
+  [gpu_key_lshift_e]     = "LFSH",
+  [gpu_key_rshift_e]     = "RTSH",
+  [gpu_key_lctrl_e]      = "LCTL",
+  [gpu_key_rctrl_e]      = "RCTL",
+  [gpu_key_lalt_e]       = "LALT",
+  [gpu_key_ralt_e]       = "RALT",
+  [gpu_key_lsuper_e]     = "LWIN",
+  [gpu_key_rsuper_e]     = "RWIN",
+  [gpu_key_up_e]         = "UP",
+  [gpu_key_down_e]       = "DOWN",
+  [gpu_key_left_e]       = "LEFT",
+  [gpu_key_right_e]      = "RGHT",
+  [gpu_key_home_e]       = "HOME",
+  [gpu_key_end_e]        = "END",
+  [gpu_key_pgup_e]       = "PGUP",
+  [gpu_key_pgdn_e]       = "PGDN",
+  [gpu_key_insert_e]     = "INS",
+  [gpu_key_delete_e]     = "DELE",
+  [gpu_key_f1_e]         = "FK01",
+  [gpu_key_f2_e]         = "FK02",
+  [gpu_key_f3_e]         = "FK03",
+  [gpu_key_f4_e]         = "FK04",
+  [gpu_key_f5_e]         = "FK05",
+  [gpu_key_f6_e]         = "FK06",
+  [gpu_key_f7_e]         = "FK07",
+  [gpu_key_f8_e]         = "FK08",
+  [gpu_key_f9_e]         = "FK09",
+  [gpu_key_f10_e]        = "FK10",
+  [gpu_key_f11_e]        = "FK11",
+  [gpu_key_f12_e]        = "FK12",
+  [gpu_key_1_e]          = "AE01",
+  [gpu_key_2_e]          = "AE02",
+  [gpu_key_3_e]          = "AE03",
+  [gpu_key_4_e]          = "AE04",
+  [gpu_key_5_e]          = "AE05",
+  [gpu_key_6_e]          = "AE06",
+  [gpu_key_7_e]          = "AE07",
+  [gpu_key_8_e]          = "AE08",
+  [gpu_key_9_e]          = "AE09",
+  [gpu_key_0_e]          = "AE10",
+  [gpu_key_a_e]          = "AC01",
+  [gpu_key_b_e]          = "AB05",
+  [gpu_key_c_e]          = "AB03",
+  [gpu_key_d_e]          = "AC03",
+  [gpu_key_e_e]          = "AD03",
+  [gpu_key_f_e]          = "AC04",
+  [gpu_key_g_e]          = "AC05",
+  [gpu_key_h_e]          = "AC06",
+  [gpu_key_i_e]          = "AD08",
+  [gpu_key_j_e]          = "AC07",
+  [gpu_key_k_e]          = "AC08",
+  [gpu_key_l_e]          = "AC09",
+  [gpu_key_m_e]          = "AB07",
+  [gpu_key_n_e]          = "AB06",
+  [gpu_key_o_e]          = "AD09",
+  [gpu_key_p_e]          = "AD10",
+  [gpu_key_q_e]          = "AD01",
+  [gpu_key_r_e]          = "AD04",
+  [gpu_key_s_e]          = "AC02",
+  [gpu_key_t_e]          = "AD05",
+  [gpu_key_u_e]          = "AD07",
+  [gpu_key_v_e]          = "AB04",
+  [gpu_key_w_e]          = "AD02",
+  [gpu_key_x_e]          = "AB02",
+  [gpu_key_y_e]          = "AD06",
+  [gpu_key_z_e]          = "AB01",
+  [gpu_key_grave_e]      = "TLDE",
+  [gpu_key_minus_e]      = "AE11",
+  [gpu_key_equal_e]      = "AE12",
+  [gpu_key_lbracket_e]   = "AD11",
+  [gpu_key_rbracket_e]   = "AD12",
+  [gpu_key_backslash_e]  = "BKSL",
+  [gpu_key_semicolon_e]  = "AC10",
+  [gpu_key_apostrophe_e] = "AC11",
+  [gpu_key_comma_e]      = "AB08",
+  [gpu_key_period_e]     = "AB09",
+  [gpu_key_slash_e]      = "AB10",
 };
 
 struct MWMHints {
@@ -160,7 +466,8 @@ struct MWMHints {
 
 #define MWM_TEAROFF_WINDOW      (1L<<0)
 
-#define GPU_VERT_HEAD                                          \
+// Version and extensions shared by GPU_VERT_HEAD, GPU_FRAG_HEAD and GPU_KERNEL_HEAD
+#define GPU_SYS_HEAD                                           \
   "#version 330"                                          "\n" \
   "#extension GL_ARB_gpu_shader5                : enable" "\n" \
   "#extension GL_ARB_shader_precision           : enable" "\n" \
@@ -169,23 +476,36 @@ struct MWMHints {
   "#extension GL_ARB_shading_language_420pack   : enable" "\n" \
   "#extension GL_ARB_shading_language_packing   : enable" "\n" \
   "#extension GL_ARB_explicit_uniform_location  : enable" "\n" \
-  "#extension GL_ARB_fragment_coord_conventions : enable" "\n" \
+  "#extension GL_ARB_fragment_coord_conventions : enable" "\n"
+
+#define GPU_VERT_HEAD                                          \
+  GPU_SYS_HEAD                                                 \
   "out gl_PerVertex { vec4 gl_Position; };"               "\n" \
+  ""                                                      "\n" \
+  "vec3 GpuDecodePosition(vec4 q, vec3 lo, vec3 hi) {"    "\n" \
+  "  return lo + q.xyz * (hi - lo);"                      "\n" \
+  "}"                                                     "\n" \
+  ""                                                      "\n" \
+  "vec3 GpuDecodeOctahedral(vec2 e) {"                    "\n" \
+  "  e = e * 2 - 1;"                                      "\n" \
+  "  vec3 n = vec3(e, 1 - abs(e.x) - abs(e.y));"          "\n" \
+  "  float t = max(-n.z, 0);"                             "\n" \
+  "  n.x += n.x >= 0 ? -t : t;"                           "\n" \
+  "  n.y += n.y >= 0 ? -t : t;"                           "\n" \
+  "  return normalize(n);"                                "\n" \
+  "}"                                                     "\n" \
   ""                                                      "\n"
 
 #define GPU_FRAG_HEAD                                          \
-  "#version 330"                                          "\n" \
-  "#extension GL_ARB_gpu_shader5                : enable" "\n" \
-  "#extension GL_ARB_shader_precision           : enable" "\n" \
-  "#extension GL_ARB_texture_cube_map_array     : enable" "\n" \
-  "#extension GL_ARB_separate_shader_objects    : enable" "\n" \
-  "#extension GL_ARB_shading_language_420pack   : enable" "\n" \
-  "#extension GL_ARB_shading_language_packing   : enable" "\n" \
-  "#extension GL_ARB_explicit_uniform_location  : enable" "\n" \
-  "#extension GL_ARB_fragment_coord_conventions : enable" "\n" \
+  GPU_SYS_HEAD                                                 \
   "layout(origin_upper_left) in vec4 gl_FragCoord;"       "\n" \
   ""                                                      "\n"
 
+// Same as GPU_FRAG_HEAD but with gl_FragCoord.xy equal to the texel being written, for GpuKernel
+#define GPU_KERNEL_HEAD                                        \
+  GPU_SYS_HEAD                                                 \
+  ""                                                      "\n"
+
 void (*glAttachShader)(unsigned, unsigned);
 void (*glBeginTransformFeedback)(unsigned);
 void (*glBindBuffer)(unsigned, unsigned);
@@ -195,12 +515,16 @@ void (*glBindSamplers)(int, int, unsigned *);
 void (*glBindTextures)(int, int, unsigned *);
 void (*glBindTransformFeedback)(unsigned, unsigned);
 void (*glBindVertexArray)(unsigned);
+void (*glBlendFuncSeparate)(unsigned, unsigned, unsigned, unsigned);
 void (*glBlitNamedFramebuffer)(unsigned, unsigned, int, int, int, int, int, int, int, int, unsigned, unsigned);
 void (*glBufferStorage)(unsigned, ptrdiff_t, void *, unsigned);
 void (*glClearTexSubImage)(unsigned, int, int, int, int, int, int, int, unsigned, unsigned, void *);
+unsigned (*glClientWaitSync)(void *, unsigned, unsigned long);
 void (*glClipControl)(unsigned, unsigned);
 void (*glCompileShader)(unsigned);
 void (*glCompressedTextureSubImage3D)(unsigned, int, int, int, int, int, int, int, unsigned, unsigned, void *);
+void (*glCopyImageSubData)(unsigned, unsigned, int, int, int, int, unsigned, unsigned, int, int, int, int, int, int, int);
+void (*glCopyNamedBufferSubData)(unsigned, unsigned, ptrdiff_t, ptrdiff_t, ptrdiff_t);
 void (*glCreateBuffers)(int, unsigned *);
 void (*glCreateFramebuffers)(int, unsigned *);
 unsigned (*glCreateProgram)();
@@ -217,10 +541,13 @@ void (*glDeleteProgram)(unsigned);
 void (*glDeleteProgramPipelines)(int, unsigned *);
 void (*glDeleteSamplers)(int, unsigned *);
 void (*glDeleteShader)(unsigned);
+void (*glDeleteSync)(void *);
 void (*glDeleteTransformFeedbacks)(int, unsigned *);
 void (*glDetachShader)(unsigned, unsigned);
 void (*glDrawArraysInstanced)(unsigned, unsigned, unsigned, unsigned);
+void (*glDrawTransformFeedback)(unsigned, unsigned);
 void (*glEndTransformFeedback)();
+void * (*glFenceSync)(unsigned, unsigned);
 void (*glGenBuffers)(int, unsigned *);
 void (*glGenerateTextureMipmap)(unsigned);
 void (*glGetCompressedTextureSubImage)(unsigned, int, int, int, int, int, int, int, int, void *);
@@ -229,6 +556,7 @@ void (*glGetProgramiv)(unsigned, unsigned, int *);
 void (*glGetShaderInfoLog)(unsigned, int, int *, char *);
 void (*glGetShaderiv)(unsigned, unsigned, int *);
 char * (*glGetStringi)(unsigned, unsigned);
+void (*glGetTextureParameteriv)(unsigned, unsigned, int *);
 void (*glGetTextureSubImage)(unsigned, int, int, int, int, int, int, int, unsigned, unsigned, unsigned, void *);
 void (*glLinkProgram)(unsigned);
 void * (*glMapBufferRange)(unsigned, ptrdiff_t, ptrdiff_t, unsigned);
@@ -239,6 +567,7 @@ void (*glNamedFramebufferDrawBuffer)(unsigned, int);
 void (*glNamedFramebufferDrawBuffers)(unsigned, int, int *);
 void (*glNamedFramebufferReadBuffer)(unsigned, int);
 void (*glNamedFramebufferTextureLayer)(unsigned, int, unsigned, int, int);
+void (*glPauseTransformFeedback)();
 void (*glProgramParameteri)(unsigned, unsigned, int);
 void (*glProgramUniform1fv)(unsigned, int, int, float *);
 void (*glProgramUniform1iv)(unsigned, int, int, int *);
@@ -246,6 +575,7 @@ void (*glProgramUniform1uiv)(unsigned, int, int, unsigned *);
 void (*glProgramUniform2fv)(unsigned, int, int, float *);
 void (*glProgramUniform3fv)(unsigned, int, int, float *);
 void (*glProgramUniform4fv)(unsigned, int, int, float *);
+void (*glResumeTransformFeedback)();
 void (*glSamplerParameteri)(unsigned, unsigned, int);
 void (*glShaderSource)(unsigned, int, char **, int *);
 void (*glTextureBufferRange)(unsigned, unsigned, unsigned, ptrdiff_t, ptrdiff_t);
@@ -265,6 +595,8 @@ struct gpu_sys_libc_t {
   pid_t (*getpid)();
   int (*pclose)(int *);
   int * (*popen)(char *, char *);
+  int (*pthread_create)(unsigned long *, void *, void * (*)(void *), void *);
+  int (*pthread_join)(unsigned long, void **);
   ssize_t (*readlink)(char *, char *, size_t);
   void * (*realloc)(void *, size_t);
   char * (*setlocale)(int, char *);
@@ -291,8 +623,60 @@ struct gpu_sys_libc_t {
   (void *)0xBAD,
   (void *)0xBAD,
   (void *)0xBAD,
+  (void *)0xBAD,
+  (void *)0xBAD,
+};
+
+struct gpu_sys_keys_t {
+  unsigned char map[256];                  // X11 keycode to enum gpu_key_e
+  unsigned char keycodes[gpu_key_count_e]; // enum gpu_key_e to X11 keycode
+  unsigned long down[2];
+  unsigned long pressed[2];
+  unsigned long released[2];
+} g_gpulib_keys = {0};
+
+struct gpu_sys_x11_t {
+  Atom utf8_string;
+  Atom motif_wm_hints;
+  Atom wm_delete_window;
+  Atom clipboard;
+  Atom targets;
+  Atom text;
+  Atom incr;
+  Atom xsel_data;
+  int  width;
+  int  height;
+  int  focused;
+  int  mapped;
+  GLXFBConfig fbconfig;
+  GLXContext  glx_ctx;
+} g_gpulib_x11 = {0};
+
+// Last state set through GpuBindFbo, GpuBindPpo, GpuBindIndices and GpuViewport, raw GL binds are not tracked
+struct gpu_sys_state_t {
+  unsigned fbo;
+  unsigned ppo;
+  unsigned index_type; // gpu_u32_e until GpuBindIndices, for index buffers bound another way
+  int viewport[4];
+} g_gpulib_state = {.index_type = gpu_u32_e};
+
+#ifndef GPULIB_MAX_KERNEL_FBOS
+#define GPULIB_MAX_KERNEL_FBOS (256)
+#endif
+
+struct gpu_sys_kernel_fbo_t {
+  unsigned tex[4];
+  int layer[4];
+  unsigned fbo;
+  unsigned long used; // Tick of the last lookup, the least recently used entry is evicted when the cache is full
 };
 
+struct gpu_sys_kernel_t {
+  unsigned vert;
+  unsigned long tick;
+  struct gpu_sys_kernel_fbo_t fbos[GPULIB_MAX_KERNEL_FBOS];
+} g_gpulib_kernel = {0};
+
 static inline void GpuSysGetOpenGLProcedureAddresses() {
   glAttachShader = (void *)glXGetProcAddressARB((unsigned char *)"glAttachShader");
   glBeginTransformFeedback = (void *)glXGetProcAddressARB((unsigned char *)"glBeginTransformFeedback");
@@ -303,12 +687,16 @@ static inline void GpuSysGetOpenGLProcedureAddresses() {
   glBindTextures = (void *)glXGetProcAddressARB((unsigned char *)"glBindTextures");
   glBindTransformFeedback = (void *)glXGetProcAddressARB((unsigned char *)"glBindTransformFeedback");
   glBindVertexArray = (void *)glXGetProcAddressARB((unsigned char *)"glBindVertexArray");
+  glBlendFuncSeparate = (void *)glXGetProcAddressARB((unsigned char *)"glBlendFuncSeparate");
   glBlitNamedFramebuffer = (void *)glXGetProcAddressARB((unsigned char *)"glBlitNamedFramebuffer");
   glBufferStorage = (void *)glXGetProcAddressARB((unsigned char *)"glBufferStorage");
   glClearTexSubImage = (void *)glXGetProcAddressARB((unsigned char *)"glClearTexSubImage");
+  glClientWaitSync = (void *)glXGetProcAddressARB((unsigned char *)"glClientWaitSync");
   glClipControl = (void *)glXGetProcAddressARB((unsigned char *)"glClipControl");
   glCompileShader = (void *)glXGetProcAddressARB((unsigned char *)"glCompileShader");
   glCompressedTextureSubImage3D = (void *)glXGetProcAddressARB((unsigned char *)"glCompressedTextureSubImage3D");
+  glCopyImageSubData = (void *)glXGetProcAddressARB((unsigned char *)"glCopyImageSubData");
+  glCopyNamedBufferSubData = (void *)glXGetProcAddressARB((unsigned char *)"glCopyNamedBufferSubData");
   glCreateBuffers = (void *)glXGetProcAddressARB((unsigned char *)"glCreateBuffers");
   glCreateFramebuffers = (void *)glXGetProcAddressARB((unsigned char *)"glCreateFramebuffers");
   glCreateProgram = (void *)glXGetProcAddressARB((unsigned char *)"glCreateProgram");
@@ -325,10 +713,13 @@ static inline void GpuSysGetOpenGLProcedureAddresses() {
   glDeleteProgramPipelines = (void *)glXGetProcAddressARB((unsigned char *)"glDeleteProgramPipelines");
   glDeleteSamplers = (void *)glXGetProcAddressARB((unsigned char *)"glDeleteSamplers");
   glDeleteShader = (void *)glXGetProcAddressARB((unsigned char *)"glDeleteShader");
+  glDeleteSync = (void *)glXGetProcAddressARB((unsigned char *)"glDeleteSync");
   glDeleteTransformFeedbacks = (void *)glXGetProcAddressARB((unsigned char *)"glDeleteTransformFeedbacks");
   glDetachShader = (void *)glXGetProcAddressARB((unsigned char *)"glDetachShader");
   glDrawArraysInstanced = (void *)glXGetProcAddressARB((unsigned char *)"glDrawArraysInstanced");
+  glDrawTransformFeedback = (void *)glXGetProcAddressARB((unsigned char *)"glDrawTransformFeedback");
   glEndTransformFeedback = (void *)glXGetProcAddressARB((unsigned char *)"glEndTransformFeedback");
+  glFenceSync = (void *)glXGetProcAddressARB((unsigned char *)"glFenceSync");
   glGenBuffers = (void *)glXGetProcAddressARB((unsigned char *)"glGenBuffers");
   glGenerateTextureMipmap = (void *)glXGetProcAddressARB((unsigned char *)"glGenerateTextureMipmap");
   glGetCompressedTextureSubImage = (void *)glXGetProcAddressARB((unsigned char *)"glGetCompressedTextureSubImage");
@@ -336,6 +727,7 @@ static inline void GpuSysGetOpenGLProcedureAddresses() {
   glGetProgramiv = (void *)glXGetProcAddressARB((unsigned char *)"glGetProgramiv");
   glGetShaderInfoLog = (void *)glXGetProcAddressARB((unsigned char *)"glGetShaderInfoLog");
   glGetShaderiv = (void *)glXGetProcAddressARB((unsigned char *)"glGetShaderiv");
+  glGetTextureParameteriv = (void *)glXGetProcAddressARB((unsigned char *)"glGetTextureParameteriv");
   glGetTextureSubImage = (void *)glXGetProcAddressARB((unsigned char *)"glGetTextureSubImage");
   glLinkProgram = (void *)glXGetProcAddressARB((unsigned char *)"glLinkProgram");
   glMapBufferRange = (void *)glXGetProcAddressARB((unsigned char *)"glMapBufferRange");
@@ -346,6 +738,7 @@ static inline void GpuSysGetOpenGLProcedureAddresses() {
   glNamedFramebufferDrawBuffers = (void *)glXGetProcAddressARB((unsigned char *)"glNamedFramebufferDrawBuffers");
   glNamedFramebufferReadBuffer = (void *)glXGetProcAddressARB((unsigned char *)"glNamedFramebufferReadBuffer");
   glNamedFramebufferTextureLayer = (void *)glXGetProcAddressARB((unsigned char *)"glNamedFramebufferTextureLayer");
+  glPauseTransformFeedback = (void *)glXGetProcAddressARB((unsigned char *)"glPauseTransformFeedback");
   glProgramParameteri = (void *)glXGetProcAddressARB((unsigned char *)"glProgramParameteri");
   glProgramUniform1fv = (void *)glXGetProcAddressARB((unsigned char *)"glProgramUniform1fv");
   glProgramUniform1iv = (void *)glXGetProcAddressARB((unsigned char *)"glProgramUniform1iv");
@@ -353,6 +746,7 @@ static inline void GpuSysGetOpenGLProcedureAddresses() {
   glProgramUniform2fv = (void *)glXGetProcAddressARB((unsigned char *)"glProgramUniform2fv");
   glProgramUniform3fv = (void *)glXGetProcAddressARB((unsigned char *)"glProgramUniform3fv");
   glProgramUniform4fv = (void *)glXGetProcAddressARB((unsigned char *)"glProgramUniform4fv");
+  glResumeTransformFeedback = (void *)glXGetProcAddressARB((unsigned char *)"glResumeTransformFeedback");
   glSamplerParameteri = (void *)glXGetProcAddressARB((unsigned char *)"glSamplerParameteri");
   glShaderSource = (void *)glXGetProcAddressARB((unsigned char *)"glShaderSource");
   glTextureBufferRange = (void *)glXGetProcAddressARB((unsigned char *)"glTextureBufferRange");
@@ -373,6 +767,8 @@ static inline void GpuSysGetLibcProcedureAddresses() {
   g_gpulib_libc.getpid = dlsym(NULL, "getpid");
   g_gpulib_libc.pclose = dlsym(NULL, "pclose");
   g_gpulib_libc.popen = dlsym(NULL, "popen");
+  g_gpulib_libc.pthread_create = dlsym(NULL, "pthread_create");
+  g_gpulib_libc.pthread_join = dlsym(NULL, "pthread_join");
   g_gpulib_libc.readlink = dlsym(NULL, "readlink");
   g_gpulib_libc.realloc = dlsym(NULL, "realloc");
   g_gpulib_libc.setlocale = dlsym(NULL, "setlocale");
@@ -497,11 +893,44 @@ static inline void GpuSysX11Window(
     XSetLocaleModifiers("@im=none");
   profE("Set locale");
 
+#ifdef GPULIB_THREADS
+  profB("XInitThreads");
+  XInitThreads();
+  profE("XInitThreads");
+#endif
+
   profB("XOpenDisplay");
   Display * dpy = XOpenDisplay(NULL);
   profE("XOpenDisplay");
   assert(dpy != NULL);
 
+  {
+    char * atom_names[] = {
+      "UTF8_STRING",
+      "_MOTIF_WM_HINTS",
+      "WM_DELETE_WINDOW",
+      "CLIPBOARD",
+      "TARGETS",
+      "TEXT",
+      "INCR",
+      "XSEL_DATA"
+    };
+    Atom atoms[sizeof(atom_names) / sizeof(atom_names[0])] = {0};
+    profB("XInternAtoms");
+    XInternAtoms(dpy, atom_names, sizeof(atom_names) / sizeof(atom_names[0]), 0, atoms);
+    profE("XInternAtoms");
+    g_gpulib_x11.utf8_string      = atoms[0];
+    g_gpulib_x11.motif_wm_hints   = atoms[1];
+    g_gpulib_x11.wm_delete_window = atoms[2];
+    g_gpulib_x11.clipboard        = atoms[3];
+    g_gpulib_x11.targets          = atoms[4];
+    g_gpulib_x11.text             = atoms[5];
+    g_gpulib_x11.incr             = atoms[6];
+    g_gpulib_x11.xsel_data        = atoms[7];
+    g_gpulib_x11.width            = w;
+    g_gpulib_x11.height           = h;
+  }
+
   GLXFBConfig fbconfig = 0;
   XVisualInfo * visual = NULL;
   {
@@ -569,6 +998,7 @@ static inline void GpuSysX11Window(
     win_attrs.event_mask        =
         ExposureMask
       | StructureNotifyMask
+      | FocusChangeMask
       | KeyPressMask
       | KeyReleaseMask
       | ButtonPressMask
@@ -600,7 +1030,7 @@ static inline void GpuSysX11Window(
   {
     XTextProperty win_title = {0};
     win_title.value    = (unsigned char *)title;
-    win_title.encoding = XInternAtom(dpy, "UTF8_STRING", 1);
+    win_title.encoding = g_gpulib_x11.utf8_string;
     win_title.format   = 8;
     win_title.nitems   = title_bytes;
     XSizeHints hints = {0};
@@ -618,9 +1048,7 @@ static inline void GpuSysX11Window(
   }
 
   {
-    profB("XInternAtom _MOTIF_WM_HINTS");
-    Atom MOTIF_WM_HINTS = XInternAtom(dpy, "_MOTIF_WM_HINTS", 0);
-    profE("XInternAtom _MOTIF_WM_HINTS");
+    Atom MOTIF_WM_HINTS = g_gpulib_x11.motif_wm_hints;
     struct MWMHints hints = {0};
     hints.flags       = MWM_HINTS_FUNCTIONS | MWM_HINTS_DECORATIONS;
     hints.functions   = MWM_FUNC_ALL;
@@ -651,6 +1079,8 @@ static inline void GpuSysX11Window(
     glx_ctx = glXCreateContextAttribsARB(dpy, fbconfig, 0, 1, attribs);
     profE("glXCreateContextAttribsARB");
     assert(glx_ctx != NULL);
+    g_gpulib_x11.fbconfig = fbconfig;
+    g_gpulib_x11.glx_ctx  = glx_ctx;
   }
 
   {
@@ -661,9 +1091,7 @@ static inline void GpuSysX11Window(
   }
 
   {
-    profB("XInternAtom WM_DELETE_WINDOW");
-    Atom delete_win_atom = XInternAtom(dpy, "WM_DELETE_WINDOW", 0);
-    profE("XInternAtom WM_DELETE_WINDOW");
+    Atom delete_win_atom = g_gpulib_x11.wm_delete_window;
     assert(delete_win_atom != None);
     profB("XSetWMProtocols");
     XSetWMProtocols(dpy, win, &delete_win_atom, 1);
@@ -744,6 +1172,8 @@ static inline void GpuWindow(
   profB("OpenGL state setup");
   {
     glViewport(0, 0, window_width, window_height);
+    g_gpulib_state.viewport[2] = window_width;
+    g_gpulib_state.viewport[3] = window_height;
 #ifndef RELEASE
     glEnable(0x92E0); // GL_DEBUG_OUTPUT
     glEnable(0x8242); // GL_DEBUG_OUTPUT_SYNCHRONOUS
@@ -771,21 +1201,31 @@ static inline void GpuWindow(
   }
   profE("OpenGL state setup");
 
-  if (out_scancodes != NULL) {
+  {
     profB("Scancode caching");
     XkbDescPtr xkbdesc = XkbGetMap(dpy, 0, XkbUseCoreKbd);
     XkbGetNames(dpy, XkbKeyNamesMask, xkbdesc);
     for (int i = xkbdesc->min_key_code; i <= xkbdesc->max_key_code; i += 1) {
       char * name = xkbdesc->names->keys[i].name;
-      out_scancodes[i * 5 + 0] = name[0];
-      out_scancodes[i * 5 + 1] = name[1];
-      out_scancodes[i * 5 + 2] = name[2];
-      out_scancodes[i * 5 + 3] = name[3];
-      out_scancodes[i * 5 + 4] = 0;
+      if (out_scancodes != NULL) {
+        out_scancodes[i * 5 + 0] = name[0];
+        out_scancodes[i * 5 + 1] = name[1];
+        out_scancodes[i * 5 + 2] = name[2];
+        out_scancodes[i * 5 + 3] = name[3];
+        out_scancodes[i * 5 + 4] = 0;
+      }
+      for (int key = gpu_key_none_e + 1; key < gpu_key_count_e; key += 1) {
+        if (nstreq(4, name, g_gpulib_key_names[key])) {
+          g_gpulib_keys.map[i] = (unsigned char)key;
+          g_gpulib_keys.keycodes[key] = (unsigned char)i;
+          break;
+        }
+      }
     }
     XkbFreeNames(xkbdesc, XkbKeyNamesMask, 1);
     XkbFreeClientMap(xkbdesc, 0, 1);
     XFree(xkbdesc);
+    XkbSetDetectableAutoRepeat(dpy, 1, NULL);
     profE("Scancode caching");
   }
 
@@ -794,6 +1234,61 @@ static inline void GpuWindow(
   profE(__func__);
 }
 
+static inline void GpuEvent(XEvent * event) {
+  switch (event->type) {
+    break; case KeyPress: {
+      int key = g_gpulib_keys.map[event->xkey.keycode & 255];
+      if (key == gpu_key_none_e)
+        break;
+      unsigned long bit = 1UL << (key & 63);
+      if ((g_gpulib_keys.down[key >> 6] & bit) == 0)
+        g_gpulib_keys.pressed[key >> 6] |= bit;
+      g_gpulib_keys.down[key >> 6] |= bit;
+    }
+    break; case KeyRelease: {
+      int key = g_gpulib_keys.map[event->xkey.keycode & 255];
+      if (key == gpu_key_none_e)
+        break;
+      unsigned long bit = 1UL << (key & 63);
+      if ((g_gpulib_keys.down[key >> 6] & bit) != 0)
+        g_gpulib_keys.released[key >> 6] |= bit;
+      g_gpulib_keys.down[key >> 6] &= ~bit;
+    }
+    break; case ConfigureNotify: {
+      g_gpulib_x11.width  = event->xconfigure.width;
+      g_gpulib_x11.height = event->xconfigure.height;
+    }
+    break; case FocusIn: {
+      g_gpulib_x11.focused = 1;
+    }
+    break; case FocusOut: {
+      g_gpulib_x11.focused = 0;
+      g_gpulib_keys.released[0] |= g_gpulib_keys.down[0];
+      g_gpulib_keys.released[1] |= g_gpulib_keys.down[1];
+      g_gpulib_keys.down[0] = 0;
+      g_gpulib_keys.down[1] = 0;
+    }
+    break; case MapNotify: {
+      g_gpulib_x11.mapped = 1;
+    }
+    break; case UnmapNotify: {
+      g_gpulib_x11.mapped = 0;
+    }
+  }
+}
+
+static inline int GpuKeyDown(enum gpu_key_e key)     { return (g_gpulib_keys.down[key >> 6]     >> (key & 63)) & 1; }
+static inline int GpuKeyPressed(enum gpu_key_e key)  { return (g_gpulib_keys.pressed[key >> 6]  >> (key & 63)) & 1; }
+static inline int GpuKeyReleased(enum gpu_key_e key) { return (g_gpulib_keys.released[key >> 6] >> (key & 63)) & 1; }
+static inline int GpuKeyToKeycode(enum gpu_key_e key) { return g_gpulib_keys.keycodes[key]; }
+
+static inline void GpuKeyFrame() {
+  g_gpulib_keys.pressed[0]  = 0;
+  g_gpulib_keys.pressed[1]  = 0;
+  g_gpulib_keys.released[0] = 0;
+  g_gpulib_keys.released[1] = 0;
+}
+
 static inline void * GpuMalloc(ptrdiff_t bytes, unsigned * out_buf_id) {
   profB(__func__);
   unsigned buf_id = 0;
@@ -813,6 +1308,17 @@ static inline void * GpuCalloc(ptrdiff_t bytes, unsigned * out_buf_id) {
   return buf_ptr;
 }
 
+static inline void * GpuMallocRead(ptrdiff_t bytes, unsigned * out_buf_id) {
+  profB(__func__);
+  unsigned buf_id = 0;
+  glCreateBuffers(1, &buf_id);
+  out_buf_id[0] = buf_id;
+  glNamedBufferStorage(buf_id, bytes, NULL, 0xC1); // GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+  void * buf_ptr = glMapNamedBufferRange(buf_id, 0, bytes, 0xC1);
+  profE(__func__);
+  return buf_ptr;
+}
+
 static inline unsigned GpuCast(unsigned buf_id, enum gpu_buf_format_e format, ptrdiff_t bytes_first, ptrdiff_t bytes_count) {
   profB(__func__);
   unsigned tex_id = 0;
@@ -843,6 +1349,28 @@ static inline unsigned * GpuCallocIndices(ptrdiff_t count, unsigned * out_idb_id
   return idb_ptr;
 }
 
+// For meshes of up to 65536 vertices, bind with gpu_u16_e
+static inline unsigned short * GpuMallocIndices16(ptrdiff_t count, unsigned * out_idb_id) {
+  profB(__func__);
+  unsigned idb_id = 0;
+  glGenBuffers(1, &idb_id);
+  out_idb_id[0] = idb_id;
+  glBindBuffer(0x8893, idb_id); // GL_ELEMENT_ARRAY_BUFFER
+  glBufferStorage(0x8893, count * sizeof(unsigned short), NULL, 0xC2); // GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+  unsigned short * idb_ptr = glMapBufferRange(0x8893, 0, count * sizeof(unsigned short), 0xC2);
+  glBindBuffer(0x8893, 0);
+  profE(__func__);
+  return idb_ptr;
+}
+
+static inline unsigned short * GpuCallocIndices16(ptrdiff_t count, unsigned * out_idb_id) {
+  profB(__func__);
+  unsigned short * idb_ptr = GpuMallocIndices16(count, out_idb_id);
+  memset(idb_ptr, 0, count * sizeof(unsigned short));
+  profE(__func__);
+  return idb_ptr;
+}
+
 static inline struct gpu_cmd_t * GpuMallocCommands(ptrdiff_t count, unsigned * out_dib_id) {
   profB(__func__);
   unsigned dib_id = 0;
@@ -909,6 +1437,10 @@ static inline unsigned GpuCallocImg(enum gpu_tex_format_e format, int width, int
     break; case 0x8C41: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x1907, 0x1400, (unsigned char [3]){0, 0, 0}); }    // GL_SRGB8, GL_RGB, GL_BYTE
     break; case 0x8C43: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x1908, 0x1400, (unsigned char [4]){0, 0, 0, 0}); } // GL_SRGB8_ALPHA8, GL_RGBA, GL_BYTE
     break; case 0x8814: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x1908, 0x1406, (float [4]){0, 0, 0, 0}); }         // GL_RGBA32F, GL_RGBA, GL_FLOAT
+    break; case 0x822E: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x1903, 0x1406, (float [1]){0}); }                  // GL_R32F, GL_RED, GL_FLOAT
+    break; case 0x8235: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x8D94, 0x1404, (int [1]){0}); }                    // GL_R32I, GL_RED_INTEGER, GL_INT
+    break; case 0x8236: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x8D94, 0x1405, (unsigned [1]){0}); }               // GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT
+    break; case 0x823C: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count, 0x8228, 0x1405, (unsigned [2]){0, 0}); }            // GL_RG32UI, GL_RG_INTEGER, GL_UNSIGNED_INT
     break; case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
            case 0x83F1: // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
            case 0x83F2: // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
@@ -934,6 +1466,10 @@ static inline unsigned GpuCallocCbm(enum gpu_tex_format_e format, int width, int
     break; case 0x8C41: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x1907, 0x1400, (unsigned char [3]){0, 0, 0}); }    // GL_SRGB8, GL_RGB, GL_BYTE
     break; case 0x8C43: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x1908, 0x1400, (unsigned char [4]){0, 0, 0, 0}); } // GL_SRGB8_ALPHA8, GL_RGBA, GL_BYTE
     break; case 0x8814: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x1908, 0x1406, (float [4]){0, 0, 0, 0}); }         // GL_RGBA32F, GL_RGBA, GL_FLOAT
+    break; case 0x822E: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x1903, 0x1406, (float [1]){0}); }                  // GL_R32F, GL_RED, GL_FLOAT
+    break; case 0x8235: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x8D94, 0x1404, (int [1]){0}); }                    // GL_R32I, GL_RED_INTEGER, GL_INT
+    break; case 0x8236: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x8D94, 0x1405, (unsigned [1]){0}); }               // GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT
+    break; case 0x823C: { for (int i = 0; i < mipmap_count; i += 1) glClearTexSubImage(tex_id, i, 0, 0, 0, width / (1 << i), height / (1 << i), layer_count * 6, 0x8228, 0x1405, (unsigned [2]){0, 0}); }            // GL_RG32UI, GL_RG_INTEGER, GL_UNSIGNED_INT
     break; case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
            case 0x83F1: // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
            case 0x83F2: // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
@@ -959,6 +1495,10 @@ static inline unsigned GpuCallocMsi(enum gpu_tex_format_e format, int width, int
     break; case 0x8C41: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x1907, 0x1400, (unsigned char [3]){0, 0, 0}); }    // GL_SRGB8, GL_RGB, GL_BYTE
     break; case 0x8C43: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x1908, 0x1400, (unsigned char [4]){0, 0, 0, 0}); } // GL_SRGB8_ALPHA8, GL_RGBA, GL_BYTE
     break; case 0x8814: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x1908, 0x1406, (float [4]){0, 0, 0, 0}); }         // GL_RGBA32F, GL_RGBA, GL_FLOAT
+    break; case 0x822E: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x1903, 0x1406, (float [1]){0}); }                  // GL_R32F, GL_RED, GL_FLOAT
+    break; case 0x8235: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x8D94, 0x1404, (int [1]){0}); }                    // GL_R32I, GL_RED_INTEGER, GL_INT
+    break; case 0x8236: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x8D94, 0x1405, (unsigned [1]){0}); }               // GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT
+    break; case 0x823C: { glClearTexSubImage(tex_id, 0, 0, 0, 0, width, height, layer_count, 0x8228, 0x1405, (unsigned [2]){0, 0}); }            // GL_RG32UI, GL_RG_INTEGER, GL_UNSIGNED_INT
     break; case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
            case 0x83F1: // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
            case 0x83F2: // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
@@ -1016,6 +1556,18 @@ static inline void GpuGet(
   profE(__func__);
 }
 
+static inline void GpuGetAsync(
+    unsigned tex_id, int layer, int x, int y, int width, int height, int count, int mipmap_level,
+    enum gpu_pix_format_e pixel_format, enum gpu_pix_type_e pixel_type, unsigned pixels_bytes,
+    unsigned read_buf_id, ptrdiff_t read_buf_bytes_first)
+{
+  profB(__func__);
+  glBindBuffer(0x88EB, read_buf_id); // GL_PIXEL_PACK_BUFFER
+  glGetTextureSubImage(tex_id, mipmap_level, x, y, layer, width, height, count, pixel_format, pixel_type, pixels_bytes, (void *)read_buf_bytes_first);
+  glBindBuffer(0x88EB, 0);
+  profE(__func__);
+}
+
 static inline void GpuSet(
     unsigned tex_id, int layer, int x, int y, int width, int height, int count, int mipmap_level,
     enum gpu_pix_format_e pixel_format, enum gpu_pix_type_e pixel_type, void * pixels)
@@ -1052,15 +1604,48 @@ static inline void GpuSetCpi(
   profE(__func__);
 }
 
+// The client layout drivers store a format in, uploads in it are a memcpy instead of a per-texel CPU repack.
+// 8-bit color is stored as 4 bytes even without alpha, RGB formats as RGBX and RGBA formats as BGRA.
+// Compressed formats return 0 and go through GpuSetCpi. examples/19_Upload_Benchmark measures every layout.
+static inline void GpuPixLayout(enum gpu_tex_format_e format, enum gpu_pix_format_e * out_pixel_format, enum gpu_pix_type_e * out_pixel_type) {
+  profB(__func__);
+  enum gpu_pix_format_e pixel_format = 0;
+  enum gpu_pix_type_e pixel_type = 0;
+  switch (format) {
+    break; case gpu_d_f32_e:    pixel_format = gpu_d_e;    pixel_type = gpu_f32_e;
+    break; case gpu_rgb_b8_e:
+           case gpu_srgb_b8_e:  pixel_format = gpu_rgba_e; pixel_type = gpu_u8888_rev_e;
+    break; case gpu_rgba_b8_e:
+           case gpu_srgba_b8_e: pixel_format = gpu_bgra_e; pixel_type = gpu_u8888_rev_e;
+    break; case gpu_rgba_f32_e: pixel_format = gpu_rgba_e; pixel_type = gpu_f32_e;
+    break; case gpu_r_f32_e:    pixel_format = gpu_r_e;    pixel_type = gpu_f32_e;
+    break; case gpu_r_i32_e:    pixel_format = gpu_ri_e;   pixel_type = gpu_i32_e;
+    break; case gpu_r_u32_e:    pixel_format = gpu_ri_e;   pixel_type = gpu_u32_e;
+    break; case gpu_rg_u32_e:   pixel_format = gpu_rgi_e;  pixel_type = gpu_u32_e;
+    break; case gpu_rgb_s3tc_dxt1_b8_e:
+           case gpu_rgba_s3tc_dxt1_b8_e:
+           case gpu_rgba_s3tc_dxt3_b8_e:
+           case gpu_rgba_s3tc_dxt5_b8_e:
+           case gpu_srgb_s3tc_dxt1_b8_e:
+           case gpu_srgba_s3tc_dxt1_b8_e:
+           case gpu_srgba_s3tc_dxt3_b8_e:
+           case gpu_srgba_s3tc_dxt5_b8_e: {}
+  }
+  out_pixel_format[0] = pixel_format;
+  out_pixel_type[0] = pixel_type;
+  profE(__func__);
+}
+
 static inline int GpuLoadRgbImgBinary(unsigned tex_id, int width, int height, int layer_count, char * img_binary_filepath) {
   profB(__func__);
   int fd = open(img_binary_filepath, O_RDONLY);
-  if (fd == 0) {
+  if (fd < 0) {
     profE(__func__);
     return 1;
   }
   char * p = mmap(0, (width * height * 3) * layer_count, PROT_READ, MAP_PRIVATE, fd, 0);
-  if (p == NULL) {
+  if (p == MAP_FAILED) {
+    close(fd);
     profE(__func__);
     return 1;
   }
@@ -1079,12 +1664,13 @@ static inline int GpuLoadRgbImgBinary(unsigned tex_id, int width, int height, in
 static inline int GpuLoadRgbCbmBinary(unsigned tex_id, int width, int height, int layer_count, char * cbm_binary_filepath) {
   profB(__func__);
   int fd = open(cbm_binary_filepath, O_RDONLY);
-  if (fd == 0) {
+  if (fd < 0) {
     profE(__func__);
     return 1;
   }
   char * p = mmap(0, (width * height * 3) * (layer_count * 6), PROT_READ, MAP_PRIVATE, fd, 0);
-  if (p == NULL) {
+  if (p == MAP_FAILED) {
+    close(fd);
     profE(__func__);
     return 1;
   }
@@ -1100,6 +1686,224 @@ static inline int GpuLoadRgbCbmBinary(unsigned tex_id, int width, int height, in
   return 0;
 }
 
+// Creates the image or cubemap described by the file and uploads every subresource straight from the mapping,
+// without conversions or mipmap generation. Returns 0 on failure.
+static inline unsigned GpuLoadImgFile(char * img_filepath, struct gpu_img_file_t * out_header) {
+  profB(__func__);
+  int fd = open(img_filepath, O_RDONLY);
+  if (fd < 0) {
+    profE(__func__);
+    return 0;
+  }
+  // Sizes and offsets are checked against the file before any read, mapped pages past its end fault
+  unsigned long fd_bytes = (unsigned long)lseek(fd, 0, 2); // SEEK_END
+  struct gpu_img_file_t * header = fd_bytes >= sizeof(struct gpu_img_file_t) ? mmap(0, sizeof(struct gpu_img_file_t), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  if (header == MAP_FAILED) {
+    close(fd);
+    profE(__func__);
+    return 0;
+  }
+  unsigned long file_bytes = header->file_bytes;
+  int valid = header->magic == GPULIB_IMG_FILE_MAGIC && header->version == GPULIB_IMG_FILE_VERSION && (header->face_count == 1 || header->face_count == 6) &&
+              header->width > 0 && header->height > 0 && header->layer_count > 0 && header->mipmap_count > 0 && header->mipmap_count <= 32 &&
+              file_bytes == fd_bytes;
+  unsigned long sub_count = valid ? (unsigned long)header->mipmap_count * header->layer_count * header->face_count : 0;
+  valid = valid && sub_count <= (file_bytes - sizeof(struct gpu_img_file_t)) / sizeof(struct gpu_img_file_sub_t);
+  munmap(header, sizeof(struct gpu_img_file_t));
+  char * p = valid ? mmap(0, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (p == MAP_FAILED) {
+    profE(__func__);
+    return 0;
+  }
+  header = (struct gpu_img_file_t *)p;
+  struct gpu_img_file_sub_t * subs = (struct gpu_img_file_sub_t *)(header + 1);
+  for (unsigned long s = 0; s < sub_count; s += 1) {
+    if (subs[s].bytes_first > file_bytes || subs[s].bytes_count > file_bytes - subs[s].bytes_first) {
+      munmap(p, file_bytes);
+      profE(__func__);
+      return 0;
+    }
+  }
+  unsigned tex_id = header->face_count == 6 ?
+      GpuMallocCbm(header->format, header->width, header->height, header->layer_count, header->mipmap_count) :
+      GpuMallocImg(header->format, header->width, header->height, header->layer_count, header->mipmap_count);
+  glPixelStorei(0x0CF5, 1); // GL_UNPACK_ALIGNMENT
+  for (int m = 0, s = 0; m < header->mipmap_count; m += 1) {
+    int w = header->width  >> m > 1 ? header->width  >> m : 1;
+    int h = header->height >> m > 1 ? header->height >> m : 1;
+    for (int l = 0; l < header->layer_count * header->face_count; l += 1, s += 1) {
+      if (header->pixel_format == 0)
+        GpuSetCpi(tex_id, l, 0, 0, w, h, 1, m, header->format, subs[s].bytes_count, p + subs[s].bytes_first);
+      else
+        GpuSet(tex_id, l, 0, 0, w, h, 1, m, header->pixel_format, header->pixel_type, p + subs[s].bytes_first);
+    }
+  }
+  glPixelStorei(0x0CF5, 4);
+  if (out_header != NULL)
+    out_header[0] = header[0];
+  munmap(p, file_bytes);
+  profE(__func__);
+  return tex_id;
+}
+
+// Maps the pack once and creates one buffer per stream straight from the mapping, vertex streams get a texture buffer
+// view and the commands an indirect buffer. The command table, names, clusters and levels of detail stay in out_mesh.
+// Returns 0 on failure.
+static inline int GpuLoadMeshFile(char * mesh_filepath, unsigned buf_flags, unsigned dib_flags, struct gpu_mesh_t * out_mesh) {
+  profB(__func__);
+  int fd = open(mesh_filepath, O_RDONLY);
+  if (fd < 0) {
+    profE(__func__);
+    return 0;
+  }
+  // Sizes and offsets are checked against the file before any read, mapped pages past its end fault
+  unsigned long fd_bytes = (unsigned long)lseek(fd, 0, 2); // SEEK_END
+  struct gpu_mesh_file_t * header = fd_bytes >= sizeof(struct gpu_mesh_file_t) ? mmap(0, sizeof(struct gpu_mesh_file_t), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  if (header == MAP_FAILED) {
+    close(fd);
+    profE(__func__);
+    return 0;
+  }
+  unsigned long file_bytes = header->file_bytes;
+  unsigned long table_bytes = sizeof(struct gpu_mesh_file_t) +
+      header->stream_count  * (unsigned long)sizeof(struct gpu_mesh_file_stream_t) +
+      header->cmd_count     * (unsigned long)(sizeof(struct gpu_cmd_t) + GPULIB_MESH_FILE_NAME_BYTES) +
+      header->cluster_count * (unsigned long)sizeof(struct gpu_mesh_cluster_t) +
+      header->lod_count     * (unsigned long)sizeof(struct gpu_mesh_lod_t);
+  int valid = header->magic == GPULIB_MESH_FILE_MAGIC && header->version == GPULIB_MESH_FILE_VERSION && header->stream_count <= GPULIB_MAX_MESH_STREAMS &&
+              file_bytes == fd_bytes && table_bytes <= file_bytes;
+  munmap(header, sizeof(struct gpu_mesh_file_t));
+  char * p = valid ? mmap(0, file_bytes, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (p == MAP_FAILED) {
+    profE(__func__);
+    return 0;
+  }
+  header = (struct gpu_mesh_file_t *)p;
+  struct gpu_mesh_file_stream_t * streams = (struct gpu_mesh_file_stream_t *)(header + 1);
+  for (unsigned i = 0; i < header->stream_count; i += 1) {
+    if (streams[i].bytes_first > file_bytes || streams[i].bytes_count > file_bytes - streams[i].bytes_first) {
+      munmap(p, file_bytes);
+      profE(__func__);
+      return 0;
+    }
+  }
+  struct gpu_cmd_t * cmds = (struct gpu_cmd_t *)(streams + header->stream_count);
+  char (* cmd_names)[GPULIB_MESH_FILE_NAME_BYTES] = (void *)(cmds + header->cmd_count);
+  struct gpu_mesh_cluster_t * clusters = (void *)(cmd_names + header->cmd_count);
+  struct gpu_mesh_lod_t * lods = (struct gpu_mesh_lod_t *)(clusters + header->cluster_count);
+  struct gpu_mesh_t mesh = {.vertex_count = header->vertex_count, .index_type = header->index_type, .stream_count = header->stream_count, .cmd_count = header->cmd_count, .cluster_count = header->cluster_count, .lod_count = header->lod_count};
+  memcpy(mesh.aabb_min, header->aabb_min, sizeof(mesh.aabb_min));
+  memcpy(mesh.aabb_max, header->aabb_max, sizeof(mesh.aabb_max));
+  for (int i = 0; i < mesh.stream_count; i += 1) {
+    memcpy(mesh.stream_names[i], streams[i].name, GPULIB_MESH_FILE_NAME_BYTES);
+    glCreateBuffers(1, &mesh.bufs[i]);
+    glNamedBufferStorage(mesh.bufs[i], streams[i].bytes_count, p + streams[i].bytes_first, buf_flags);
+    if (streams[i].format == 0)
+      mesh.idb = mesh.bufs[i];
+    else
+      mesh.texs[i] = GpuCast(mesh.bufs[i], streams[i].format, 0, streams[i].bytes_count);
+  }
+  glCreateBuffers(1, &mesh.dib);
+  glNamedBufferStorage(mesh.dib, mesh.cmd_count * sizeof(struct gpu_cmd_t), cmds, dib_flags);
+  mesh.cmds = g_gpulib_libc.calloc(mesh.cmd_count, sizeof(struct gpu_cmd_t));
+  mesh.cmd_names = g_gpulib_libc.calloc(mesh.cmd_count, GPULIB_MESH_FILE_NAME_BYTES);
+  memcpy(mesh.cmds, cmds, mesh.cmd_count * sizeof(struct gpu_cmd_t));
+  memcpy(mesh.cmd_names, cmd_names, mesh.cmd_count * GPULIB_MESH_FILE_NAME_BYTES);
+  mesh.clusters = g_gpulib_libc.calloc(mesh.cluster_count + 1, sizeof(struct gpu_mesh_cluster_t));
+  memcpy(mesh.clusters, clusters, mesh.cluster_count * sizeof(struct gpu_mesh_cluster_t));
+  mesh.lods = g_gpulib_libc.calloc(mesh.lod_count + 1, sizeof(struct gpu_mesh_lod_t));
+  memcpy(mesh.lods, lods, mesh.lod_count * sizeof(struct gpu_mesh_lod_t));
+  munmap(p, file_bytes);
+  out_mesh[0] = mesh;
+  profE(__func__);
+  return 1;
+}
+
+// Texture buffer view of a vertex stream, 0 if the pack has no stream with that name
+static inline unsigned GpuMeshTex(struct gpu_mesh_t * mesh, char * stream_name) {
+  profB(__func__);
+  unsigned tex_id = 0;
+  for (int i = 0; i < mesh->stream_count; i += 1)
+    if (g_gpulib_libc.strcmp(mesh->stream_names[i], stream_name) == 0)
+      tex_id = mesh->texs[i];
+  profE(__func__);
+  return tex_id;
+}
+
+// Command index for GpuDraw, -1 if the pack has no command with that name
+static inline int GpuMeshCmd(struct gpu_mesh_t * mesh, char * cmd_name) {
+  profB(__func__);
+  int cmd = -1;
+  for (int i = 0; i < mesh->cmd_count && cmd < 0; i += 1)
+    if (g_gpulib_libc.strcmp(mesh->cmd_names[i], cmd_name) == 0)
+      cmd = i;
+  profE(__func__);
+  return cmd;
+}
+
+// Writes one command per cluster of commands cmd_first..cmd_first + cmd_count - 1 that is inside every plane and not
+// back facing from camera_pos, both in mesh space. A point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0
+// with plane.xyz normalized. Commands keep the instance fields of their own command. Returns how many were written.
+static inline int GpuMeshCull(
+    struct gpu_mesh_t * mesh, int cmd_first, int cmd_count, float * camera_pos, int plane_count, float (* planes)[4],
+    struct gpu_cmd_t * out_cmds)
+{
+  profB(__func__);
+  int out_count = 0;
+  for (int i = 0; i < mesh->cluster_count; i += 1) {
+    struct gpu_mesh_cluster_t * cluster = &mesh->clusters[i];
+    if (cluster->cmd < (unsigned)cmd_first || cluster->cmd >= (unsigned)(cmd_first + cmd_count))
+      continue;
+    int visible = 1;
+    for (int p = 0; p < plane_count && visible; p += 1)
+      visible = planes[p][0] * cluster->center[0] + planes[p][1] * cluster->center[1] + planes[p][2] * cluster->center[2] + planes[p][3] >= -cluster->radius;
+    // Back facing when dot(v, cone_axis) >= cone_cutoff * length(v) + radius for v from the camera to the center
+    float v[3] = {cluster->center[0] - camera_pos[0], cluster->center[1] - camera_pos[1], cluster->center[2] - camera_pos[2]};
+    float d = v[0] * cluster->cone_axis[0] + v[1] * cluster->cone_axis[1] + v[2] * cluster->cone_axis[2] - cluster->radius;
+    if (visible && cluster->cone_cutoff < 1 && d >= 0 && d * d >= cluster->cone_cutoff * cluster->cone_cutoff * (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]))
+      visible = 0;
+    if (!visible)
+      continue;
+    struct gpu_cmd_t cmd = mesh->cmds[cluster->cmd];
+    cmd.first = cluster->first;
+    cmd.count = cluster->count;
+    out_cmds[out_count++] = cmd;
+  }
+  profE(__func__);
+  return out_count;
+}
+
+// Picks the coarsest level of cmd whose error covers at most max_error_pixels on screen for an unscaled instance drawn at
+// instance_pos, pixels_per_unit is how many pixels a mesh unit covers at a distance of 1. Writes cmd with the level's
+// first and count to out_cmd and returns the level.
+static inline int GpuMeshLod(
+    struct gpu_mesh_t * mesh, int cmd, float * camera_pos, float * instance_pos, float pixels_per_unit,
+    float max_error_pixels, struct gpu_cmd_t * out_cmd)
+{
+  profB(__func__);
+  float v[3] = {instance_pos[0] - camera_pos[0], instance_pos[1] - camera_pos[1], instance_pos[2] - camera_pos[2]};
+  float distance_squared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+  int level = 0;
+  out_cmd[0] = mesh->cmds[cmd];
+  for (int i = 0, l = 0; i < mesh->lod_count; i += 1) {
+    struct gpu_mesh_lod_t * lod = &mesh->lods[i];
+    if (lod->cmd != (unsigned)cmd)
+      continue;
+    // error * pixels_per_unit / distance <= max_error_pixels without a square root
+    float pixels = lod->error * pixels_per_unit;
+    if (pixels * pixels <= max_error_pixels * max_error_pixels * distance_squared) {
+      level = l;
+      out_cmd[0].first = lod->first;
+      out_cmd[0].count = lod->count;
+    }
+    l += 1;
+  }
+  profE(__func__);
+  return level;
+}
+
 static inline unsigned GpuSmp(
     int max_anisotropy, enum gpu_smp_filter_e min_filter, enum gpu_smp_filter_e mag_filter, enum gpu_smp_wrapping_e wrapping)
 {
@@ -1330,6 +2134,7 @@ static inline unsigned GpuXfb(
 static inline void GpuBindFbo(unsigned fbo_id) {
   profB(__func__);
   glBindFramebuffer(0x8D40, fbo_id); // GL_FRAMEBUFFER
+  g_gpulib_state.fbo = fbo_id;
   profE(__func__);
 }
 
@@ -1339,9 +2144,11 @@ static inline void GpuBindXfb(unsigned xfb_id) {
   profE(__func__);
 }
 
-static inline void GpuBindIndices(unsigned idb_id) {
+// index_type is gpu_u16_e or gpu_u32_e, GpuDraw and GpuDrawXfb read the indices as that type
+static inline void GpuBindIndices(unsigned idb_id, enum gpu_pix_type_e index_type) {
   profB(__func__);
   glBindBuffer(0x8893, idb_id); // GL_ELEMENT_ARRAY_BUFFER
+  g_gpulib_state.index_type = index_type;
   profE(__func__);
 }
 
@@ -1366,12 +2173,13 @@ static inline void GpuBindSamplers(int first, int count, unsigned * samplers) {
 static inline void GpuBindPpo(unsigned ppo) {
   profB(__func__);
   glBindProgramPipeline(ppo);
+  g_gpulib_state.ppo = ppo;
   profE(__func__);
 }
 
 static inline void GpuDraw(enum gpu_mode_e mode, unsigned binded_dib_cmd_first, unsigned binded_dib_cmd_count) {
   profB(__func__);
-  glMultiDrawElementsIndirect(mode, 0x1405, (void *)(binded_dib_cmd_first * 5 * sizeof(unsigned)), binded_dib_cmd_count, 0); // GL_UNSIGNED_INT
+  glMultiDrawElementsIndirect(mode, g_gpulib_state.index_type, (void *)(binded_dib_cmd_first * sizeof(struct gpu_cmd_t)), binded_dib_cmd_count, 0);
   profE(__func__);
 }
 
@@ -1379,7 +2187,7 @@ static inline void GpuDrawXfb(enum gpu_mode_e mode, unsigned binded_dib_cmd_firs
   profB(__func__);
   glEnable(0x8C89); // GL_RASTERIZER_DISCARD
   glBeginTransformFeedback(mode);
-  glMultiDrawElementsIndirect(mode, 0x1405, (void *)(binded_dib_cmd_first * 5 * sizeof(unsigned)), binded_dib_cmd_count, 0); // GL_UNSIGNED_INT
+  glMultiDrawElementsIndirect(mode, g_gpulib_state.index_type, (void *)(binded_dib_cmd_first * sizeof(struct gpu_cmd_t)), binded_dib_cmd_count, 0);
   glEndTransformFeedback();
   glDisable(0x8C89);
   profE(__func__);
@@ -1401,6 +2209,43 @@ static inline void GpuDrawOnceXfb(enum gpu_mode_e mode, unsigned first, unsigned
   profE(__func__);
 }
 
+// Draws as many vertices as the last GpuDrawXfb, GpuDrawOnceXfb or GpuXfbBegin..GpuXfbEnd captured into xfb_id, the count never leaves the GPU
+static inline void GpuDrawXfbResult(enum gpu_mode_e mode, unsigned xfb_id) {
+  profB(__func__);
+  glDrawTransformFeedback(mode, xfb_id);
+  profE(__func__);
+}
+
+// Append mode: every GpuDraw or GpuDrawOnce until GpuXfbEnd accumulates into the bound XFB object.
+// Between GpuXfbPause and GpuXfbResume draws rasterize normally and aren't captured.
+static inline void GpuXfbBegin(enum gpu_mode_e mode) {
+  profB(__func__);
+  glEnable(0x8C89); // GL_RASTERIZER_DISCARD
+  glBeginTransformFeedback(mode);
+  profE(__func__);
+}
+
+static inline void GpuXfbPause() {
+  profB(__func__);
+  glPauseTransformFeedback();
+  glDisable(0x8C89); // GL_RASTERIZER_DISCARD
+  profE(__func__);
+}
+
+static inline void GpuXfbResume() {
+  profB(__func__);
+  glEnable(0x8C89); // GL_RASTERIZER_DISCARD
+  glResumeTransformFeedback();
+  profE(__func__);
+}
+
+static inline void GpuXfbEnd() {
+  profB(__func__);
+  glEndTransformFeedback();
+  glDisable(0x8C89); // GL_RASTERIZER_DISCARD
+  profE(__func__);
+}
+
 static inline void GpuBlit(
     unsigned source_fbo_id, int source_color_id, int source_x, int source_y, int source_width, int source_height,
     unsigned target_fbo_id, int target_color_id, int target_x, int target_y, int target_width, int target_height)
@@ -1430,6 +2275,81 @@ static inline void GpuBlitToScreen(
   profE(__func__);
 }
 
+static inline void GpuCopyBuf(unsigned source_buf_id, ptrdiff_t source_bytes_first, unsigned target_buf_id, ptrdiff_t target_bytes_first, ptrdiff_t bytes_count) {
+  profB(__func__);
+  glCopyNamedBufferSubData(source_buf_id, target_buf_id, source_bytes_first, target_bytes_first, bytes_count);
+  profE(__func__);
+}
+
+static inline unsigned GpuSysTexTarget(unsigned tex_id) {
+  int target = 0;
+  glGetTextureParameteriv(tex_id, 0x1006, &target); // GL_TEXTURE_TARGET
+  return target;
+}
+
+// Works on images, cubemaps and their views. Cubemap layers are layer * 6 + face, compressed formats copy
+// whole blocks and may be copied to uncompressed formats of the same block size.
+static inline void GpuCopyImg(
+    unsigned source_tex_id, int source_mipmap_level, int source_x, int source_y, int source_layer,
+    unsigned target_tex_id, int target_mipmap_level, int target_x, int target_y, int target_layer,
+    int width, int height, int layer_count)
+{
+  profB(__func__);
+  glCopyImageSubData(
+      source_tex_id, GpuSysTexTarget(source_tex_id), source_mipmap_level, source_x, source_y, source_layer,
+      target_tex_id, GpuSysTexTarget(target_tex_id), target_mipmap_level, target_x, target_y, target_layer,
+      width, height, layer_count);
+  profE(__func__);
+}
+
+struct gpu_copy_buf_t {
+  unsigned source_buf_id;
+  ptrdiff_t source_bytes_first;
+  unsigned target_buf_id;
+  ptrdiff_t target_bytes_first;
+  ptrdiff_t bytes_count;
+};
+
+struct gpu_copy_img_t {
+  unsigned source_tex_id;
+  int source_mipmap_level, source_x, source_y, source_layer;
+  unsigned target_tex_id;
+  int target_mipmap_level, target_x, target_y, target_layer;
+  int width, height, layer_count;
+};
+
+static inline void GpuCopyBufs(int count, struct gpu_copy_buf_t * copies) {
+  profB(__func__);
+  for (int i = 0; i < count; i += 1)
+    glCopyNamedBufferSubData(copies[i].source_buf_id, copies[i].target_buf_id, copies[i].source_bytes_first, copies[i].target_bytes_first, copies[i].bytes_count);
+  profE(__func__);
+}
+
+// Texture targets are only queried when the source or target changes from the previous region
+static inline void GpuCopyImgs(int count, struct gpu_copy_img_t * copies) {
+  profB(__func__);
+  unsigned source_tex_id = 0;
+  unsigned target_tex_id = 0;
+  unsigned source_target = 0;
+  unsigned target_target = 0;
+  for (int i = 0; i < count; i += 1) {
+    struct gpu_copy_img_t * c = &copies[i];
+    if (c->source_tex_id != source_tex_id) {
+      source_tex_id = c->source_tex_id;
+      source_target = GpuSysTexTarget(source_tex_id);
+    }
+    if (c->target_tex_id != target_tex_id) {
+      target_tex_id = c->target_tex_id;
+      target_target = GpuSysTexTarget(target_tex_id);
+    }
+    glCopyImageSubData(
+        c->source_tex_id, source_target, c->source_mipmap_level, c->source_x, c->source_y, c->source_layer,
+        c->target_tex_id, target_target, c->target_mipmap_level, c->target_x, c->target_y, c->target_layer,
+        c->width, c->height, c->layer_count);
+  }
+  profE(__func__);
+}
+
 static inline void GpuClear() {
   profB(__func__);
   glClear(0x4100); // GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT
@@ -1442,11 +2362,32 @@ static inline void GpuFinish() {
   profE(__func__);
 }
 
+static inline void * GpuFence() {
+  profB(__func__);
+  void * fence = glFenceSync(0x9117, 0); // GL_SYNC_GPU_COMMANDS_COMPLETE
+  profE(__func__);
+  return fence;
+}
+
+static inline int GpuFenceWait(void * fence, unsigned long timeout_ns) {
+  profB(__func__);
+  unsigned status = glClientWaitSync(fence, 0x00000001, timeout_ns); // GL_SYNC_FLUSH_COMMANDS_BIT
+  profE(__func__);
+  return status == 0x911A || status == 0x911C; // GL_ALREADY_SIGNALED, GL_CONDITION_SATISFIED
+}
+
+static inline void GpuFenceFree(void * fence) {
+  profB(__func__);
+  glDeleteSync(fence);
+  profE(__func__);
+}
+
 static inline void GpuSwap(Display * dpy, Window win) {
   profB(__func__);
   glXSwapBuffers(dpy, win);
   profE(__func__);
   GpuFinish();
+  GpuKeyFrame();
 }
 
 static inline void GpuEnable(unsigned flags) {
@@ -1464,9 +2405,207 @@ static inline void GpuDisable(unsigned flags) {
 static inline void GpuViewport(int x, int y, int width, int height) {
   profB(__func__);
   glViewport(x, y, width, height);
+  g_gpulib_state.viewport[0] = x;
+  g_gpulib_state.viewport[1] = y;
+  g_gpulib_state.viewport[2] = width;
+  g_gpulib_state.viewport[3] = height;
+  profE(__func__);
+}
+
+static inline unsigned GpuKernelVert() {
+  if (g_gpulib_kernel.vert == 0) {
+    g_gpulib_kernel.vert = GpuVert(GPU_VERT_HEAD
+        "const vec2 g_tri[] = vec2[]("                    "\n"
+        "  vec2(-1,-1),"                                  "\n"
+        "  vec2(-1, 3),"                                  "\n"
+        "  vec2( 3,-1)"                                   "\n"
+        ");"                                              "\n"
+        ""                                                "\n"
+        "void main() {"                                   "\n"
+        "  gl_Position = vec4(g_tri[gl_VertexID], 0, 1);" "\n"
+        "}"                                               "\n");
+  }
+  return g_gpulib_kernel.vert;
+}
+
+static inline unsigned GpuKernel(char * frag_string, unsigned * out_frag_id) {
+  profB(__func__);
+  unsigned frag = GpuFrag(frag_string);
+  unsigned ppo = GpuPpo(GpuKernelVert(), frag);
+  if (out_frag_id != NULL)
+    out_frag_id[0] = frag;
+  profE(__func__);
+  return ppo;
+}
+
+static inline void GpuSysKernelFboFree(struct gpu_sys_kernel_fbo_t * e) {
+  // Deleting the bound FBO binds 0, so the tracked state follows
+  if (g_gpulib_state.fbo == e->fbo)
+    g_gpulib_state.fbo = 0;
+  glDeleteFramebuffers(1, &e->fbo);
+  memset(e, 0, sizeof(struct gpu_sys_kernel_fbo_t));
+}
+
+// Cached FBO of up to 4 color targets, misses take a free slot or evict the least recently used one
+static inline unsigned GpuKernelFbo(
+    unsigned color_tex_id_0, int color_tex_layer_0,
+    unsigned color_tex_id_1, int color_tex_layer_1,
+    unsigned color_tex_id_2, int color_tex_layer_2,
+    unsigned color_tex_id_3, int color_tex_layer_3)
+{
+  unsigned tex[4] = {color_tex_id_0, color_tex_id_1, color_tex_id_2, color_tex_id_3};
+  int layer[4] = {color_tex_layer_0, color_tex_layer_1, color_tex_layer_2, color_tex_layer_3};
+  unsigned hash = 2166136261u;
+  for (int i = 0; i < 4; i += 1) {
+    hash = (hash ^ tex[i]) * 16777619u;
+    hash = (hash ^ (unsigned)layer[i]) * 16777619u;
+  }
+  g_gpulib_kernel.tick += 1;
+  // Forgotten entries leave holes in the probe sequence, so a miss scans every slot
+  struct gpu_sys_kernel_fbo_t * free_entry = NULL;
+  struct gpu_sys_kernel_fbo_t * lru_entry = NULL;
+  for (int i = 0; i < GPULIB_MAX_KERNEL_FBOS; i += 1) {
+    struct gpu_sys_kernel_fbo_t * e = &g_gpulib_kernel.fbos[(hash + i) % GPULIB_MAX_KERNEL_FBOS];
+    if (e->fbo == 0) {
+      if (free_entry == NULL)
+        free_entry = e;
+      continue;
+    }
+    if (e->tex[0] == tex[0] && e->tex[1] == tex[1] && e->tex[2] == tex[2] && e->tex[3] == tex[3] &&
+        e->layer[0] == layer[0] && e->layer[1] == layer[1] && e->layer[2] == layer[2] && e->layer[3] == layer[3]) {
+      e->used = g_gpulib_kernel.tick;
+      return e->fbo;
+    }
+    if (lru_entry == NULL || e->used < lru_entry->used)
+      lru_entry = e;
+  }
+  struct gpu_sys_kernel_fbo_t * e = free_entry;
+  if (e == NULL) {
+    e = lru_entry;
+    GpuSysKernelFboFree(e);
+  }
+  for (int j = 0; j < 4; j += 1) {
+    e->tex[j]   = tex[j];
+    e->layer[j] = layer[j];
+  }
+  e->fbo = GpuFbo(tex[0], layer[0], tex[1], layer[1], tex[2], layer[2], tex[3], layer[3], 0, 0);
+  e->used = g_gpulib_kernel.tick;
+  return e->fbo;
+}
+
+// Deletes the cached FBOs that target tex_id, call it before deleting a texture GpuKernelRun rendered to so that a
+// texture reusing its name doesn't hit a stale FBO. tex_id 0 flushes the whole cache.
+static inline void GpuKernelFboForget(unsigned tex_id) {
+  profB(__func__);
+  for (int i = 0; i < GPULIB_MAX_KERNEL_FBOS; i += 1) {
+    struct gpu_sys_kernel_fbo_t * e = &g_gpulib_kernel.fbos[i];
+    if (e->fbo != 0 && (tex_id == 0 || e->tex[0] == tex_id || e->tex[1] == tex_id || e->tex[2] == tex_id || e->tex[3] == tex_id))
+      GpuSysKernelFboFree(e);
+  }
+  profE(__func__);
+}
+
+// Fixed-function state such as blending still applies to kernels
+static inline void GpuKernelRun(
+    unsigned ppo,
+    unsigned color_tex_id_0, int color_tex_layer_0,
+    unsigned color_tex_id_1, int color_tex_layer_1,
+    unsigned color_tex_id_2, int color_tex_layer_2,
+    unsigned color_tex_id_3, int color_tex_layer_3,
+    int textures_count, unsigned * textures, unsigned * samplers,
+    int x, int y, int width, int height)
+{
+  profB(__func__);
+  unsigned fbo = GpuKernelFbo(
+      color_tex_id_0, color_tex_layer_0,
+      color_tex_id_1, color_tex_layer_1,
+      color_tex_id_2, color_tex_layer_2,
+      color_tex_id_3, color_tex_layer_3);
+  if (g_gpulib_state.fbo != fbo)
+    GpuBindFbo(fbo);
+  if (g_gpulib_state.viewport[0] != x || g_gpulib_state.viewport[1] != y || g_gpulib_state.viewport[2] != width || g_gpulib_state.viewport[3] != height)
+    GpuViewport(x, y, width, height);
+  if (g_gpulib_state.ppo != ppo)
+    GpuBindPpo(ppo);
+  if (textures_count > 0)
+    GpuBindTextures(0, textures_count, textures);
+  if (textures_count > 0 && samplers != NULL)
+    GpuBindSamplers(0, textures_count, samplers);
+  GpuDrawOnce(gpu_triangles_e, 0, 3, 1);
+  profE(__func__);
+}
+
+struct gpu_pingpong_t {
+  unsigned img[2];
+  int current;
+  int width;
+  int height;
+  int mipmap_count;
+  unsigned read_buf;
+  float * read_ptr;
+  void * read_fence;
+};
+
+// With metric set, images get a full mipmap chain and GpuPingPongMetric can average the current image down to one texel
+static inline void GpuPingPong(struct gpu_pingpong_t * pingpong, enum gpu_tex_format_e format, int width, int height, int metric) {
+  profB(__func__);
+  int mipmap_count = metric ? ilog2(width > height ? width : height) + 1 : 1;
+  pingpong->img[0]       = GpuCallocImg(format, width, height, 1, mipmap_count);
+  pingpong->img[1]       = GpuCallocImg(format, width, height, 1, mipmap_count);
+  pingpong->current      = 0;
+  pingpong->width        = width;
+  pingpong->height       = height;
+  pingpong->mipmap_count = mipmap_count;
+  pingpong->read_buf     = 0;
+  pingpong->read_ptr     = metric ? GpuMallocRead(4 * sizeof(float), &pingpong->read_buf) : NULL;
+  pingpong->read_fence   = NULL;
+  profE(__func__);
+}
+
+static inline unsigned GpuPingPongImg(struct gpu_pingpong_t * pingpong) {
+  return pingpong->img[pingpong->current];
+}
+
+// Texture slot 0 is the previous iteration's image, textures[1..textures_count-1] and samplers are bound once
+static inline void GpuPingPongRun(struct gpu_pingpong_t * pingpong, unsigned ppo, int iterations, int textures_count, unsigned * textures, unsigned * samplers) {
+  profB(__func__);
+  if (textures_count > 1)
+    GpuBindTextures(1, textures_count - 1, textures + 1);
+  if (textures_count > 0 && samplers != NULL)
+    GpuBindSamplers(0, textures_count, samplers);
+  for (int i = 0; i < iterations; i += 1) {
+    unsigned source = pingpong->img[pingpong->current];
+    unsigned target = pingpong->img[pingpong->current ^ 1];
+    GpuBindTextures(0, 1, &source);
+    GpuKernelRun(ppo, target, 0, 0, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, 0, pingpong->width, pingpong->height);
+    pingpong->current ^= 1;
+  }
   profE(__func__);
 }
 
+// Queues a readback of the current image's average, GpuPingPongMetricReady polls for it without blocking
+static inline void GpuPingPongMetric(struct gpu_pingpong_t * pingpong) {
+  profB(__func__);
+  assert(pingpong->read_ptr != NULL);
+  if (pingpong->read_fence != NULL)
+    GpuFenceFree(pingpong->read_fence);
+  unsigned img = pingpong->img[pingpong->current];
+  glGenerateTextureMipmap(img);
+  GpuGetAsync(img, 0, 0, 0, 1, 1, 1, pingpong->mipmap_count - 1, gpu_rgba_e, gpu_f32_e, 4 * sizeof(float), pingpong->read_buf, 0);
+  pingpong->read_fence = GpuFence();
+  profE(__func__);
+}
+
+static inline int GpuPingPongMetricReady(struct gpu_pingpong_t * pingpong, float * out_metric) {
+  if (pingpong->read_fence == NULL || !GpuFenceWait(pingpong->read_fence, 0))
+    return 0;
+  GpuFenceFree(pingpong->read_fence);
+  pingpong->read_fence = NULL;
+  for (int i = 0; i < 4; i += 1)
+    out_metric[i] = pingpong->read_ptr[i];
+  return 1;
+}
+
 static inline void GpuSetDebugCallback(void * callback) {
   profB(__func__);
   glDebugMessageCallback(callback, NULL);
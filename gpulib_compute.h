@@ -0,0 +1,984 @@
+#pragma once
+
+#include "gpulib.h"
+
+#ifndef GPULIB_MAX_SHADER_BYTES
+#define GPULIB_MAX_SHADER_BYTES (16384)
+#endif
+
+enum gpu_reduce_op_e {
+  gpu_reduce_sum_e,
+  gpu_reduce_min_e,
+  gpu_reduce_max_e,
+  gpu_reduce_argmin_e,
+  gpu_reduce_argmax_e,
+};
+
+// TYPE 0, 1, 2 selects f32, i32, u32. Values travel between passes as uint bits next to their source index.
+#define GPU_COMPUTE_TYPE_HEAD                             \
+  "#if TYPE == 0"                                    "\n" \
+  "#define T float"                                  "\n" \
+  "#define T_DECODE(x) uintBitsToFloat(x)"           "\n" \
+  "#define T_ENCODE(x) floatBitsToUint(x)"           "\n" \
+  "#define T_BUF samplerBuffer"                      "\n" \
+  "#define T_IMG sampler2DArray"                     "\n" \
+  "#elif TYPE == 1"                                  "\n" \
+  "#define T int"                                    "\n" \
+  "#define T_DECODE(x) int(x)"                       "\n" \
+  "#define T_ENCODE(x) uint(x)"                      "\n" \
+  "#define T_BUF isamplerBuffer"                     "\n" \
+  "#define T_IMG isampler2DArray"                    "\n" \
+  "#else"                                            "\n" \
+  "#define T uint"                                   "\n" \
+  "#define T_DECODE(x) (x)"                          "\n" \
+  "#define T_ENCODE(x) (x)"                          "\n" \
+  "#define T_BUF usamplerBuffer"                     "\n" \
+  "#define T_IMG usampler2DArray"                    "\n" \
+  "#endif"                                           "\n" \
+  ""                                                 "\n"
+
+#define GPU_COMPUTE_REDUCE_HEAD                                                         \
+  "uvec2 Combine(uvec2 a, uvec2 b) {"                                              "\n" \
+  "  T va = T_DECODE(a.x);"                                                        "\n" \
+  "  T vb = T_DECODE(b.x);"                                                        "\n" \
+  "#if OP == 0"                                                                    "\n" \
+  "  return uvec2(T_ENCODE(va + vb), min(a.y, b.y));"                              "\n" \
+  "#elif OP == 1"                                                                  "\n" \
+  "  return (vb < va || (vb == va && b.y < a.y)) ? b : a;"                         "\n" \
+  "#else"                                                                          "\n" \
+  "  return (vb > va || (vb == va && b.y < a.y)) ? b : a;"                         "\n" \
+  "#endif"                                                                         "\n" \
+  "}"                                                                              "\n" \
+  ""                                                                               "\n"
+
+static inline int GpuSysComputeType(enum gpu_pix_type_e type) {
+  switch (type) {
+    break; case gpu_f32_e: return 0;
+    break; case gpu_i32_e: return 1;
+    break; case gpu_u32_e: return 2;
+    break; case gpu_i8_e:
+           case gpu_i16_e:
+           case gpu_u8_e:
+           case gpu_u16_e:
+           case gpu_u8888_rev_e: {
+             assert(!"Compute primitives only take gpu_f32_e, gpu_i32_e or gpu_u32_e");
+           }
+  }
+  return 0;
+}
+
+// (Re)allocates a GPU-only scratch buffer together with its texture buffer view and XFB object
+static inline void GpuSysComputeBuf(enum gpu_buf_format_e format, ptrdiff_t bytes, unsigned * buf, unsigned * tex, unsigned * xfb) {
+  if (buf[0] != 0) {
+    glDeleteTransformFeedbacks(1, xfb);
+    glDeleteTextures(1, tex);
+    glDeleteBuffers(1, buf);
+  }
+  glCreateBuffers(1, buf);
+  glNamedBufferStorage(buf[0], bytes, NULL, 0);
+  tex[0] = GpuCast(buf[0], format, 0, bytes);
+  xfb[0] = GpuXfb(buf[0], 0, bytes, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+}
+
+// Render state that raster passes change and put back afterwards
+struct gpu_sys_compute_state_t {
+  unsigned fbo;
+  int viewport[4];
+  unsigned char blend;
+  unsigned char depth_test;
+  int blend_func[4]; // src rgb, dst rgb, src alpha, dst alpha
+};
+
+static inline struct gpu_sys_compute_state_t GpuSysComputeSave() {
+  struct gpu_sys_compute_state_t state = {0};
+  state.fbo = g_gpulib_state.fbo;
+  for (int i = 0; i < 4; i += 1)
+    state.viewport[i] = g_gpulib_state.viewport[i];
+  state.blend = glIsEnabled(0x0BE2);      // GL_BLEND
+  state.depth_test = glIsEnabled(0x0B71); // GL_DEPTH_TEST
+  glGetIntegerv(0x80C9, &state.blend_func[0]); // GL_BLEND_SRC_RGB
+  glGetIntegerv(0x80C8, &state.blend_func[1]); // GL_BLEND_DST_RGB
+  glGetIntegerv(0x80CB, &state.blend_func[2]); // GL_BLEND_SRC_ALPHA
+  glGetIntegerv(0x80CA, &state.blend_func[3]); // GL_BLEND_DST_ALPHA
+  return state;
+}
+
+// Additive blending without depth testing, for counting with points
+static inline void GpuSysComputeBlendAdd() {
+  glEnable(0x0BE2);            // GL_BLEND
+  glBlendFunc(0x0001, 0x0001); // GL_ONE, GL_ONE
+  glDisable(0x0B71);           // GL_DEPTH_TEST
+}
+
+static inline void GpuSysComputeRestore(struct gpu_sys_compute_state_t * state) {
+  glBlendFuncSeparate(state->blend_func[0], state->blend_func[1], state->blend_func[2], state->blend_func[3]);
+  if (state->blend) glEnable(0x0BE2); else glDisable(0x0BE2);
+  if (state->depth_test) glEnable(0x0B71); else glDisable(0x0B71);
+  GpuBindFbo(state->fbo);
+  GpuViewport(state->viewport[0], state->viewport[1], state->viewport[2], state->viewport[3]);
+}
+
+struct gpu_reduce_t {
+  unsigned pro[2][2][3][3]; // [buf, img][first pass, next passes][sum, min, max][f32, i32, u32]
+  unsigned ppo[2][2][3][3];
+  unsigned buf[2];
+  unsigned buf_tex[2];
+  unsigned buf_xfb[2];
+  ptrdiff_t buf_count;
+  unsigned img[2];
+  unsigned img_fbo[2];
+  unsigned img_smp;
+  int img_width;
+  int img_height;
+  unsigned read_buf;
+  unsigned read_xfb;
+  unsigned * read_ptr;
+  void * fence;
+};
+
+static inline unsigned GpuSysReducePpo(struct gpu_reduce_t * reduce, int is_img, int is_first, int op, int type) {
+  unsigned * ppo = &reduce->ppo[is_img][is_first][op][type];
+  if (ppo[0] != 0)
+    return ppo[0];
+  char string[GPULIB_MAX_SHADER_BYTES] = {0};
+  if (is_img == 0) {
+    snprintf(string, sizeof(string), "%s#define OP %d\n#define TYPE %d\n#define FIRST %d\n%s%s%s", GPU_VERT_HEAD, op, type, is_first, GPU_COMPUTE_TYPE_HEAD, GPU_COMPUTE_REDUCE_HEAD,
+        "#if FIRST"                                                       "\n"
+        "layout(binding = 0) uniform T_BUF s_in;"                         "\n"
+        "uvec2 Load(int i) { return uvec2(T_ENCODE(texelFetch(s_in, i).x), uint(i)); }" "\n"
+        "#else"                                                           "\n"
+        "layout(binding = 0) uniform usamplerBuffer s_in;"                "\n"
+        "uvec2 Load(int i) { return texelFetch(s_in, i).xy; }"            "\n"
+        "#endif"                                                          "\n"
+        ""                                                                "\n"
+        "layout(location = 0) uniform int u_count;"                       "\n"
+        ""                                                                "\n"
+        "flat out uvec2 g_out;"                                           "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  int first = gl_VertexID * 64;"                                 "\n"
+        "  int last = min(first + 64, u_count);"                          "\n"
+        "  uvec2 r = Load(first);"                                        "\n"
+        "  for (int i = first + 1; i < last; i += 1)"                     "\n"
+        "    r = Combine(r, Load(i));"                                    "\n"
+        "  g_out = r;"                                                    "\n"
+        "}"                                                               "\n");
+    reduce->pro[is_img][is_first][op][type] = GpuVertXfb(string, "g_out", NULL, NULL, NULL);
+    ppo[0] = GpuPpo(reduce->pro[is_img][is_first][op][type], 0);
+  } else {
+    snprintf(string, sizeof(string), "%s#define OP %d\n#define TYPE %d\n#define FIRST %d\n%s%s%s", GPU_KERNEL_HEAD, op, type, is_first, GPU_COMPUTE_TYPE_HEAD, GPU_COMPUTE_REDUCE_HEAD,
+        "layout(location = 0) uniform int u_width;"                       "\n"
+        "layout(location = 1) uniform int u_height;"                      "\n"
+        ""                                                                "\n"
+        "#if FIRST"                                                       "\n"
+        "layout(binding = 0) uniform T_IMG s_in;"                         "\n"
+        "uvec2 Load(ivec2 p) { return uvec2(T_ENCODE(texelFetch(s_in, ivec3(p, 0), 0).x), uint(p.y * u_width + p.x)); }" "\n"
+        "#else"                                                           "\n"
+        "layout(binding = 0) uniform usampler2DArray s_in;"               "\n"
+        "uvec2 Load(ivec2 p) { return texelFetch(s_in, ivec3(p, 0), 0).xy; }" "\n"
+        "#endif"                                                          "\n"
+        ""                                                                "\n"
+        "layout(location = 0) out uvec2 g_out;"                           "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  ivec2 base = ivec2(gl_FragCoord.xy) * 4;"                      "\n"
+        "  uvec2 r = Load(base);"                                         "\n"
+        "  for (int y = 0; y < 4; y += 1)"                                "\n"
+        "  for (int x = 0; x < 4; x += 1) {"                              "\n"
+        "    ivec2 p = base + ivec2(x, y);"                               "\n"
+        "    if ((x | y) != 0 && p.x < u_width && p.y < u_height)"        "\n"
+        "      r = Combine(r, Load(p));"                                  "\n"
+        "  }"                                                             "\n"
+        "  g_out = r;"                                                    "\n"
+        "}"                                                               "\n");
+    reduce->pro[is_img][is_first][op][type] = GpuFrag(string);
+    ppo[0] = GpuPpo(GpuKernelVert(), reduce->pro[is_img][is_first][op][type]);
+  }
+  return ppo[0];
+}
+
+static inline void GpuSysReduceReadback(struct gpu_reduce_t * reduce) {
+  if (reduce->read_ptr == NULL) {
+    reduce->read_ptr = GpuMallocRead(2 * sizeof(unsigned), &reduce->read_buf);
+    reduce->read_xfb = GpuXfb(reduce->read_buf, 0, 2 * sizeof(unsigned), 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  }
+  if (reduce->fence != NULL) {
+    GpuFenceFree(reduce->fence);
+    reduce->fence = NULL;
+  }
+}
+
+// Reduces count elements of a GpuCast texture buffer of gpu_x_f32_e, gpu_x_i32_e or gpu_x_u32_e format
+static inline void GpuReduceBuf(struct gpu_reduce_t * reduce, enum gpu_reduce_op_e op, enum gpu_pix_type_e type, unsigned buf_tex_id, ptrdiff_t count) {
+  profB(__func__);
+  assert(count > 0);
+  int op_id = op == gpu_reduce_argmin_e ? gpu_reduce_min_e : op == gpu_reduce_argmax_e ? gpu_reduce_max_e : op;
+  int type_id = GpuSysComputeType(type);
+  GpuSysReduceReadback(reduce);
+  ptrdiff_t first_count = (count + 63) / 64;
+  if (first_count > 1 && first_count > reduce->buf_count) {
+    for (int i = 0; i < 2; i += 1)
+      GpuSysComputeBuf(gpu_xy_u32_e, first_count * 2 * sizeof(unsigned), &reduce->buf[i], &reduce->buf_tex[i], &reduce->buf_xfb[i]);
+    reduce->buf_count = first_count;
+  }
+  unsigned source = buf_tex_id;
+  for (int pass = 0;; pass += 1) {
+    ptrdiff_t out_count = (count + 63) / 64;
+    unsigned ppo = GpuSysReducePpo(reduce, 0, pass == 0, op_id, type_id);
+    int count_i32 = (int)count;
+    GpuI32(reduce->pro[0][pass == 0][op_id][type_id], 0, 1, &count_i32);
+    GpuBindPpo(ppo);
+    GpuBindTextures(0, 1, &source);
+    GpuBindXfb(out_count == 1 ? reduce->read_xfb : reduce->buf_xfb[pass & 1]);
+    GpuDrawOnceXfb(gpu_points_e, 0, (unsigned)out_count, 1);
+    if (out_count == 1)
+      break;
+    source = reduce->buf_tex[pass & 1];
+    count = out_count;
+  }
+  GpuBindXfb(0);
+  reduce->fence = GpuFence();
+  profE(__func__);
+}
+
+// Reduces the first channel of layer 0 of a gpu_r_f32_e, gpu_r_i32_e or gpu_r_u32_e image, indices are y * width + x
+static inline void GpuReduceImg(struct gpu_reduce_t * reduce, enum gpu_reduce_op_e op, enum gpu_pix_type_e type, unsigned img_tex_id, int width, int height) {
+  profB(__func__);
+  int op_id = op == gpu_reduce_argmin_e ? gpu_reduce_min_e : op == gpu_reduce_argmax_e ? gpu_reduce_max_e : op;
+  int type_id = GpuSysComputeType(type);
+  GpuSysReduceReadback(reduce);
+  int first_width  = (width  + 3) / 4;
+  int first_height = (height + 3) / 4;
+  if (first_width > reduce->img_width || first_height > reduce->img_height) {
+    for (int i = 0; i < 2; i += 1) {
+      if (reduce->img[i] != 0) {
+        glDeleteFramebuffers(1, &reduce->img_fbo[i]);
+        glDeleteTextures(1, &reduce->img[i]);
+      }
+      reduce->img[i] = GpuMallocImg(gpu_rg_u32_e, first_width, first_height, 1, 1);
+      reduce->img_fbo[i] = GpuFbo(reduce->img[i], 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    }
+    reduce->img_width  = first_width;
+    reduce->img_height = first_height;
+  }
+  // Integer images are incomplete under the default linear filter, texelFetch would read zeros
+  if (reduce->img_smp == 0)
+    reduce->img_smp = GpuSmp(1, gpu_nearest_e, gpu_nearest_e, gpu_clamp_to_edge_e);
+  GpuBindSamplers(0, 1, &reduce->img_smp);
+  struct gpu_sys_compute_state_t state = GpuSysComputeSave();
+  unsigned source = img_tex_id;
+  for (int pass = 0;; pass += 1) {
+    int out_width  = (width  + 3) / 4;
+    int out_height = (height + 3) / 4;
+    unsigned ppo = GpuSysReducePpo(reduce, 1, pass == 0, op_id, type_id);
+    unsigned pro = reduce->pro[1][pass == 0][op_id][type_id];
+    GpuI32(pro, 0, 1, &width);
+    GpuI32(pro, 1, 1, &height);
+    GpuBindFbo(reduce->img_fbo[pass & 1]);
+    GpuViewport(0, 0, out_width, out_height);
+    GpuBindPpo(ppo);
+    GpuBindTextures(0, 1, &source);
+    GpuDrawOnce(gpu_triangles_e, 0, 3, 1);
+    if (out_width == 1 && out_height == 1) {
+      GpuGetAsync(reduce->img[pass & 1], 0, 0, 0, 1, 1, 1, 0, gpu_rgi_e, gpu_u32_e, 2 * sizeof(unsigned), reduce->read_buf, 0);
+      break;
+    }
+    source = reduce->img[pass & 1];
+    width  = out_width;
+    height = out_height;
+  }
+  unsigned smp = 0;
+  GpuBindSamplers(0, 1, &smp);
+  GpuSysComputeRestore(&state);
+  reduce->fence = GpuFence();
+  profE(__func__);
+}
+
+// Never blocks. out_value receives 4 bytes of the reduced type, out_index the source index of a min or max.
+static inline int GpuReduceReady(struct gpu_reduce_t * reduce, void * out_value, unsigned * out_index) {
+  if (reduce->fence == NULL || !GpuFenceWait(reduce->fence, 0))
+    return 0;
+  GpuFenceFree(reduce->fence);
+  reduce->fence = NULL;
+  if (out_value != NULL)
+    memcpy(out_value, &reduce->read_ptr[0], sizeof(unsigned));
+  if (out_index != NULL)
+    out_index[0] = reduce->read_ptr[1];
+  return 1;
+}
+
+#ifndef GPULIB_MAX_SCAN_LEVELS
+#define GPULIB_MAX_SCAN_LEVELS (8)
+#endif
+
+// Block sums of 16 elements are scanned recursively, level 0 is the input
+struct gpu_scan_t {
+  unsigned sum_pro[2][3];        // [first level, next levels][f32, i32, u32]
+  unsigned sum_ppo[2][3];
+  unsigned scan_pro[2][2][2][3]; // [first level, next levels][no offsets, offsets][exclusive, inclusive][f32, i32, u32]
+  unsigned scan_ppo[2][2][2][3];
+  unsigned gather_pro[3];
+  unsigned gather_ppo[3];
+  unsigned last_pro;
+  unsigned last_ppo;
+  ptrdiff_t capacity;
+  unsigned sums[GPULIB_MAX_SCAN_LEVELS + 1];
+  unsigned sums_tex[GPULIB_MAX_SCAN_LEVELS + 1];
+  unsigned sums_xfb[GPULIB_MAX_SCAN_LEVELS + 1];
+  unsigned scans[GPULIB_MAX_SCAN_LEVELS + 1];
+  unsigned scans_tex[GPULIB_MAX_SCAN_LEVELS + 1];
+  unsigned scans_xfb[GPULIB_MAX_SCAN_LEVELS + 1];
+  ptrdiff_t flags_capacity;
+  unsigned flags;
+  unsigned flags_tex;
+  unsigned flags_xfb;
+  unsigned read_buf;
+  unsigned read_xfb;
+  unsigned * read_ptr;
+  void * fence;
+};
+
+static inline unsigned GpuSysComputeXfbPpo(unsigned * pro, unsigned * ppo, char * defines, char * body) {
+  if (ppo[0] != 0)
+    return ppo[0];
+  char string[GPULIB_MAX_SHADER_BYTES] = {0};
+  snprintf(string, sizeof(string), "%s%s%s%s", GPU_VERT_HEAD, defines, GPU_COMPUTE_TYPE_HEAD, body);
+  pro[0] = GpuVertXfb(string, "g_out", NULL, NULL, NULL);
+  ppo[0] = GpuPpo(pro[0], 0);
+  return ppo[0];
+}
+
+static inline void GpuSysScanPass(struct gpu_scan_t * scan, int type, int is_first, int inclusive, unsigned in_tex_id, unsigned offsets_tex_id, ptrdiff_t count, unsigned out_xfb_id) {
+  int has_offsets = offsets_tex_id != 0;
+  char defines[256] = {0};
+  snprintf(defines, sizeof(defines), "#define TYPE %d\n#define FIRST %d\n#define OFFSETS %d\n#define INCLUSIVE %d\n", type, is_first, has_offsets, inclusive);
+  unsigned ppo = GpuSysComputeXfbPpo(&scan->scan_pro[is_first][has_offsets][inclusive][type], &scan->scan_ppo[is_first][has_offsets][inclusive][type], defines,
+      "#if FIRST"                                                         "\n"
+      "layout(binding = 0) uniform T_BUF s_in;"                           "\n"
+      "T Load(int i) { return T(texelFetch(s_in, i).x); }"                "\n"
+      "#else"                                                             "\n"
+      "layout(binding = 0) uniform usamplerBuffer s_in;"                  "\n"
+      "T Load(int i) { return T_DECODE(texelFetch(s_in, i).x); }"         "\n"
+      "#endif"                                                            "\n"
+      "layout(binding = 1) uniform usamplerBuffer s_offsets;"             "\n"
+      ""                                                                  "\n"
+      "flat out uint g_out;"                                              "\n"
+      ""                                                                  "\n"
+      "void main() {"                                                     "\n"
+      "#if OFFSETS"                                                       "\n"
+      "  T sum = T_DECODE(texelFetch(s_offsets, gl_VertexID / 16).x);"    "\n"
+      "#else"                                                             "\n"
+      "  T sum = T(0);"                                                   "\n"
+      "#endif"                                                            "\n"
+      "  for (int i = gl_VertexID / 16 * 16; i < gl_VertexID; i += 1)"    "\n"
+      "    sum += Load(i);"                                               "\n"
+      "#if INCLUSIVE"                                                     "\n"
+      "  sum += Load(gl_VertexID);"                                       "\n"
+      "#endif"                                                            "\n"
+      "  g_out = T_ENCODE(sum);"                                          "\n"
+      "}"                                                                 "\n");
+  unsigned textures[2] = {in_tex_id, offsets_tex_id};
+  GpuBindPpo(ppo);
+  GpuBindTextures(0, 2, textures);
+  GpuBindXfb(out_xfb_id);
+  GpuDrawOnceXfb(gpu_points_e, 0, (unsigned)count, 1);
+}
+
+static inline void GpuSysScan(struct gpu_scan_t * scan, int type, int inclusive, unsigned in_tex_id, ptrdiff_t count, unsigned out_xfb_id) {
+  if (count > scan->capacity) {
+    ptrdiff_t level_count = count;
+    for (int i = 1; i <= GPULIB_MAX_SCAN_LEVELS && level_count > 16; i += 1) {
+      level_count = (level_count + 15) / 16;
+      GpuSysComputeBuf(gpu_x_u32_e, level_count * sizeof(unsigned), &scan->sums[i],  &scan->sums_tex[i],  &scan->sums_xfb[i]);
+      GpuSysComputeBuf(gpu_x_u32_e, level_count * sizeof(unsigned), &scan->scans[i], &scan->scans_tex[i], &scan->scans_xfb[i]);
+    }
+    scan->capacity = count;
+  }
+  ptrdiff_t counts[GPULIB_MAX_SCAN_LEVELS + 1] = {count};
+  int levels = 0;
+  while (counts[levels] > 16) {
+    assert(levels < GPULIB_MAX_SCAN_LEVELS);
+    counts[levels + 1] = (counts[levels] + 15) / 16;
+    levels += 1;
+  }
+  for (int i = 1; i <= levels; i += 1) {
+    char defines[64] = {0};
+    snprintf(defines, sizeof(defines), "#define TYPE %d\n#define FIRST %d\n", type, i == 1);
+    unsigned ppo = GpuSysComputeXfbPpo(&scan->sum_pro[i == 1][type], &scan->sum_ppo[i == 1][type], defines,
+        "#if FIRST"                                                       "\n"
+        "layout(binding = 0) uniform T_BUF s_in;"                         "\n"
+        "T Load(int i) { return T(texelFetch(s_in, i).x); }"              "\n"
+        "#else"                                                           "\n"
+        "layout(binding = 0) uniform usamplerBuffer s_in;"                "\n"
+        "T Load(int i) { return T_DECODE(texelFetch(s_in, i).x); }"       "\n"
+        "#endif"                                                          "\n"
+        ""                                                                "\n"
+        "layout(location = 0) uniform int u_count;"                       "\n"
+        ""                                                                "\n"
+        "flat out uint g_out;"                                            "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  T sum = T(0);"                                                 "\n"
+        "  for (int i = gl_VertexID * 16; i < min(gl_VertexID * 16 + 16, u_count); i += 1)" "\n"
+        "    sum += Load(i);"                                             "\n"
+        "  g_out = T_ENCODE(sum);"                                        "\n"
+        "}"                                                               "\n");
+    int count_i32 = (int)counts[i - 1];
+    GpuI32(scan->sum_pro[i == 1][type], 0, 1, &count_i32);
+    unsigned source = i == 1 ? in_tex_id : scan->sums_tex[i - 1];
+    GpuBindPpo(ppo);
+    GpuBindTextures(0, 1, &source);
+    GpuBindXfb(scan->sums_xfb[i]);
+    GpuDrawOnceXfb(gpu_points_e, 0, (unsigned)counts[i], 1);
+  }
+  for (int i = levels; i >= 1; i -= 1)
+    GpuSysScanPass(scan, type, 0, 0, scan->sums_tex[i], i < levels ? scan->scans_tex[i + 1] : 0, counts[i], scan->scans_xfb[i]);
+  GpuSysScanPass(scan, type, 1, inclusive, in_tex_id, levels > 0 ? scan->scans_tex[1] : 0, count, out_xfb_id);
+}
+
+// Writes count prefix sums of a GpuCast texture buffer of gpu_x_f32_e, gpu_x_i32_e or gpu_x_u32_e format to a GpuXfb object
+static inline void GpuScan(struct gpu_scan_t * scan, enum gpu_pix_type_e type, int inclusive, unsigned in_tex_id, ptrdiff_t count, unsigned out_xfb_id) {
+  profB(__func__);
+  assert(count > 0);
+  GpuSysScan(scan, GpuSysComputeType(type), inclusive != 0, in_tex_id, count, out_xfb_id);
+  GpuBindXfb(0);
+  profE(__func__);
+}
+
+// Writes the elements whose gpu_x_u32_e flag is 1 to the front of a GpuXfb object of count elements, the rest is zeroed.
+// flags must be 0 or 1. The kept count is read back asynchronously, see GpuCompactReady.
+static inline void GpuCompact(struct gpu_scan_t * scan, enum gpu_pix_type_e type, unsigned in_tex_id, unsigned flags_tex_id, ptrdiff_t count, unsigned out_xfb_id) {
+  profB(__func__);
+  assert(count > 0);
+  int type_id = GpuSysComputeType(type);
+  if (count > scan->flags_capacity) {
+    GpuSysComputeBuf(gpu_x_u32_e, count * sizeof(unsigned), &scan->flags, &scan->flags_tex, &scan->flags_xfb);
+    scan->flags_capacity = count;
+  }
+  GpuSysScan(scan, GpuSysComputeType(gpu_u32_e), 1, flags_tex_id, count, scan->flags_xfb);
+  if (scan->read_ptr == NULL) {
+    scan->read_ptr = GpuMallocRead(sizeof(unsigned), &scan->read_buf);
+    scan->read_xfb = GpuXfb(scan->read_buf, 0, sizeof(unsigned), 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  }
+  if (scan->fence != NULL) {
+    GpuFenceFree(scan->fence);
+    scan->fence = NULL;
+  }
+  char defines[32] = {0};
+  snprintf(defines, sizeof(defines), "#define TYPE %d\n", type_id);
+  // Output element i binary searches the inclusive flag scan for the first element with a higher running count
+  unsigned ppo = GpuSysComputeXfbPpo(&scan->gather_pro[type_id], &scan->gather_ppo[type_id], defines,
+      "layout(binding = 0) uniform T_BUF s_in;"                           "\n"
+      "layout(binding = 1) uniform usamplerBuffer s_scan;"                "\n"
+      ""                                                                  "\n"
+      "layout(location = 0) uniform int u_count;"                         "\n"
+      ""                                                                  "\n"
+      "flat out uint g_out;"                                              "\n"
+      ""                                                                  "\n"
+      "void main() {"                                                     "\n"
+      "  uint i = uint(gl_VertexID);"                                     "\n"
+      "  if (i >= texelFetch(s_scan, u_count - 1).x) {"                   "\n"
+      "    g_out = 0u;"                                                   "\n"
+      "    return;"                                                       "\n"
+      "  }"                                                               "\n"
+      "  int lo = 0;"                                                     "\n"
+      "  int hi = u_count - 1;"                                           "\n"
+      "  while (lo < hi) {"                                               "\n"
+      "    int mid = (lo + hi) / 2;"                                      "\n"
+      "    if (texelFetch(s_scan, mid).x > i)"                            "\n"
+      "      hi = mid;"                                                   "\n"
+      "    else"                                                          "\n"
+      "      lo = mid + 1;"                                               "\n"
+      "  }"                                                               "\n"
+      "  g_out = T_ENCODE(T(texelFetch(s_in, lo).x));"                    "\n"
+      "}"                                                                 "\n");
+  int count_i32 = (int)count;
+  unsigned textures[2] = {in_tex_id, scan->flags_tex};
+  GpuI32(scan->gather_pro[type_id], 0, 1, &count_i32);
+  GpuBindPpo(ppo);
+  GpuBindTextures(0, 2, textures);
+  GpuBindXfb(out_xfb_id);
+  GpuDrawOnceXfb(gpu_points_e, 0, (unsigned)count, 1);
+  GpuSysComputeXfbPpo(&scan->last_pro, &scan->last_ppo, "#define TYPE 2\n",
+      "layout(binding = 1) uniform usamplerBuffer s_scan;"                "\n"
+      ""                                                                  "\n"
+      "layout(location = 0) uniform int u_count;"                         "\n"
+      ""                                                                  "\n"
+      "flat out uint g_out;"                                              "\n"
+      ""                                                                  "\n"
+      "void main() {"                                                     "\n"
+      "  g_out = texelFetch(s_scan, u_count - 1).x;"                      "\n"
+      "}"                                                                 "\n");
+  GpuI32(scan->last_pro, 0, 1, &count_i32);
+  GpuBindPpo(scan->last_ppo);
+  GpuBindXfb(scan->read_xfb);
+  GpuDrawOnceXfb(gpu_points_e, 0, 1, 1);
+  GpuBindXfb(0);
+  scan->fence = GpuFence();
+  profE(__func__);
+}
+
+// Never blocks
+static inline int GpuCompactReady(struct gpu_scan_t * scan, unsigned * out_count) {
+  if (scan->fence == NULL || !GpuFenceWait(scan->fence, 0))
+    return 0;
+  GpuFenceFree(scan->fence);
+  scan->fence = NULL;
+  out_count[0] = scan->read_ptr[0];
+  return 1;
+}
+
+#ifndef GPULIB_SORT_HISTOGRAM_WIDTH
+#define GPULIB_SORT_HISTOGRAM_WIDTH (4096)
+#endif
+
+// LSD radix sort of u32 keys, 4 bits per pass. Digit counts of 32-key blocks are blended into an R32F image
+// in digit-major order, scanned, and every output element gathers its key from the block its rank falls into.
+struct gpu_sort_t {
+  struct gpu_scan_t scan;
+  unsigned histogram_pro;
+  unsigned histogram_frag;
+  unsigned histogram_ppo;
+  unsigned gather_pro[2]; // [keys only, keys and values]
+  unsigned gather_ppo[2];
+  ptrdiff_t capacity;
+  unsigned histogram;
+  unsigned histogram_fbo;
+  int histogram_height;
+  unsigned histogram_buf;
+  unsigned histogram_buf_tex;
+  unsigned histogram_scan;
+  unsigned histogram_scan_tex;
+  unsigned histogram_scan_xfb;
+  unsigned scratch[2];
+  unsigned scratch_tex[2];
+  unsigned scratch_xfb;
+  unsigned user[2];
+  unsigned user_tex[2];
+  unsigned user_xfb;
+  ptrdiff_t user_count;
+};
+
+// Sorts count u32 keys and optionally their 32-bit values (values_buf_id 0 for none) in place by the low key_bits bits.
+// count is limited to 2^24 since ranks go through R32F.
+static inline void GpuSort(struct gpu_sort_t * sort, unsigned keys_buf_id, unsigned values_buf_id, ptrdiff_t count, int key_bits) {
+  profB(__func__);
+  assert(count > 0 && count <= (1 << 24));
+  assert(key_bits > 0 && key_bits <= 32);
+  int has_values = values_buf_id != 0;
+  int blocks = (int)((count + 31) / 32);
+  int cells = 16 * blocks;
+  int histogram_height = (cells + GPULIB_SORT_HISTOGRAM_WIDTH - 1) / GPULIB_SORT_HISTOGRAM_WIDTH;
+  if (count > sort->capacity) {
+    if (sort->histogram != 0) {
+      glDeleteFramebuffers(1, &sort->histogram_fbo);
+      glDeleteTextures(1, &sort->histogram);
+      glDeleteTextures(1, &sort->histogram_buf_tex);
+      glDeleteBuffers(1, &sort->histogram_buf);
+      glDeleteTransformFeedbacks(1, &sort->scratch_xfb);
+      glDeleteTextures(2, sort->scratch_tex);
+      glDeleteBuffers(2, sort->scratch);
+    }
+    sort->histogram = GpuMallocImg(gpu_r_f32_e, GPULIB_SORT_HISTOGRAM_WIDTH, histogram_height, 1, 1);
+    sort->histogram_fbo = GpuFbo(sort->histogram, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    sort->histogram_height = histogram_height;
+    glCreateBuffers(1, &sort->histogram_buf);
+    glNamedBufferStorage(sort->histogram_buf, GPULIB_SORT_HISTOGRAM_WIDTH * histogram_height * sizeof(float), NULL, 0);
+    sort->histogram_buf_tex = GpuCast(sort->histogram_buf, gpu_x_f32_e, 0, GPULIB_SORT_HISTOGRAM_WIDTH * histogram_height * sizeof(float));
+    GpuSysComputeBuf(gpu_x_f32_e, cells * sizeof(float), &sort->histogram_scan, &sort->histogram_scan_tex, &sort->histogram_scan_xfb);
+    glCreateBuffers(2, sort->scratch);
+    for (int i = 0; i < 2; i += 1) {
+      glNamedBufferStorage(sort->scratch[i], count * sizeof(unsigned), NULL, 0);
+      sort->scratch_tex[i] = GpuCast(sort->scratch[i], gpu_x_u32_e, 0, count * sizeof(unsigned));
+    }
+    sort->scratch_xfb = GpuXfb(sort->scratch[0], 0, count * sizeof(unsigned), sort->scratch[1], 0, count * sizeof(unsigned), 0, 0, 0, 0, 0, 0);
+    sort->capacity = count;
+  }
+  if (sort->user[0] != keys_buf_id || sort->user[1] != values_buf_id || sort->user_count != count) {
+    if (sort->user_xfb != 0) {
+      glDeleteTransformFeedbacks(1, &sort->user_xfb);
+      glDeleteTextures(sort->user_tex[1] != 0 ? 2 : 1, sort->user_tex);
+    }
+    sort->user[0] = keys_buf_id;
+    sort->user[1] = values_buf_id;
+    sort->user_tex[0] = GpuCast(keys_buf_id, gpu_x_u32_e, 0, count * sizeof(unsigned));
+    sort->user_tex[1] = has_values ? GpuCast(values_buf_id, gpu_x_u32_e, 0, count * sizeof(unsigned)) : 0;
+    sort->user_xfb = GpuXfb(keys_buf_id, 0, count * sizeof(unsigned), values_buf_id, 0, has_values ? count * sizeof(unsigned) : 0, 0, 0, 0, 0, 0, 0);
+    sort->user_count = count;
+  }
+  if (sort->histogram_ppo == 0) {
+    sort->histogram_pro = GpuVert(GPU_VERT_HEAD
+        "layout(binding = 0) uniform usamplerBuffer s_keys;"              "\n"
+        ""                                                                "\n"
+        "layout(location = 0) uniform int u_shift;"                       "\n"
+        "layout(location = 1) uniform int u_blocks;"                      "\n"
+        "layout(location = 2) uniform vec2 u_size;"                       "\n"
+        "layout(location = 3) uniform uint u_mask;"                       "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  int digit = int((texelFetch(s_keys, gl_VertexID).x >> uint(u_shift)) & u_mask);" "\n"
+        "  int cell = digit * u_blocks + gl_VertexID / 32;"               "\n"
+        "  vec2 p = vec2(cell % int(u_size.x), cell / int(u_size.x)) + 0.5;" "\n"
+        "  gl_Position = vec4(p / u_size * 2 - 1, 0, 1);"                 "\n"
+        "}"                                                               "\n");
+    sort->histogram_frag = GpuFrag(GPU_KERNEL_HEAD
+        "layout(location = 0) out vec4 g_count;"                          "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  g_count = vec4(1);"                                            "\n"
+        "}"                                                               "\n");
+    sort->histogram_ppo = GpuPpo(sort->histogram_pro, sort->histogram_frag);
+  }
+  unsigned * gather_ppo = &sort->gather_ppo[has_values];
+  if (gather_ppo[0] == 0) {
+    char string[GPULIB_MAX_SHADER_BYTES] = {0};
+    snprintf(string, sizeof(string), "%s#define VALUES %d\n%s", GPU_VERT_HEAD, has_values,
+        "layout(binding = 0) uniform usamplerBuffer s_keys;"              "\n"
+        "layout(binding = 1) uniform usamplerBuffer s_values;"            "\n"
+        "layout(binding = 2) uniform samplerBuffer s_scan;"               "\n"
+        ""                                                                "\n"
+        "layout(location = 0) uniform int u_shift;"                       "\n"
+        "layout(location = 1) uniform int u_blocks;"                      "\n"
+        "layout(location = 2) uniform int u_count;"                       "\n"
+        "layout(location = 3) uniform uint u_mask;"                       "\n"
+        ""                                                                "\n"
+        "flat out uint g_key;"                                            "\n"
+        "flat out uint g_value;"                                          "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  float rank = float(gl_VertexID);"                              "\n"
+        "  int lo = 0;"                                                   "\n"
+        "  int hi = u_blocks * 16 - 1;"                                   "\n"
+        "  while (lo < hi) {"                                             "\n"
+        "    int mid = (lo + hi) / 2;"                                    "\n"
+        "    if (texelFetch(s_scan, mid).x > rank)"                       "\n"
+        "      hi = mid;"                                                 "\n"
+        "    else"                                                        "\n"
+        "      lo = mid + 1;"                                             "\n"
+        "  }"                                                             "\n"
+        "  int skip = gl_VertexID - (lo > 0 ? int(texelFetch(s_scan, lo - 1).x) : 0);" "\n"
+        "  uint digit = uint(lo / u_blocks);"                             "\n"
+        "  int first = lo % u_blocks * 32;"                               "\n"
+        "  int i = first;"                                                "\n"
+        "  for (; i < min(first + 32, u_count); i += 1) {"                "\n"
+        "    if (((texelFetch(s_keys, i).x >> uint(u_shift)) & u_mask) == digit) {" "\n"
+        "      if (skip == 0)"                                            "\n"
+        "        break;"                                                  "\n"
+        "      skip -= 1;"                                                "\n"
+        "    }"                                                           "\n"
+        "  }"                                                             "\n"
+        "  g_key = texelFetch(s_keys, i).x;"                              "\n"
+        "#if VALUES"                                                      "\n"
+        "  g_value = texelFetch(s_values, i).x;"                          "\n"
+        "#endif"                                                          "\n"
+        "}"                                                               "\n");
+    sort->gather_pro[has_values] = GpuVertXfb(string, "g_key", has_values ? "g_value" : NULL, NULL, NULL);
+    gather_ppo[0] = GpuPpo(sort->gather_pro[has_values], 0);
+  }
+
+  struct gpu_sys_compute_state_t state = GpuSysComputeSave();
+  GpuSysComputeBlendAdd();
+  float size[2] = {GPULIB_SORT_HISTOGRAM_WIDTH, histogram_height};
+  float zero = 0;
+  GpuI32(sort->histogram_pro, 1, 1, &blocks);
+  GpuV2F(sort->histogram_pro, 2, 1, size);
+  int count_i32 = (int)count;
+  GpuI32(sort->gather_pro[has_values], 1, 1, &blocks);
+  GpuI32(sort->gather_pro[has_values], 2, 1, &count_i32);
+
+  // An even pass count leaves the result in the user buffers, digits past key_bits are masked out so the extra pass is a stable copy
+  int passes = (key_bits + 3) / 4;
+  passes += passes & 1;
+  for (int pass = 0; pass < passes; pass += 1) {
+    int shift = pass * 4;
+    unsigned mask = key_bits - shift >= 4 ? 15 : key_bits - shift > 0 ? (1u << (key_bits - shift)) - 1 : 0;
+    unsigned * src_tex = (pass & 1) ? sort->scratch_tex : sort->user_tex;
+    unsigned dst_xfb = (pass & 1) ? sort->user_xfb : sort->scratch_xfb;
+    GpuSetPix(sort->histogram, 0, 0, 0, GPULIB_SORT_HISTOGRAM_WIDTH, histogram_height, 1, 0, gpu_r_e, gpu_f32_e, &zero);
+    GpuI32(sort->histogram_pro, 0, 1, &shift);
+    GpuU32(sort->histogram_pro, 3, 1, &mask);
+    GpuBindFbo(sort->histogram_fbo);
+    GpuViewport(0, 0, GPULIB_SORT_HISTOGRAM_WIDTH, histogram_height);
+    GpuBindPpo(sort->histogram_ppo);
+    GpuBindTextures(0, 1, src_tex);
+    GpuDrawOnce(gpu_points_e, 0, (unsigned)count, 1);
+    GpuGetAsync(sort->histogram, 0, 0, 0, GPULIB_SORT_HISTOGRAM_WIDTH, histogram_height, 1, 0, gpu_r_e, gpu_f32_e,
+        GPULIB_SORT_HISTOGRAM_WIDTH * histogram_height * sizeof(float), sort->histogram_buf, 0);
+    GpuSysScan(&sort->scan, GpuSysComputeType(gpu_f32_e), 1, sort->histogram_buf_tex, cells, sort->histogram_scan_xfb);
+    unsigned textures[3] = {src_tex[0], src_tex[1], sort->histogram_scan_tex};
+    GpuI32(sort->gather_pro[has_values], 0, 1, &shift);
+    GpuU32(sort->gather_pro[has_values], 3, 1, &mask);
+    GpuBindPpo(gather_ppo[0]);
+    GpuBindTextures(0, 3, textures);
+    GpuBindXfb(dst_xfb);
+    GpuDrawOnceXfb(gpu_points_e, 0, (unsigned)count, 1);
+  }
+  GpuBindXfb(0);
+  GpuSysComputeRestore(&state);
+  profE(__func__);
+}
+
+// Bin counts live in an R32F image since integer formats can't blend, counts are exact up to 2^24 per bin
+struct gpu_histogram_t {
+  unsigned pro[2][3]; // [buf, img][f32, i32, u32]
+  unsigned ppo[2][3];
+  unsigned frag;
+  unsigned smp;
+  unsigned img;
+  unsigned fbo;
+  int bins_x;
+  int bins_y;
+  unsigned read_buf;
+  float * read_ptr;
+  void * fence;
+};
+
+static inline void GpuSysHistogram(struct gpu_histogram_t * histogram, int is_img, enum gpu_pix_type_e type, unsigned src_tex_id, int src_width, ptrdiff_t count, int bins_x, int bins_y, float * range) {
+  assert(count > 0 && bins_x > 0 && bins_y > 0);
+  int type_id = GpuSysComputeType(type);
+  if (histogram->bins_x != bins_x || histogram->bins_y != bins_y) {
+    if (histogram->img != 0) {
+      glDeleteFramebuffers(1, &histogram->fbo);
+      glDeleteTextures(1, &histogram->img);
+      glDeleteBuffers(1, &histogram->read_buf);
+    }
+    histogram->img = GpuMallocImg(gpu_r_f32_e, bins_x, bins_y, 1, 1);
+    histogram->fbo = GpuFbo(histogram->img, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    histogram->read_ptr = GpuMallocRead(bins_x * bins_y * sizeof(float), &histogram->read_buf);
+    histogram->bins_x = bins_x;
+    histogram->bins_y = bins_y;
+  }
+  if (histogram->fence != NULL) {
+    GpuFenceFree(histogram->fence);
+    histogram->fence = NULL;
+  }
+  if (histogram->frag == 0) {
+    histogram->frag = GpuFrag(GPU_KERNEL_HEAD
+        "layout(location = 0) out vec4 g_count;"                          "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  g_count = vec4(1);"                                            "\n"
+        "}"                                                               "\n");
+    histogram->smp = GpuSmp(1, gpu_nearest_e, gpu_nearest_e, gpu_clamp_to_edge_e);
+  }
+  unsigned * ppo = &histogram->ppo[is_img][type_id];
+  if (ppo[0] == 0) {
+    char string[GPULIB_MAX_SHADER_BYTES] = {0};
+    snprintf(string, sizeof(string), "%s#define IMG %d\n#define TYPE %d\n%s%s", GPU_VERT_HEAD, is_img, type_id, GPU_COMPUTE_TYPE_HEAD,
+        "#if IMG"                                                         "\n"
+        "layout(binding = 0) uniform T_IMG s_in;"                         "\n"
+        "layout(location = 2) uniform int u_width;"                       "\n"
+        "vec2 Load(int i) { return vec2(texelFetch(s_in, ivec3(i % u_width, i / u_width, 0), 0).xy); }" "\n"
+        "#else"                                                           "\n"
+        "layout(binding = 0) uniform T_BUF s_in;"                         "\n"
+        "vec2 Load(int i) { return vec2(texelFetch(s_in, i).xy); }"       "\n"
+        "#endif"                                                          "\n"
+        ""                                                                "\n"
+        "layout(location = 0) uniform vec4 u_range;"                      "\n"
+        "layout(location = 1) uniform vec2 u_bins;"                       "\n"
+        ""                                                                "\n"
+        "void main() {"                                                   "\n"
+        "  vec2 t = (Load(gl_VertexID) - u_range.xz) / (u_range.yw - u_range.xz);" "\n"
+        "  vec2 bin = clamp(floor(t * u_bins), vec2(0), u_bins - 1);"     "\n"
+        "  gl_Position = vec4((bin + 0.5) / u_bins * 2 - 1, 0, 1);"       "\n"
+        "}"                                                               "\n");
+    histogram->pro[is_img][type_id] = GpuVert(string);
+    ppo[0] = GpuPpo(histogram->pro[is_img][type_id], histogram->frag);
+  }
+  unsigned pro = histogram->pro[is_img][type_id];
+  float range_xy[4] = {range[0], range[1], 0, 1};
+  float bins[2] = {bins_x, bins_y};
+  float zero = 0;
+  GpuV4F(pro, 0, 1, bins_y > 1 ? range : range_xy);
+  GpuV2F(pro, 1, 1, bins);
+  if (is_img)
+    GpuI32(pro, 2, 1, &src_width);
+  struct gpu_sys_compute_state_t state = GpuSysComputeSave();
+  GpuSetPix(histogram->img, 0, 0, 0, bins_x, bins_y, 1, 0, gpu_r_e, gpu_f32_e, &zero);
+  GpuBindFbo(histogram->fbo);
+  GpuViewport(0, 0, bins_x, bins_y);
+  GpuSysComputeBlendAdd();
+  GpuBindPpo(ppo[0]);
+  GpuBindTextures(0, 1, &src_tex_id);
+  GpuBindSamplers(0, 1, &histogram->smp);
+  GpuDrawOnce(gpu_points_e, 0, (unsigned)count, 1);
+  unsigned smp = 0;
+  GpuBindSamplers(0, 1, &smp);
+  GpuSysComputeRestore(&state);
+  GpuGetAsync(histogram->img, 0, 0, 0, bins_x, bins_y, 1, 0, gpu_r_e, gpu_f32_e, bins_x * bins_y * sizeof(float), histogram->read_buf, 0);
+  histogram->fence = GpuFence();
+}
+
+// Counts count elements of a GpuCast texture buffer into bins_x * bins_y bins of histogram->img. The first channel picks the
+// column over range[0..1], with bins_y > 1 the second channel picks the row over range[2..3]. Values out of range go to the edge bins.
+static inline void GpuHistogramBuf(struct gpu_histogram_t * histogram, enum gpu_pix_type_e type, unsigned buf_tex_id, ptrdiff_t count, int bins_x, int bins_y, float * range) {
+  profB(__func__);
+  GpuSysHistogram(histogram, 0, type, buf_tex_id, 0, count, bins_x, bins_y, range);
+  profE(__func__);
+}
+
+// Same as GpuHistogramBuf with one element per texel of layer 0 of an image
+static inline void GpuHistogramImg(struct gpu_histogram_t * histogram, enum gpu_pix_type_e type, unsigned img_tex_id, int width, int height, int bins_x, int bins_y, float * range) {
+  profB(__func__);
+  GpuSysHistogram(histogram, 1, type, img_tex_id, width, (ptrdiff_t)width * height, bins_x, bins_y, range);
+  profE(__func__);
+}
+
+// Never blocks. out_bins receives bins_x * bins_y counts, row by row.
+static inline int GpuHistogramReady(struct gpu_histogram_t * histogram, float * out_bins) {
+  if (histogram->fence == NULL || !GpuFenceWait(histogram->fence, 0))
+    return 0;
+  GpuFenceFree(histogram->fence);
+  histogram->fence = NULL;
+  memcpy(out_bins, histogram->read_ptr, histogram->bins_x * histogram->bins_y * sizeof(float));
+  return 1;
+}
+
+#ifndef GPULIB_MAX_CHUNK_WINDOWS
+#define GPULIB_MAX_CHUNK_WINDOWS (64)
+#endif
+
+#ifndef GPULIB_MAX_CHUNK_RING
+#define GPULIB_MAX_CHUNK_RING (4)
+#endif
+
+#ifndef GPULIB_CHUNK_FENCE_TIMEOUT_NS
+#define GPULIB_CHUNK_FENCE_TIMEOUT_NS (1000000000UL)
+#endif
+
+static inline int GpuSysBufFormatBytes(enum gpu_buf_format_e format) {
+  switch (format) {
+    break; case gpu_x_b8_e:  case gpu_x_i8_e:  case gpu_x_u8_e: return 1;
+    break; case gpu_x_b16_e: case gpu_x_f16_e: case gpu_x_i16_e: case gpu_x_u16_e:
+           case gpu_xy_b8_e: case gpu_xy_i8_e: case gpu_xy_u8_e: return 2;
+    break; case gpu_x_f32_e: case gpu_x_i32_e: case gpu_x_u32_e:
+           case gpu_xy_b16_e: case gpu_xy_f16_e: case gpu_xy_i16_e: case gpu_xy_u16_e:
+           case gpu_xyzw_b8_e: case gpu_xyzw_i8_e: case gpu_xyzw_u8_e: return 4;
+    break; case gpu_xy_f32_e: case gpu_xy_i32_e: case gpu_xy_u32_e:
+           case gpu_xyzw_b16_e: case gpu_xyzw_f16_e: case gpu_xyzw_i16_e: case gpu_xyzw_u16_e: return 8;
+    break; case gpu_xyz_f32_e: case gpu_xyz_i32_e: case gpu_xyz_u32_e: return 12;
+    break; case gpu_xyzw_f32_e: case gpu_xyzw_i32_e: case gpu_xyzw_u32_e: return 16;
+  }
+  return 0;
+}
+
+// A logical array split into GpuCast windows no larger than GL_MAX_TEXTURE_BUFFER_SIZE texels. Resident arrays live in one
+// buffer with a texture view per window, streamed arrays stay in CPU memory and go through a ring of fenced upload buffers.
+struct gpu_chunked_t {
+  enum gpu_buf_format_e format;
+  int element_bytes;
+  ptrdiff_t count;
+  ptrdiff_t window_count;
+  int windows_count;
+  unsigned buf;
+  unsigned window_tex[GPULIB_MAX_CHUNK_WINDOWS];
+  void * cpu;
+  int ring_count;
+  unsigned ring_buf[GPULIB_MAX_CHUNK_RING];
+  void * ring_ptr[GPULIB_MAX_CHUNK_RING];
+  unsigned ring_tex[GPULIB_MAX_CHUNK_RING];
+  void * ring_fence[GPULIB_MAX_CHUNK_RING];
+  unsigned out_xfb;
+};
+
+// window_count 0 picks the largest window the driver allows, it's rounded down to GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT
+static inline void GpuSysChunkedWindows(struct gpu_chunked_t * chunked, enum gpu_buf_format_e format, ptrdiff_t count, ptrdiff_t window_count) {
+  int max_texels = 0;
+  int alignment = 0;
+  glGetIntegerv(0x8C2B, &max_texels); // GL_MAX_TEXTURE_BUFFER_SIZE
+  glGetIntegerv(0x919F, &alignment);  // GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT
+  int element_bytes = GpuSysBufFormatBytes(format);
+  if (window_count <= 0 || window_count > max_texels)
+    window_count = max_texels;
+  assert(alignment > 0 && element_bytes > 0);
+  int gcd = alignment;
+  for (int b = element_bytes; b != 0;) {
+    int r = gcd % b;
+    gcd = b;
+    b = r;
+  }
+  int step = alignment / gcd;
+  window_count -= window_count % step;
+  assert(window_count > 0);
+  chunked->format = format;
+  chunked->element_bytes = element_bytes;
+  chunked->count = count;
+  chunked->window_count = window_count;
+  chunked->windows_count = (int)((count + window_count - 1) / window_count);
+  if (chunked->out_xfb == 0)
+    glCreateTransformFeedbacks(1, &chunked->out_xfb);
+}
+
+static inline void GpuChunked(struct gpu_chunked_t * chunked, enum gpu_buf_format_e format, unsigned buf_id, ptrdiff_t count, ptrdiff_t window_count) {
+  profB(__func__);
+  GpuSysChunkedWindows(chunked, format, count, window_count);
+  assert(chunked->windows_count <= GPULIB_MAX_CHUNK_WINDOWS);
+  chunked->buf = buf_id;
+  for (int i = 0; i < chunked->windows_count; i += 1) {
+    ptrdiff_t first = i * chunked->window_count;
+    ptrdiff_t elements = count - first < chunked->window_count ? count - first : chunked->window_count;
+    chunked->window_tex[i] = GpuCast(buf_id, format, first * chunked->element_bytes, elements * chunked->element_bytes);
+  }
+  profE(__func__);
+}
+
+static inline void GpuChunkedStream(struct gpu_chunked_t * chunked, enum gpu_buf_format_e format, void * cpu_ptr, ptrdiff_t count, ptrdiff_t window_count, int ring_count) {
+  profB(__func__);
+  assert(ring_count > 0 && ring_count <= GPULIB_MAX_CHUNK_RING);
+  GpuSysChunkedWindows(chunked, format, count, window_count);
+  chunked->cpu = cpu_ptr;
+  chunked->ring_count = ring_count;
+  for (int i = 0; i < ring_count; i += 1) {
+    chunked->ring_ptr[i] = GpuMalloc(chunked->window_count * chunked->element_bytes, &chunked->ring_buf[i]);
+    chunked->ring_tex[i] = GpuCast(chunked->ring_buf[i], format, 0, chunked->window_count * chunked->element_bytes);
+    chunked->ring_fence[i] = NULL;
+  }
+  profE(__func__);
+}
+
+// Draws one point per element of every window with ppo. vert_pro receives the window's first element index at
+// first_location as uint u_first[2], low then high 32 bits, and the window is bound to texture_unit, so the kernel reads
+// texelFetch(s, gl_VertexID) and indexes globally with u_first[0] + gl_VertexID below 2^32 elements, carrying into
+// u_first[1] past it. With out_buf_id set, the first XFB varying of every window lands at its global place. Streamed
+// arrays wait up to GPULIB_CHUNK_FENCE_TIMEOUT_NS for an upload slot to free up, if it doesn't the run stops before that
+// window and returns 0, the windows before it are already drawn.
+static inline int GpuChunkedRun(struct gpu_chunked_t * chunked, unsigned ppo, unsigned vert_pro, int first_location, int texture_unit, unsigned out_buf_id, int out_element_bytes) {
+  profB(__func__);
+  GpuBindPpo(ppo);
+  if (out_buf_id != 0)
+    GpuBindXfb(chunked->out_xfb);
+  for (int i = 0; i < chunked->windows_count; i += 1) {
+    ptrdiff_t first = i * chunked->window_count;
+    ptrdiff_t elements = chunked->count - first < chunked->window_count ? chunked->count - first : chunked->window_count;
+    unsigned tex = chunked->buf != 0 ? chunked->window_tex[i] : chunked->ring_tex[i % chunked->ring_count];
+    if (chunked->buf == 0) {
+      int slot = i % chunked->ring_count;
+      if (chunked->ring_fence[slot] != NULL) {
+        if (!GpuFenceWait(chunked->ring_fence[slot], GPULIB_CHUNK_FENCE_TIMEOUT_NS)) {
+          if (out_buf_id != 0)
+            GpuBindXfb(0);
+          profE(__func__);
+          return 0;
+        }
+        GpuFenceFree(chunked->ring_fence[slot]);
+        chunked->ring_fence[slot] = NULL;
+      }
+      memcpy(chunked->ring_ptr[slot], (char *)chunked->cpu + first * chunked->element_bytes, elements * chunked->element_bytes);
+    }
+    unsigned first_u32[2] = {(unsigned)first, (unsigned)((unsigned long)first >> 32)};
+    GpuU32(vert_pro, first_location, 2, first_u32);
+    GpuBindTextures(texture_unit, 1, &tex);
+    if (out_buf_id != 0) {
+      glTransformFeedbackBufferRange(chunked->out_xfb, 0, out_buf_id, first * out_element_bytes, elements * out_element_bytes);
+      GpuDrawOnceXfb(gpu_points_e, 0, (unsigned)elements, 1);
+    } else {
+      GpuDrawOnce(gpu_points_e, 0, (unsigned)elements, 1);
+    }
+    if (chunked->buf == 0)
+      chunked->ring_fence[i % chunked->ring_count] = GpuFence();
+  }
+  if (out_buf_id != 0)
+    GpuBindXfb(0);
+  profE(__func__);
+  return 1;
+}
@@ -6,24 +6,21 @@
 #ifndef GPULIB_DEBUG_MANUAL
 
 #define GpuWindow(window_title, window_title_bytes, window_width, window_height, msaa_samples, out_scancodes, out_dpy, out_win) do { \
-  char * __out_scancodes = out_scancodes;                                                                                            \
-  char __scancodes_temp[256 * 5] = {0};                                                                                              \
-  char * __scancodes = __out_scancodes != NULL ? __out_scancodes : __scancodes_temp;                                                 \
-  GpuWindow(window_title, window_title_bytes, window_width, window_height, msaa_samples, __scancodes, out_dpy, out_win);             \
-  ImguiInit(dpy, win, __scancodes);                                                                                                  \
+  GpuWindow(window_title, window_title_bytes, window_width, window_height, msaa_samples, out_scancodes, out_dpy, out_win);           \
+  ImguiInit(dpy, win);                                                                                                               \
   ImguiNewFrame();                                                                                                                   \
 } while(0)
 
-#define XNextEvent(dpy, event) do {                                              \
-  XEvent * __event = event;                                                      \
-  XNextEvent(dpy, __event);                                                      \
-  ImguiProcessEvent(__event);                                                    \
-  switch (__event->type) {                                                       \
-    break; case ClientMessage: {                                                 \
-      if (__event->xclient.data.l[0] == XInternAtom(dpy, "WM_DELETE_WINDOW", 0)) \
-        ImguiDeinit();                                                           \
-    }                                                                            \
-  }                                                                              \
+#define XNextEvent(dpy, event) do {                                    \
+  XEvent * __event = event;                                            \
+  XNextEvent(dpy, __event);                                            \
+  ImguiProcessEvent(__event);                                          \
+  switch (__event->type) {                                             \
+    break; case ClientMessage: {                                       \
+      if (__event->xclient.data.l[0] == g_gpulib_x11.wm_delete_window) \
+        ImguiDeinit();                                                 \
+    }                                                                  \
+  }                                                                    \
 } while(0)
 
 #define GpuSwap(dpy, win) do { \
@@ -0,0 +1,377 @@
+#pragma once
+
+#include "gpulib.h"
+
+#ifndef GPULIB_MAX_GRAPH_JOBS
+#define GPULIB_MAX_GRAPH_JOBS (64)
+#endif
+
+#ifndef GPULIB_MAX_GRAPH_RESOURCES
+#define GPULIB_MAX_GRAPH_RESOURCES (64)
+#endif
+
+#ifndef GPULIB_MAX_JOB_RESOURCES
+#define GPULIB_MAX_JOB_RESOURCES (8)
+#endif
+
+enum gpu_job_e {
+  gpu_job_kernel_e,
+  gpu_job_xfb_e,
+  gpu_job_copy_e,
+  gpu_job_readback_e,
+  gpu_job_call_e,
+};
+
+struct gpu_job_res_t {
+  int is_img;
+  int transient;
+  enum gpu_buf_format_e buf_format;
+  enum gpu_tex_format_e tex_format;
+  ptrdiff_t bytes;
+  int width;
+  int height;
+  unsigned id;
+  unsigned tex;
+  int first_use;
+  int last_use;
+};
+
+struct gpu_job_t {
+  enum gpu_job_e type;
+  unsigned ppo;
+  unsigned smp;
+  int reads_count;
+  int reads[GPULIB_MAX_JOB_RESOURCES];
+  int writes_count;
+  int writes[GPULIB_MAX_JOB_RESOURCES];
+  unsigned count;
+  enum gpu_pix_format_e pix_format;
+  enum gpu_pix_type_e pix_type;
+  void (*callback)(void *);
+  void * userdata;
+  unsigned xfb;
+  unsigned read_buf;
+  void * read_ptr;
+  void * fence;
+};
+
+// Jobs are declared in program order and read or write graph resources. GpuGraphCompile reorders them within the
+// read/write hazards to group FBO and PPO binds, and gives transient resources pooled objects whose lifetimes don't
+// overlap. Fences are only placed after readback jobs.
+struct gpu_graph_t {
+  int res_count;
+  struct gpu_job_res_t res[GPULIB_MAX_GRAPH_RESOURCES];
+  int jobs_count;
+  struct gpu_job_t jobs[GPULIB_MAX_GRAPH_JOBS];
+  int order[GPULIB_MAX_GRAPH_JOBS];
+  int pool_count;
+  struct gpu_job_res_t pool[GPULIB_MAX_GRAPH_RESOURCES];
+  int fbo_switches;
+  int ppo_switches;
+};
+
+static inline int GpuSysGraphRes(struct gpu_graph_t * graph, struct gpu_job_res_t res) {
+  assert(graph->res_count < GPULIB_MAX_GRAPH_RESOURCES);
+  graph->res[graph->res_count] = res;
+  return graph->res_count++;
+}
+
+static inline int GpuGraphBuf(struct gpu_graph_t * graph, enum gpu_buf_format_e format, unsigned buf_id, ptrdiff_t bytes) {
+  return GpuSysGraphRes(graph, (struct gpu_job_res_t){.buf_format = format, .bytes = bytes, .id = buf_id, .tex = GpuCast(buf_id, format, 0, bytes)});
+}
+
+static inline int GpuGraphImg(struct gpu_graph_t * graph, enum gpu_tex_format_e format, unsigned img_id, int width, int height) {
+  return GpuSysGraphRes(graph, (struct gpu_job_res_t){.is_img = 1, .tex_format = format, .width = width, .height = height, .id = img_id, .tex = img_id});
+}
+
+static inline int GpuGraphTransientBuf(struct gpu_graph_t * graph, enum gpu_buf_format_e format, ptrdiff_t bytes) {
+  return GpuSysGraphRes(graph, (struct gpu_job_res_t){.transient = 1, .buf_format = format, .bytes = bytes});
+}
+
+static inline int GpuGraphTransientImg(struct gpu_graph_t * graph, enum gpu_tex_format_e format, int width, int height) {
+  return GpuSysGraphRes(graph, (struct gpu_job_res_t){.is_img = 1, .transient = 1, .tex_format = format, .width = width, .height = height});
+}
+
+// Transient resources only get objects in GpuGraphCompile and may share them, ask for ids from job callbacks
+static inline unsigned GpuGraphId(struct gpu_graph_t * graph, int res) { return graph->res[res].id; }
+static inline unsigned GpuGraphTex(struct gpu_graph_t * graph, int res) { return graph->res[res].tex; }
+
+static inline int GpuSysGraphJob(
+    struct gpu_graph_t * graph, enum gpu_job_e type, unsigned ppo, unsigned smp,
+    int reads_count, int * reads, int writes_count, int * writes, void (*callback)(void *), void * userdata)
+{
+  assert(graph->jobs_count < GPULIB_MAX_GRAPH_JOBS);
+  assert(reads_count <= GPULIB_MAX_JOB_RESOURCES && writes_count <= GPULIB_MAX_JOB_RESOURCES);
+  struct gpu_job_t * job = &graph->jobs[graph->jobs_count];
+  job[0] = (struct gpu_job_t){.type = type, .ppo = ppo, .smp = smp, .reads_count = reads_count, .writes_count = writes_count, .callback = callback, .userdata = userdata};
+  for (int i = 0; i < reads_count; i += 1)
+    job->reads[i] = reads[i];
+  for (int i = 0; i < writes_count; i += 1)
+    job->writes[i] = writes[i];
+  return graph->jobs_count++;
+}
+
+// Reads are bound to texture units in order, writes are up to 4 images of the same size. callback sets uniforms.
+static inline int GpuGraphKernel(
+    struct gpu_graph_t * graph, unsigned ppo, unsigned smp,
+    int reads_count, int * reads, int writes_count, int * writes, void (*callback)(void *), void * userdata)
+{
+  assert(writes_count > 0 && writes_count <= 4);
+  return GpuSysGraphJob(graph, gpu_job_kernel_e, ppo, smp, reads_count, reads, writes_count, writes, callback, userdata);
+}
+
+// Draws count points, writes are up to 4 buffers that take the XFB varyings in order
+static inline int GpuGraphXfb(
+    struct gpu_graph_t * graph, unsigned ppo, unsigned smp,
+    int reads_count, int * reads, int writes_count, int * writes, unsigned count, void (*callback)(void *), void * userdata)
+{
+  assert(writes_count > 0 && writes_count <= 4);
+  int job = GpuSysGraphJob(graph, gpu_job_xfb_e, ppo, smp, reads_count, reads, writes_count, writes, callback, userdata);
+  graph->jobs[job].count = count;
+  return job;
+}
+
+// Buffer to buffer or image to image, the smaller of both sizes is copied
+static inline int GpuGraphCopy(struct gpu_graph_t * graph, int src, int dst) {
+  assert(graph->res[src].is_img == graph->res[dst].is_img);
+  return GpuSysGraphJob(graph, gpu_job_copy_e, 0, 0, 1, &src, 1, &dst, NULL, NULL);
+}
+
+// pixel_format and pixel_type only matter for images
+static inline int GpuGraphReadback(struct gpu_graph_t * graph, int res, enum gpu_pix_format_e pixel_format, enum gpu_pix_type_e pixel_type) {
+  int job = GpuSysGraphJob(graph, gpu_job_readback_e, 0, 0, 1, &res, 0, NULL, NULL, NULL);
+  graph->jobs[job].pix_format = pixel_format;
+  graph->jobs[job].pix_type = pixel_type;
+  return job;
+}
+
+// Anything else, like a GpuReduceBuf, as long as it declares what it touches
+static inline int GpuGraphCall(struct gpu_graph_t * graph, int reads_count, int * reads, int writes_count, int * writes, void (*callback)(void *), void * userdata) {
+  return GpuSysGraphJob(graph, gpu_job_call_e, 0, 0, reads_count, reads, writes_count, writes, callback, userdata);
+}
+
+static inline int GpuSysGraphTouches(struct gpu_job_t * job, int res, int writes_only) {
+  for (int i = 0; i < job->writes_count; i += 1)
+    if (job->writes[i] == res)
+      return 1;
+  for (int i = 0; i < job->reads_count && !writes_only; i += 1)
+    if (job->reads[i] == res)
+      return 1;
+  return 0;
+}
+
+// Read after write, write after read and write after write all keep declaration order
+static inline int GpuSysGraphDepends(struct gpu_job_t * later, struct gpu_job_t * earlier) {
+  for (int i = 0; i < later->reads_count; i += 1)
+    if (GpuSysGraphTouches(earlier, later->reads[i], 1))
+      return 1;
+  for (int i = 0; i < later->writes_count; i += 1)
+    if (GpuSysGraphTouches(earlier, later->writes[i], 0))
+      return 1;
+  return 0;
+}
+
+static inline int GpuSysGraphSameTarget(struct gpu_job_t * a, struct gpu_job_t * b) {
+  if (a->type != gpu_job_kernel_e || b->type != gpu_job_kernel_e || a->writes_count != b->writes_count)
+    return 0;
+  for (int i = 0; i < a->writes_count; i += 1)
+    if (a->writes[i] != b->writes[i])
+      return 0;
+  return 1;
+}
+
+static inline void GpuGraphCompile(struct gpu_graph_t * graph) {
+  profB(__func__);
+  int n = graph->jobs_count;
+  int scheduled[GPULIB_MAX_GRAPH_JOBS] = {0};
+
+  // Kahn's order, among ready jobs prefer the one that keeps the FBO, then the PPO, then declaration order
+  int fbo_job = -1;
+  unsigned ppo = 0;
+  graph->fbo_switches = 0;
+  graph->ppo_switches = 0;
+  for (int k = 0; k < n; k += 1) {
+    int best = -1;
+    int best_score = -1;
+    for (int i = 0; i < n; i += 1) {
+      if (scheduled[i])
+        continue;
+      int ready = 1;
+      for (int j = 0; j < i && ready; j += 1)
+        if (!scheduled[j] && GpuSysGraphDepends(&graph->jobs[i], &graph->jobs[j]))
+          ready = 0;
+      if (!ready)
+        continue;
+      struct gpu_job_t * job = &graph->jobs[i];
+      int score = 0;
+      if (fbo_job >= 0 && GpuSysGraphSameTarget(job, &graph->jobs[fbo_job]))
+        score += 2;
+      if (job->ppo != 0 && job->ppo == ppo)
+        score += 1;
+      if (score > best_score) {
+        best = i;
+        best_score = score;
+      }
+    }
+    scheduled[best] = 1;
+    graph->order[k] = best;
+    struct gpu_job_t * job = &graph->jobs[best];
+    if (job->type == gpu_job_kernel_e && (fbo_job < 0 || !GpuSysGraphSameTarget(job, &graph->jobs[fbo_job]))) {
+      fbo_job = best;
+      graph->fbo_switches += 1;
+    }
+    if (job->ppo != 0 && job->ppo != ppo) {
+      ppo = job->ppo;
+      graph->ppo_switches += 1;
+    }
+  }
+
+  for (int r = 0; r < graph->res_count; r += 1) {
+    graph->res[r].first_use = -1;
+    graph->res[r].last_use = -1;
+    for (int k = 0; k < n; k += 1) {
+      if (GpuSysGraphTouches(&graph->jobs[graph->order[k]], r, 0)) {
+        if (graph->res[r].first_use < 0)
+          graph->res[r].first_use = k;
+        graph->res[r].last_use = k;
+      }
+    }
+  }
+
+  // Pool entries are matched on exact descriptions, first_use of a pool entry holds the last job that uses it
+  for (int p = 0; p < graph->pool_count; p += 1)
+    graph->pool[p].first_use = -1;
+  for (int k = 0; k < n; k += 1) {
+    for (int r = 0; r < graph->res_count; r += 1) {
+      struct gpu_job_res_t * res = &graph->res[r];
+      if (!res->transient || res->first_use != k)
+        continue;
+      struct gpu_job_res_t * entry = NULL;
+      for (int p = 0; p < graph->pool_count && entry == NULL; p += 1) {
+        struct gpu_job_res_t * e = &graph->pool[p];
+        if (e->first_use < k && e->is_img == res->is_img && e->bytes == res->bytes && e->buf_format == res->buf_format &&
+            e->tex_format == res->tex_format && e->width == res->width && e->height == res->height)
+          entry = e;
+      }
+      if (entry == NULL) {
+        assert(graph->pool_count < GPULIB_MAX_GRAPH_RESOURCES);
+        entry = &graph->pool[graph->pool_count++];
+        entry[0] = res[0];
+        if (res->is_img) {
+          entry->id = GpuMallocImg(res->tex_format, res->width, res->height, 1, 1);
+          entry->tex = entry->id;
+        } else {
+          glCreateBuffers(1, &entry->id);
+          glNamedBufferStorage(entry->id, res->bytes, NULL, 0);
+          entry->tex = GpuCast(entry->id, res->buf_format, 0, res->bytes);
+        }
+      }
+      entry->first_use = res->last_use;
+      res->id = entry->id;
+      res->tex = entry->tex;
+    }
+  }
+
+  for (int i = 0; i < n; i += 1) {
+    struct gpu_job_t * job = &graph->jobs[i];
+    unsigned w[4] = {0};
+    for (int j = 0; j < job->writes_count && j < 4; j += 1)
+      w[j] = graph->res[job->writes[j]].id;
+    switch (job->type) {
+      break; case gpu_job_kernel_e: {
+      }
+      break; case gpu_job_xfb_e: {
+        if (job->xfb == 0)
+          glCreateTransformFeedbacks(1, &job->xfb);
+        for (int j = 0; j < job->writes_count; j += 1)
+          glTransformFeedbackBufferRange(job->xfb, j, w[j], 0, graph->res[job->writes[j]].bytes);
+      }
+      break; case gpu_job_readback_e: {
+        struct gpu_job_res_t * res = &graph->res[job->reads[0]];
+        if (job->read_buf == 0)
+          job->read_ptr = GpuMallocRead(res->is_img ? (ptrdiff_t)res->width * res->height * 16 : res->bytes, &job->read_buf);
+      }
+      break; case gpu_job_copy_e: {
+      }
+      break; case gpu_job_call_e: {
+      }
+    }
+  }
+  profE(__func__);
+}
+
+static inline void GpuGraphRun(struct gpu_graph_t * graph) {
+  profB(__func__);
+  unsigned units[GPULIB_MAX_JOB_RESOURCES];
+  unsigned smps[GPULIB_MAX_JOB_RESOURCES];
+  for (int k = 0; k < graph->jobs_count; k += 1) {
+    struct gpu_job_t * job = &graph->jobs[graph->order[k]];
+    for (int i = 0; i < job->reads_count; i += 1) {
+      units[i] = graph->res[job->reads[i]].tex;
+      smps[i] = job->smp;
+    }
+    if ((job->type == gpu_job_kernel_e || job->type == gpu_job_xfb_e) && job->reads_count > 0) {
+      GpuBindTextures(0, job->reads_count, units);
+      GpuBindSamplers(0, job->reads_count, smps);
+    }
+    if (job->ppo != 0 && g_gpulib_state.ppo != job->ppo)
+      GpuBindPpo(job->ppo);
+    switch (job->type) {
+      break; case gpu_job_kernel_e: {
+        struct gpu_job_res_t * target = &graph->res[job->writes[0]];
+        // Looked up every run, the kernel FBO cache may have evicted the FBO since the last one
+        unsigned w[4] = {0};
+        for (int j = 0; j < job->writes_count && j < 4; j += 1)
+          w[j] = graph->res[job->writes[j]].id;
+        unsigned fbo = GpuKernelFbo(w[0], 0, w[1], 0, w[2], 0, w[3], 0);
+        if (g_gpulib_state.fbo != fbo)
+          GpuBindFbo(fbo);
+        if (g_gpulib_state.viewport[0] != 0 || g_gpulib_state.viewport[1] != 0 || g_gpulib_state.viewport[2] != target->width || g_gpulib_state.viewport[3] != target->height)
+          GpuViewport(0, 0, target->width, target->height);
+        if (job->callback != NULL)
+          job->callback(job->userdata);
+        GpuDrawOnce(gpu_triangles_e, 0, 3, 1);
+      }
+      break; case gpu_job_xfb_e: {
+        if (job->callback != NULL)
+          job->callback(job->userdata);
+        GpuBindXfb(job->xfb);
+        GpuDrawOnceXfb(gpu_points_e, 0, job->count, 1);
+        GpuBindXfb(0);
+      }
+      break; case gpu_job_copy_e: {
+        struct gpu_job_res_t * src = &graph->res[job->reads[0]];
+        struct gpu_job_res_t * dst = &graph->res[job->writes[0]];
+        if (src->is_img)
+          GpuCopyImg(src->id, 0, 0, 0, 0, dst->id, 0, 0, 0, 0, src->width < dst->width ? src->width : dst->width, src->height < dst->height ? src->height : dst->height, 1);
+        else
+          GpuCopyBuf(src->id, 0, dst->id, 0, src->bytes < dst->bytes ? src->bytes : dst->bytes);
+      }
+      break; case gpu_job_readback_e: {
+        struct gpu_job_res_t * src = &graph->res[job->reads[0]];
+        if (job->fence != NULL)
+          GpuFenceFree(job->fence);
+        if (src->is_img)
+          GpuGetAsync(src->id, 0, 0, 0, src->width, src->height, 1, 0, job->pix_format, job->pix_type, src->width * src->height * 16, job->read_buf, 0);
+        else
+          GpuCopyBuf(src->id, 0, job->read_buf, 0, src->bytes);
+        job->fence = GpuFence();
+      }
+      break; case gpu_job_call_e: {
+        job->callback(job->userdata);
+      }
+    }
+  }
+  profE(__func__);
+}
+
+// Never blocks, out_ptr points into the mapped readback buffer and stays valid until the next GpuGraphRun
+static inline int GpuGraphReady(struct gpu_graph_t * graph, int readback_job, void ** out_ptr) {
+  struct gpu_job_t * job = &graph->jobs[readback_job];
+  if (job->fence == NULL || !GpuFenceWait(job->fence, 0))
+    return 0;
+  GpuFenceFree(job->fence);
+  job->fence = NULL;
+  out_ptr[0] = job->read_ptr;
+  return 1;
+}
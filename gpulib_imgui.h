@@ -210,7 +210,7 @@ void ImguiRenderDrawList(struct ImDrawData * draw_data) {
   int h = (int)(io->DisplaySize.y * fb_scale.y);
 
   ImDrawData_ScaleClipRects(draw_data, fb_scale);
-  glViewport(0, 0, w, h);
+  GpuViewport(0, 0, w, h);
 
   glDisable(0x0B44); // GL_CULL_FACE
   glDisable(0x0B71); // GL_DEPTH_TEST
@@ -224,7 +224,7 @@ void ImguiRenderDrawList(struct ImDrawData * draw_data) {
   translate[1] =  1.0;
   glProgramUniform2fv(g_ig_vert, 0, 1, scale);
   glProgramUniform2fv(g_ig_vert, 1, 1, translate);
-  glBindProgramPipeline(g_ig_ppo);
+  GpuBindPpo(g_ig_ppo);
 
   ptrdiff_t id_bytes = draw_data->TotalIdxCount * (ptrdiff_t)sizeof(ImDrawIdx);
   ptrdiff_t vt_bytes = draw_data->TotalVtxCount * (ptrdiff_t)sizeof(ImDrawVtx);
@@ -312,10 +312,10 @@ void ImguiRenderDrawList(struct ImDrawData * draw_data) {
 }
 
 char * ImguiGetClipboardText() {
-  Atom incr_atom = XInternAtom(g_ig_dpy, "INCR", 0);
-  Atom xsel_atom = XInternAtom(g_ig_dpy, "XSEL_DATA", 0);
-  Atom utf8_atom = XInternAtom(g_ig_dpy, "UTF8_STRING", 1);
-  Atom clipboard_atom = XInternAtom(g_ig_dpy, "CLIPBOARD", 0);
+  Atom incr_atom = g_gpulib_x11.incr;
+  Atom xsel_atom = g_gpulib_x11.xsel_data;
+  Atom utf8_atom = g_gpulib_x11.utf8_string;
+  Atom clipboard_atom = g_gpulib_x11.clipboard;
 
   Window owner_win = XGetSelectionOwner(g_ig_dpy, clipboard_atom);
   if (owner_win == g_ig_win) {
@@ -399,7 +399,7 @@ char * ImguiGetClipboardText() {
 }
 
 void ImguiSetClipboardText(char * text) {
-  XSetSelectionOwner(g_ig_dpy, XInternAtom(g_ig_dpy, "CLIPBOARD", 0), g_ig_win, 0);
+  XSetSelectionOwner(g_ig_dpy, g_gpulib_x11.clipboard, g_ig_win, 0);
   ptrdiff_t text_bytes = g_gpulib_libc.strlen(text);
   g_ig_clipboard_copy = g_gpulib_libc.realloc(g_ig_clipboard_copy, text_bytes + 1);
   memcpy(g_ig_clipboard_copy, text, text_bytes);
@@ -408,6 +408,7 @@ void ImguiSetClipboardText(char * text) {
 
 static inline bool ImguiProcessEvent(XEvent * event) {
   struct ImGuiIO * io = igGetIO();
+  GpuEvent(event);
   switch (event->type) {
     break; case (KeyPress): {
       io->KeysDown[event->xkey.keycode] = true;
@@ -417,38 +418,30 @@ static inline bool ImguiProcessEvent(XEvent * event) {
       if (XLookupString(&event->xkey, utf, 32, &keysym, NULL) != NoSymbol)
         ImGuiIO_AddInputCharactersUTF8(utf);
 
-      int keysym_count = 0;
-      KeySym * sym = XGetKeyboardMapping(g_ig_dpy, event->xkey.keycode, 1, &keysym_count);
-
-      if (sym[0] == XK_Shift_L   || sym[0] == XK_Shift_R)   io->KeyShift = true;
-      if (sym[0] == XK_Control_L || sym[0] == XK_Control_R) io->KeyCtrl  = true;
-      if (sym[0] == XK_Alt_L     || sym[0] == XK_Alt_R)     io->KeyAlt   = true;
-      if (sym[0] == XK_Super_L   || sym[0] == XK_Super_R)   io->KeySuper = true;
-
-      XFree(sym);
+      int key = g_gpulib_keys.map[event->xkey.keycode & 255];
+      if (key == gpu_key_lshift_e || key == gpu_key_rshift_e) io->KeyShift = true;
+      if (key == gpu_key_lctrl_e  || key == gpu_key_rctrl_e)  io->KeyCtrl  = true;
+      if (key == gpu_key_lalt_e   || key == gpu_key_ralt_e)   io->KeyAlt   = true;
+      if (key == gpu_key_lsuper_e || key == gpu_key_rsuper_e) io->KeySuper = true;
 
       return true;
     }
     break; case (KeyRelease): {
       io->KeysDown[event->xkey.keycode] = false;
 
-      int keysym_count = 0;
-      KeySym * sym = XGetKeyboardMapping(g_ig_dpy, event->xkey.keycode, 1, &keysym_count);
-
-      if (sym[0] == XK_Shift_L   || sym[0] == XK_Shift_R)   io->KeyShift = false;
-      if (sym[0] == XK_Control_L || sym[0] == XK_Control_R) io->KeyCtrl  = false;
-      if (sym[0] == XK_Alt_L     || sym[0] == XK_Alt_R)     io->KeyAlt   = false;
-      if (sym[0] == XK_Super_L   || sym[0] == XK_Super_R)   io->KeySuper = false;
-
-      XFree(sym);
+      int key = g_gpulib_keys.map[event->xkey.keycode & 255];
+      if (key == gpu_key_lshift_e || key == gpu_key_rshift_e) io->KeyShift = false;
+      if (key == gpu_key_lctrl_e  || key == gpu_key_rctrl_e)  io->KeyCtrl  = false;
+      if (key == gpu_key_lalt_e   || key == gpu_key_ralt_e)   io->KeyAlt   = false;
+      if (key == gpu_key_lsuper_e || key == gpu_key_rsuper_e) io->KeySuper = false;
 
       return true;
     }
     break; case SelectionRequest: {
-      Atom text_atom = XInternAtom(g_ig_dpy, "TEXT", 0);
-      Atom utf8_atom = XInternAtom(g_ig_dpy, "UTF8_STRING", 1);
-      Atom targets_atom = XInternAtom(g_ig_dpy, "TARGETS", 0);
-      Atom clipboard_atom = XInternAtom(g_ig_dpy, "CLIPBOARD", 0);
+      Atom text_atom = g_gpulib_x11.text;
+      Atom utf8_atom = g_gpulib_x11.utf8_string;
+      Atom targets_atom = g_gpulib_x11.targets;
+      Atom clipboard_atom = g_gpulib_x11.clipboard;
 
       if (event->xselectionrequest.selection != clipboard_atom)
         break;
@@ -614,10 +607,7 @@ static void inline ImguiNewFrame() {
   if (!g_ig_font_texture)
     ImguiCreateDeviceObjects();
 
-  int w = 0, h = 0;
-  XWindowAttributes win_attrs = {0};
-  XGetWindowAttributes(g_ig_dpy, g_ig_win, &win_attrs);
-  io->DisplaySize = (struct ImVec2){win_attrs.width, win_attrs.height};
+  io->DisplaySize = (struct ImVec2){g_gpulib_x11.width, g_gpulib_x11.height};
   io->DisplayFramebufferScale = (struct ImVec2){1, 1};
 
   unsigned long time = ImguiSysGetTimeMs();
@@ -654,40 +644,31 @@ static inline void ImguiDeinit() {
   igShutdown();
 }
 
-static inline int ImguiX11ScancodeToKeycode(char * scancodes, char * scancode) {
-  for (int i = 0; i < 256; i += 1) {
-    char * code = &scancodes[i * 5];
-    if (nstreq(4, code, scancode))
-      return i;
-  }
-  return -1;
-}
-
-static inline void ImguiInit(Display * dpy, Window win, char * scancodes) {
+static inline void ImguiInit(Display * dpy, Window win) {
   struct ImGuiIO * io = igGetIO();
 
   g_ig_dpy = dpy;
   g_ig_win = win;
 
-  io->KeyMap[ImGuiKey_Tab] = ImguiX11ScancodeToKeycode(scancodes, "TAB");
-  io->KeyMap[ImGuiKey_LeftArrow] = ImguiX11ScancodeToKeycode(scancodes, "LEFT");
-  io->KeyMap[ImGuiKey_RightArrow] = ImguiX11ScancodeToKeycode(scancodes, "RGHT");
-  io->KeyMap[ImGuiKey_UpArrow] = ImguiX11ScancodeToKeycode(scancodes, "UP");
-  io->KeyMap[ImGuiKey_DownArrow] = ImguiX11ScancodeToKeycode(scancodes, "DOWN");
-  io->KeyMap[ImGuiKey_PageUp] = ImguiX11ScancodeToKeycode(scancodes, "PGUP");
-  io->KeyMap[ImGuiKey_PageDown] = ImguiX11ScancodeToKeycode(scancodes, "PGDN");
-  io->KeyMap[ImGuiKey_Home] = ImguiX11ScancodeToKeycode(scancodes, "HOME");
-  io->KeyMap[ImGuiKey_End] = ImguiX11ScancodeToKeycode(scancodes, "END");
-  io->KeyMap[ImGuiKey_Delete] = ImguiX11ScancodeToKeycode(scancodes, "DELE");
-  io->KeyMap[ImGuiKey_Backspace] = ImguiX11ScancodeToKeycode(scancodes, "BKSP");
-  io->KeyMap[ImGuiKey_Enter] = ImguiX11ScancodeToKeycode(scancodes, "RTRN");
-  io->KeyMap[ImGuiKey_Escape] = ImguiX11ScancodeToKeycode(scancodes, "ESC");
-  io->KeyMap[ImGuiKey_A] = ImguiX11ScancodeToKeycode(scancodes, "AC01");
-  io->KeyMap[ImGuiKey_C] = ImguiX11ScancodeToKeycode(scancodes, "AB03");
-  io->KeyMap[ImGuiKey_V] = ImguiX11ScancodeToKeycode(scancodes, "AB04");
-  io->KeyMap[ImGuiKey_X] = ImguiX11ScancodeToKeycode(scancodes, "AB02");
-  io->KeyMap[ImGuiKey_Y] = ImguiX11ScancodeToKeycode(scancodes, "AD06");
-  io->KeyMap[ImGuiKey_Z] = ImguiX11ScancodeToKeycode(scancodes, "AB01");
+  io->KeyMap[ImGuiKey_Tab] = GpuKeyToKeycode(gpu_key_tab_e);
+  io->KeyMap[ImGuiKey_LeftArrow] = GpuKeyToKeycode(gpu_key_left_e);
+  io->KeyMap[ImGuiKey_RightArrow] = GpuKeyToKeycode(gpu_key_right_e);
+  io->KeyMap[ImGuiKey_UpArrow] = GpuKeyToKeycode(gpu_key_up_e);
+  io->KeyMap[ImGuiKey_DownArrow] = GpuKeyToKeycode(gpu_key_down_e);
+  io->KeyMap[ImGuiKey_PageUp] = GpuKeyToKeycode(gpu_key_pgup_e);
+  io->KeyMap[ImGuiKey_PageDown] = GpuKeyToKeycode(gpu_key_pgdn_e);
+  io->KeyMap[ImGuiKey_Home] = GpuKeyToKeycode(gpu_key_home_e);
+  io->KeyMap[ImGuiKey_End] = GpuKeyToKeycode(gpu_key_end_e);
+  io->KeyMap[ImGuiKey_Delete] = GpuKeyToKeycode(gpu_key_delete_e);
+  io->KeyMap[ImGuiKey_Backspace] = GpuKeyToKeycode(gpu_key_backspace_e);
+  io->KeyMap[ImGuiKey_Enter] = GpuKeyToKeycode(gpu_key_enter_e);
+  io->KeyMap[ImGuiKey_Escape] = GpuKeyToKeycode(gpu_key_esc_e);
+  io->KeyMap[ImGuiKey_A] = GpuKeyToKeycode(gpu_key_a_e);
+  io->KeyMap[ImGuiKey_C] = GpuKeyToKeycode(gpu_key_c_e);
+  io->KeyMap[ImGuiKey_V] = GpuKeyToKeycode(gpu_key_v_e);
+  io->KeyMap[ImGuiKey_X] = GpuKeyToKeycode(gpu_key_x_e);
+  io->KeyMap[ImGuiKey_Y] = GpuKeyToKeycode(gpu_key_y_e);
+  io->KeyMap[ImGuiKey_Z] = GpuKeyToKeycode(gpu_key_z_e);
 
   io->RenderDrawListsFn = ImguiRenderDrawList;
   io->GetClipboardTextFn = ImguiGetClipboardText;
@@ -0,0 +1,588 @@
+#pragma once
+
+// GpuWindow calls XInitThreads only when gpulib.h sees GPULIB_THREADS
+#if defined(GPULIB_INCLUDED) && !defined(GPULIB_THREADS)
+#error "Include gpulib_thread.h before gpulib.h or define GPULIB_THREADS"
+#endif
+
+#define GPULIB_THREADS
+#include "gpulib.h"
+
+#ifndef GPULIB_MAX_FRAMES
+#define GPULIB_MAX_FRAMES (3)
+#endif
+
+#ifndef GPULIB_PROF_RENDER_THREAD
+#define GPULIB_PROF_RENDER_THREAD (1) // Tinyprofiler slot of the render thread
+#endif
+
+enum gpu_frame_cmd_e {
+  gpu_frame_bind_fbo_e,
+  gpu_frame_bind_xfb_e,
+  gpu_frame_bind_indices_e,
+  gpu_frame_bind_commands_e,
+  gpu_frame_bind_textures_e,
+  gpu_frame_bind_samplers_e,
+  gpu_frame_bind_ppo_e,
+  gpu_frame_draw_e,
+  gpu_frame_draw_xfb_e,
+  gpu_frame_draw_once_e,
+  gpu_frame_draw_once_xfb_e,
+  gpu_frame_blit_e,
+  gpu_frame_blit_to_screen_e,
+  gpu_frame_clear_e,
+  gpu_frame_enable_e,
+  gpu_frame_disable_e,
+  gpu_frame_viewport_e,
+  gpu_frame_u32_e,
+  gpu_frame_i32_e,
+  gpu_frame_f32_e,
+  gpu_frame_v2f_e,
+  gpu_frame_v3f_e,
+  gpu_frame_v4f_e,
+  gpu_frame_set_e,
+  gpu_frame_copy_e,
+  gpu_frame_call_e,
+};
+
+struct gpu_frame_cmd_t {
+  enum gpu_frame_cmd_e type;
+  int data_bytes;
+  long args[12];
+};
+
+struct gpu_frame_t {
+  ptrdiff_t bytes_count;
+  ptrdiff_t bytes_capacity;
+  unsigned char * bytes;
+  int quit;
+};
+
+struct gpu_sys_thread_t {
+  struct gpu_frame_t frames[GPULIB_MAX_FRAMES];
+  int frames_count;
+  int frames_queued; // Futex word, written by both threads
+  int frame_write;   // Simulation thread only
+  int frame_read;    // Render thread only
+  unsigned long thread;
+  Display * dpy;
+  Window win;
+} g_gpulib_thread = {0};
+
+static inline void GpuSysFutexWait(int * addr, int value) {
+  syscall6(202, (long)addr, 128, value, 0, 0, 0); // SYS_futex, FUTEX_WAIT_PRIVATE
+}
+
+static inline void GpuSysFutexWake(int * addr) {
+  syscall6(202, (long)addr, 129, 0x7FFFFFFF, 0, 0, 0); // SYS_futex, FUTEX_WAKE_PRIVATE
+}
+
+static inline struct gpu_frame_cmd_t * GpuSysFramePush(struct gpu_frame_t * frame, enum gpu_frame_cmd_e type, int data_bytes, void * data) {
+  ptrdiff_t bytes = sizeof(struct gpu_frame_cmd_t) + ((data_bytes + 7) & ~7);
+  assert(frame->bytes_count + bytes <= frame->bytes_capacity);
+  struct gpu_frame_cmd_t * cmd = (struct gpu_frame_cmd_t *)(frame->bytes + frame->bytes_count);
+  cmd->type = type;
+  cmd->data_bytes = data_bytes;
+  if (data != NULL)
+    memcpy(cmd + 1, data, data_bytes);
+  frame->bytes_count += bytes;
+  return cmd;
+}
+
+static inline void GpuSysFrameExecute(struct gpu_frame_t * frame) {
+  profB(__func__);
+  for (ptrdiff_t i = 0; i < frame->bytes_count;) {
+    struct gpu_frame_cmd_t * cmd = (struct gpu_frame_cmd_t *)(frame->bytes + i);
+    long * a = cmd->args;
+    void * data = cmd + 1;
+    switch (cmd->type) {
+      break; case gpu_frame_bind_fbo_e:       GpuBindFbo(a[0]);
+      break; case gpu_frame_bind_xfb_e:       GpuBindXfb(a[0]);
+      break; case gpu_frame_bind_indices_e:   GpuBindIndices(a[0], a[1]);
+      break; case gpu_frame_bind_commands_e:  GpuBindCommands(a[0]);
+      break; case gpu_frame_bind_textures_e:  GpuBindTextures(a[0], a[1], data);
+      break; case gpu_frame_bind_samplers_e:  GpuBindSamplers(a[0], a[1], data);
+      break; case gpu_frame_bind_ppo_e:       GpuBindPpo(a[0]);
+      break; case gpu_frame_draw_e:           GpuDraw(a[0], a[1], a[2]);
+      break; case gpu_frame_draw_xfb_e:       GpuDrawXfb(a[0], a[1], a[2]);
+      break; case gpu_frame_draw_once_e:      GpuDrawOnce(a[0], a[1], a[2], a[3]);
+      break; case gpu_frame_draw_once_xfb_e:  GpuDrawOnceXfb(a[0], a[1], a[2], a[3]);
+      break; case gpu_frame_blit_e:           GpuBlit(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11]);
+      break; case gpu_frame_blit_to_screen_e: GpuBlitToScreen(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9]);
+      break; case gpu_frame_clear_e:          GpuClear();
+      break; case gpu_frame_enable_e:         GpuEnable(a[0]);
+      break; case gpu_frame_disable_e:        GpuDisable(a[0]);
+      break; case gpu_frame_viewport_e:       GpuViewport(a[0], a[1], a[2], a[3]);
+      break; case gpu_frame_u32_e:            GpuU32(a[0], a[1], a[2], data);
+      break; case gpu_frame_i32_e:            GpuI32(a[0], a[1], a[2], data);
+      break; case gpu_frame_f32_e:            GpuF32(a[0], a[1], a[2], data);
+      break; case gpu_frame_v2f_e:            GpuV2F(a[0], a[1], a[2], data);
+      break; case gpu_frame_v3f_e:            GpuV3F(a[0], a[1], a[2], data);
+      break; case gpu_frame_v4f_e:            GpuV4F(a[0], a[1], a[2], data);
+      break; case gpu_frame_set_e:            GpuSet(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], data);
+      break; case gpu_frame_copy_e:           memcpy((void *)a[0], data, cmd->data_bytes);
+      break; case gpu_frame_call_e:           ((void (*)(void *))a[0])(data);
+    }
+    i += sizeof(struct gpu_frame_cmd_t) + ((cmd->data_bytes + 7) & ~7);
+  }
+  profE(__func__);
+}
+
+static void * GpuSysRenderThread(void * arg) {
+  struct gpu_sys_thread_t * t = arg;
+  g_gpulib_prof_tid = GPULIB_PROF_RENDER_THREAD;
+  int is_glx_context_current = glXMakeContextCurrent(t->dpy, t->win, t->win, g_gpulib_x11.glx_ctx);
+  assert(is_glx_context_current != 0);
+  for (;;) {
+    while (__atomic_load_n(&t->frames_queued, __ATOMIC_ACQUIRE) == 0)
+      GpuSysFutexWait(&t->frames_queued, 0);
+    struct gpu_frame_t * frame = &t->frames[t->frame_read];
+    int quit = frame->quit;
+    if (quit == 0) {
+      GpuSysFrameExecute(frame);
+      profB("glXSwapBuffers");
+      glXSwapBuffers(t->dpy, t->win);
+      profE("glXSwapBuffers");
+      GpuFinish();
+    }
+    t->frame_read = (t->frame_read + 1) % t->frames_count;
+    __atomic_sub_fetch(&t->frames_queued, 1, __ATOMIC_RELEASE);
+    GpuSysFutexWake(&t->frames_queued);
+    if (quit != 0)
+      break;
+  }
+  glXMakeContextCurrent(t->dpy, None, None, NULL);
+  return NULL;
+}
+
+static inline void GpuThreadStart(Display * dpy, Window win, int frames_count, ptrdiff_t frame_bytes) {
+  profB(__func__);
+  assert(frames_count >= 2 && frames_count <= GPULIB_MAX_FRAMES);
+  struct gpu_sys_thread_t * t = &g_gpulib_thread;
+  t->frames_count  = frames_count;
+  t->frames_queued = 0;
+  t->frame_write   = 0;
+  t->frame_read    = 0;
+  t->dpy = dpy;
+  t->win = win;
+  for (int i = 0; i < frames_count; i += 1) {
+    t->frames[i].bytes = mmap(NULL, frame_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(t->frames[i].bytes != MAP_FAILED);
+    t->frames[i].bytes_count    = 0;
+    t->frames[i].bytes_capacity = frame_bytes;
+    t->frames[i].quit           = 0;
+  }
+  GpuFinish();
+  glXMakeContextCurrent(dpy, None, None, NULL);
+  int rc = g_gpulib_libc.pthread_create(&t->thread, NULL, GpuSysRenderThread, t);
+  assert(rc == 0);
+  profE(__func__);
+}
+
+static inline struct gpu_frame_t * GpuFrameBegin() {
+  profB(__func__);
+  struct gpu_sys_thread_t * t = &g_gpulib_thread;
+  while (__atomic_load_n(&t->frames_queued, __ATOMIC_ACQUIRE) == t->frames_count)
+    GpuSysFutexWait(&t->frames_queued, t->frames_count);
+  struct gpu_frame_t * frame = &t->frames[t->frame_write];
+  frame->bytes_count = 0;
+  frame->quit = 0;
+  profE(__func__);
+  return frame;
+}
+
+static inline void GpuFrameSubmit(struct gpu_frame_t * frame) {
+  profB(__func__);
+  struct gpu_sys_thread_t * t = &g_gpulib_thread;
+  assert(frame == &t->frames[t->frame_write]);
+  t->frame_write = (t->frame_write + 1) % t->frames_count;
+  __atomic_add_fetch(&t->frames_queued, 1, __ATOMIC_RELEASE);
+  GpuSysFutexWake(&t->frames_queued);
+  GpuKeyFrame();
+  profE(__func__);
+}
+
+static inline void GpuThreadStop() {
+  profB(__func__);
+  struct gpu_sys_thread_t * t = &g_gpulib_thread;
+  struct gpu_frame_t * frame = GpuFrameBegin();
+  frame->quit = 1;
+  GpuFrameSubmit(frame);
+  g_gpulib_libc.pthread_join(t->thread, NULL);
+  for (int i = 0; i < t->frames_count; i += 1) {
+    munmap(t->frames[i].bytes, t->frames[i].bytes_capacity);
+    t->frames[i].bytes = NULL;
+  }
+  int is_glx_context_current = glXMakeContextCurrent(t->dpy, t->win, t->win, g_gpulib_x11.glx_ctx);
+  assert(is_glx_context_current != 0);
+  profE(__func__);
+}
+
+static inline void GpuFrameBindFbo(struct gpu_frame_t * frame, unsigned fbo_id) {
+  GpuSysFramePush(frame, gpu_frame_bind_fbo_e, 0, NULL)->args[0] = fbo_id;
+}
+
+static inline void GpuFrameBindXfb(struct gpu_frame_t * frame, unsigned xfb_id) {
+  GpuSysFramePush(frame, gpu_frame_bind_xfb_e, 0, NULL)->args[0] = xfb_id;
+}
+
+static inline void GpuFrameBindIndices(struct gpu_frame_t * frame, unsigned idb_id, enum gpu_pix_type_e index_type) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_bind_indices_e, 0, NULL);
+  cmd->args[0] = idb_id;
+  cmd->args[1] = index_type;
+}
+
+static inline void GpuFrameBindCommands(struct gpu_frame_t * frame, unsigned dib_id) {
+  GpuSysFramePush(frame, gpu_frame_bind_commands_e, 0, NULL)->args[0] = dib_id;
+}
+
+static inline void GpuFrameBindTextures(struct gpu_frame_t * frame, int first, int count, unsigned * textures) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_bind_textures_e, count * sizeof(unsigned), textures);
+  cmd->args[0] = first;
+  cmd->args[1] = count;
+}
+
+static inline void GpuFrameBindSamplers(struct gpu_frame_t * frame, int first, int count, unsigned * samplers) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_bind_samplers_e, count * sizeof(unsigned), samplers);
+  cmd->args[0] = first;
+  cmd->args[1] = count;
+}
+
+static inline void GpuFrameBindPpo(struct gpu_frame_t * frame, unsigned ppo) {
+  GpuSysFramePush(frame, gpu_frame_bind_ppo_e, 0, NULL)->args[0] = ppo;
+}
+
+static inline void GpuFrameDraw(struct gpu_frame_t * frame, enum gpu_mode_e mode, unsigned binded_dib_cmd_first, unsigned binded_dib_cmd_count) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_draw_e, 0, NULL);
+  cmd->args[0] = mode;
+  cmd->args[1] = binded_dib_cmd_first;
+  cmd->args[2] = binded_dib_cmd_count;
+}
+
+static inline void GpuFrameDrawXfb(struct gpu_frame_t * frame, enum gpu_mode_e mode, unsigned binded_dib_cmd_first, unsigned binded_dib_cmd_count) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_draw_xfb_e, 0, NULL);
+  cmd->args[0] = mode;
+  cmd->args[1] = binded_dib_cmd_first;
+  cmd->args[2] = binded_dib_cmd_count;
+}
+
+static inline void GpuFrameDrawOnce(struct gpu_frame_t * frame, enum gpu_mode_e mode, unsigned first, unsigned count, unsigned instance_count) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_draw_once_e, 0, NULL);
+  cmd->args[0] = mode;
+  cmd->args[1] = first;
+  cmd->args[2] = count;
+  cmd->args[3] = instance_count;
+}
+
+static inline void GpuFrameDrawOnceXfb(struct gpu_frame_t * frame, enum gpu_mode_e mode, unsigned first, unsigned count, unsigned instance_count) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_draw_once_xfb_e, 0, NULL);
+  cmd->args[0] = mode;
+  cmd->args[1] = first;
+  cmd->args[2] = count;
+  cmd->args[3] = instance_count;
+}
+
+static inline void GpuFrameBlit(
+    struct gpu_frame_t * frame,
+    unsigned source_fbo_id, int source_color_id, int source_x, int source_y, int source_width, int source_height,
+    unsigned target_fbo_id, int target_color_id, int target_x, int target_y, int target_width, int target_height)
+{
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_blit_e, 0, NULL);
+  cmd->args[0]  = source_fbo_id;
+  cmd->args[1]  = source_color_id;
+  cmd->args[2]  = source_x;
+  cmd->args[3]  = source_y;
+  cmd->args[4]  = source_width;
+  cmd->args[5]  = source_height;
+  cmd->args[6]  = target_fbo_id;
+  cmd->args[7]  = target_color_id;
+  cmd->args[8]  = target_x;
+  cmd->args[9]  = target_y;
+  cmd->args[10] = target_width;
+  cmd->args[11] = target_height;
+}
+
+static inline void GpuFrameBlitToScreen(
+    struct gpu_frame_t * frame,
+    unsigned source_fbo_id, int source_color_id,
+    int source_x, int source_y, int source_width, int source_height,
+    int screen_x, int screen_y, int screen_width, int screen_height)
+{
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_blit_to_screen_e, 0, NULL);
+  cmd->args[0] = source_fbo_id;
+  cmd->args[1] = source_color_id;
+  cmd->args[2] = source_x;
+  cmd->args[3] = source_y;
+  cmd->args[4] = source_width;
+  cmd->args[5] = source_height;
+  cmd->args[6] = screen_x;
+  cmd->args[7] = screen_y;
+  cmd->args[8] = screen_width;
+  cmd->args[9] = screen_height;
+}
+
+static inline void GpuFrameClear(struct gpu_frame_t * frame) {
+  GpuSysFramePush(frame, gpu_frame_clear_e, 0, NULL);
+}
+
+static inline void GpuFrameEnable(struct gpu_frame_t * frame, unsigned flags) {
+  GpuSysFramePush(frame, gpu_frame_enable_e, 0, NULL)->args[0] = flags;
+}
+
+static inline void GpuFrameDisable(struct gpu_frame_t * frame, unsigned flags) {
+  GpuSysFramePush(frame, gpu_frame_disable_e, 0, NULL)->args[0] = flags;
+}
+
+static inline void GpuFrameViewport(struct gpu_frame_t * frame, int x, int y, int width, int height) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_viewport_e, 0, NULL);
+  cmd->args[0] = x;
+  cmd->args[1] = y;
+  cmd->args[2] = width;
+  cmd->args[3] = height;
+}
+
+static inline void GpuSysFrameUniform(struct gpu_frame_t * frame, enum gpu_frame_cmd_e type, unsigned program, int location, int count, int value_bytes, void * value) {
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, type, value_bytes, value);
+  cmd->args[0] = program;
+  cmd->args[1] = location;
+  cmd->args[2] = count;
+}
+
+static inline void GpuFrameU32(struct gpu_frame_t * frame, unsigned program, int location, int count, unsigned * value) { GpuSysFrameUniform(frame, gpu_frame_u32_e, program, location, count, count * 1 * sizeof(unsigned), value); }
+static inline void GpuFrameI32(struct gpu_frame_t * frame, unsigned program, int location, int count, int      * value) { GpuSysFrameUniform(frame, gpu_frame_i32_e, program, location, count, count * 1 * sizeof(int),      value); }
+static inline void GpuFrameF32(struct gpu_frame_t * frame, unsigned program, int location, int count, float    * value) { GpuSysFrameUniform(frame, gpu_frame_f32_e, program, location, count, count * 1 * sizeof(float),    value); }
+static inline void GpuFrameV2F(struct gpu_frame_t * frame, unsigned program, int location, int count, float    * value) { GpuSysFrameUniform(frame, gpu_frame_v2f_e, program, location, count, count * 2 * sizeof(float),    value); }
+static inline void GpuFrameV3F(struct gpu_frame_t * frame, unsigned program, int location, int count, float    * value) { GpuSysFrameUniform(frame, gpu_frame_v3f_e, program, location, count, count * 3 * sizeof(float),    value); }
+static inline void GpuFrameV4F(struct gpu_frame_t * frame, unsigned program, int location, int count, float    * value) { GpuSysFrameUniform(frame, gpu_frame_v4f_e, program, location, count, count * 4 * sizeof(float),    value); }
+
+static inline void GpuFrameSet(
+    struct gpu_frame_t * frame,
+    unsigned tex_id, int layer, int x, int y, int width, int height, int count, int mipmap_level,
+    enum gpu_pix_format_e pixel_format, enum gpu_pix_type_e pixel_type, int pixels_bytes, void * pixels)
+{
+  struct gpu_frame_cmd_t * cmd = GpuSysFramePush(frame, gpu_frame_set_e, pixels_bytes, pixels);
+  cmd->args[0] = tex_id;
+  cmd->args[1] = layer;
+  cmd->args[2] = x;
+  cmd->args[3] = y;
+  cmd->args[4] = width;
+  cmd->args[5] = height;
+  cmd->args[6] = count;
+  cmd->args[7] = mipmap_level;
+  cmd->args[8] = pixel_format;
+  cmd->args[9] = pixel_type;
+}
+
+static inline void GpuFrameCopy(struct gpu_frame_t * frame, void * gpu_ptr, void * cpu_ptr, int bytes) {
+  GpuSysFramePush(frame, gpu_frame_copy_e, bytes, cpu_ptr)->args[0] = (long)gpu_ptr;
+}
+
+static inline void GpuFrameCall(struct gpu_frame_t * frame, void (*callback)(void *), int userdata_bytes, void * userdata) {
+  GpuSysFramePush(frame, gpu_frame_call_e, userdata_bytes, userdata)->args[0] = (long)callback;
+}
+
+#ifndef GPULIB_MAX_LOADS
+#define GPULIB_MAX_LOADS (256)
+#endif
+
+#ifndef GPULIB_PROF_LOADER_THREAD
+#define GPULIB_PROF_LOADER_THREAD (2) // Tinyprofiler slot of the loader thread
+#endif
+
+enum gpu_load_e {
+  gpu_load_buf_e,
+  gpu_load_img_e,
+  gpu_load_cbm_e,
+  gpu_load_pro_e,
+  gpu_load_call_e,
+};
+
+struct gpu_load_t {
+  enum gpu_load_e type;
+  long args[6];
+  char * str;
+  unsigned * out_id;
+  void (*callback)(void *);
+  void * userdata;
+  void * fence;
+  int state; // 0: queued, 1: fenced by the loader thread, 2: ready
+  int failed; // Set by the loader thread when the file couldn't be read or the program didn't build
+};
+
+struct gpu_sys_loader_t {
+  struct gpu_load_t * loads[GPULIB_MAX_LOADS];
+  int loads_queued; // Futex word, written by both threads
+  int load_write;   // Main thread only
+  int load_read;    // Loader thread only
+  unsigned long thread;
+  Display * dpy;
+  GLXContext glx_ctx;
+} g_gpulib_loader = {0};
+
+static inline void GpuSysLoaderExecute(struct gpu_load_t * load) {
+  profB(__func__);
+  long * a = load->args;
+  switch (load->type) {
+    break; case gpu_load_buf_e: {
+      int fd = open(load->str, O_RDONLY);
+      void * p = fd < 0 ? MAP_FAILED : mmap(NULL, a[0], PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        if (fd >= 0)
+          close(fd);
+        load->out_id[0] = 0;
+        load->failed = 1;
+        break;
+      }
+      glCreateBuffers(1, load->out_id);
+      glNamedBufferStorage(load->out_id[0], a[0], p, 0);
+      munmap(p, a[0]);
+      close(fd);
+    }
+    break; case gpu_load_img_e: {
+      load->failed = GpuLoadRgbImgBinary(a[0], a[1], a[2], a[3], load->str) != 0;
+    }
+    break; case gpu_load_cbm_e: {
+      load->failed = GpuLoadRgbCbmBinary(a[0], a[1], a[2], a[3], load->str) != 0;
+    }
+    break; case gpu_load_pro_e: {
+      load->out_id[0] = GpuPro(a[0], load->str, NULL, NULL, NULL, NULL);
+      load->failed = load->out_id[0] == 0;
+    }
+    break; case gpu_load_call_e: {
+      load->callback(load->userdata);
+    }
+  }
+  profE(__func__);
+}
+
+static void * GpuSysLoaderThread(void * arg) {
+  struct gpu_sys_loader_t * l = arg;
+  g_gpulib_prof_tid = GPULIB_PROF_LOADER_THREAD;
+  int is_glx_context_current = glXMakeContextCurrent(l->dpy, None, None, l->glx_ctx);
+  assert(is_glx_context_current != 0);
+  for (;;) {
+    while (__atomic_load_n(&l->loads_queued, __ATOMIC_ACQUIRE) == 0)
+      GpuSysFutexWait(&l->loads_queued, 0);
+    struct gpu_load_t * load = l->loads[l->load_read];
+    l->load_read = (l->load_read + 1) % GPULIB_MAX_LOADS;
+    __atomic_sub_fetch(&l->loads_queued, 1, __ATOMIC_RELEASE);
+    GpuSysFutexWake(&l->loads_queued);
+    if (load == NULL)
+      break;
+    GpuSysLoaderExecute(load);
+    load->fence = GpuFence();
+    glFlush();
+    __atomic_store_n(&load->state, 1, __ATOMIC_RELEASE);
+  }
+  glXMakeContextCurrent(l->dpy, None, None, NULL);
+  return NULL;
+}
+
+static inline void GpuLoaderStart(Display * dpy) {
+  profB(__func__);
+  struct gpu_sys_loader_t * l = &g_gpulib_loader;
+  l->loads_queued = 0;
+  l->load_write   = 0;
+  l->load_read    = 0;
+  l->dpy = dpy;
+  {
+    GLXContext (*glXCreateContextAttribsARB)(Display *, GLXFBConfig, GLXContext, int, int *) = (void *)glXGetProcAddressARB((unsigned char *)"glXCreateContextAttribsARB");
+    assert(glXCreateContextAttribsARB != NULL);
+    int attribs[] = {
+      0x2091, 3, // GLX_CONTEXT_MAJOR_VERSION_ARB
+      0x2092, 3, // GLX_CONTEXT_MINOR_VERSION_ARB
+      GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+      None
+    };
+    profB("glXCreateContextAttribsARB");
+    l->glx_ctx = glXCreateContextAttribsARB(dpy, g_gpulib_x11.fbconfig, g_gpulib_x11.glx_ctx, 1, attribs);
+    profE("glXCreateContextAttribsARB");
+    assert(l->glx_ctx != NULL);
+  }
+  int rc = g_gpulib_libc.pthread_create(&l->thread, NULL, GpuSysLoaderThread, l);
+  assert(rc == 0);
+  profE(__func__);
+}
+
+static inline void GpuSysLoaderPush(struct gpu_load_t * load) {
+  struct gpu_sys_loader_t * l = &g_gpulib_loader;
+  while (__atomic_load_n(&l->loads_queued, __ATOMIC_ACQUIRE) == GPULIB_MAX_LOADS)
+    GpuSysFutexWait(&l->loads_queued, GPULIB_MAX_LOADS);
+  if (load != NULL) {
+    load->fence = NULL;
+    load->state = 0;
+    load->failed = 0;
+  }
+  l->loads[l->load_write] = load;
+  l->load_write = (l->load_write + 1) % GPULIB_MAX_LOADS;
+  __atomic_add_fetch(&l->loads_queued, 1, __ATOMIC_RELEASE);
+  GpuSysFutexWake(&l->loads_queued);
+}
+
+static inline void GpuLoaderStop() {
+  profB(__func__);
+  struct gpu_sys_loader_t * l = &g_gpulib_loader;
+  GpuSysLoaderPush(NULL);
+  g_gpulib_libc.pthread_join(l->thread, NULL);
+  glXDestroyContext(l->dpy, l->glx_ctx);
+  l->glx_ctx = NULL;
+  profE(__func__);
+}
+
+static inline void GpuLoaderBuf(struct gpu_load_t * load, ptrdiff_t bytes, char * buf_binary_filepath, unsigned * out_buf_id) {
+  load->type    = gpu_load_buf_e;
+  load->args[0] = bytes;
+  load->str     = buf_binary_filepath;
+  load->out_id  = out_buf_id;
+  GpuSysLoaderPush(load);
+}
+
+static inline void GpuLoaderRgbImg(struct gpu_load_t * load, unsigned tex_id, int width, int height, int layer_count, char * img_binary_filepath) {
+  load->type    = gpu_load_img_e;
+  load->args[0] = tex_id;
+  load->args[1] = width;
+  load->args[2] = height;
+  load->args[3] = layer_count;
+  load->str     = img_binary_filepath;
+  GpuSysLoaderPush(load);
+}
+
+static inline void GpuLoaderRgbCbm(struct gpu_load_t * load, unsigned tex_id, int width, int height, int layer_count, char * cbm_binary_filepath) {
+  load->type    = gpu_load_cbm_e;
+  load->args[0] = tex_id;
+  load->args[1] = width;
+  load->args[2] = height;
+  load->args[3] = layer_count;
+  load->str     = cbm_binary_filepath;
+  GpuSysLoaderPush(load);
+}
+
+static inline void GpuLoaderPro(struct gpu_load_t * load, unsigned shader_type, char * shader_string, unsigned * out_pro_id) {
+  load->type    = gpu_load_pro_e;
+  load->args[0] = shader_type;
+  load->str     = shader_string;
+  load->out_id  = out_pro_id;
+  GpuSysLoaderPush(load);
+}
+
+static inline void GpuLoaderVert(struct gpu_load_t * load, char * shader_string, unsigned * out_pro_id) { GpuLoaderPro(load, 0x8B31, shader_string, out_pro_id); } // GL_VERTEX_SHADER
+static inline void GpuLoaderFrag(struct gpu_load_t * load, char * shader_string, unsigned * out_pro_id) { GpuLoaderPro(load, 0x8B30, shader_string, out_pro_id); } // GL_FRAGMENT_SHADER
+
+static inline void GpuLoaderCall(struct gpu_load_t * load, void (*callback)(void *), void * userdata) {
+  load->type     = gpu_load_call_e;
+  load->callback = callback;
+  load->userdata = userdata;
+  GpuSysLoaderPush(load);
+}
+
+// Never blocks. Needs a current context on the calling thread. Failed loads become ready too, check load->failed before
+// using the result, buffer and program loads also set their out id to 0.
+static inline int GpuLoaderReady(struct gpu_load_t * load) {
+  int state = __atomic_load_n(&load->state, __ATOMIC_ACQUIRE);
+  if (state == 1 && GpuFenceWait(load->fence, 0)) {
+    GpuFenceFree(load->fence);
+    load->fence = NULL;
+    load->state = state = 2;
+  }
+  return state == 2;
+}
@@ -9,7 +9,7 @@
     and      rsp,-16
     call     main
     mov      rdi,rax
-    mov      rax,60
+    mov      rax,231
     syscall
     ret
 
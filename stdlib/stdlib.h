@@ -136,6 +136,10 @@ static inline int close(int fd) {
   return (int)syscall1(3, (long)fd);
 }
 
+static inline off_t lseek(int fd, off_t offset, int whence) {
+  return (off_t)syscall3(8, (long)fd, (long)offset, (long)whence);
+}
+
 static inline void * mmap(void * start, size_t len, int prot, int flags, int fd, off_t off) {
   return syscall6(9, (long)start, (long)len, (long)prot, (long)flags, (long)fd, (long)off);
 }
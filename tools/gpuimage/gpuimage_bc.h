@@ -0,0 +1,328 @@
+#pragma once
+
+// BC1 (DXT1) and BC3 (DXT5) block encoder. Endpoints come from the principal axis of the block colors and are
+// refined by least squares, palette index selection is the hot loop and has scalar, SSE2 and AVX2 versions that
+// are picked at runtime.
+
+#include <immintrin.h>
+#include <string.h>
+
+enum gpuimage_simd_e {
+  gpuimage_simd_scalar_e,
+  gpuimage_simd_sse2_e,
+  gpuimage_simd_avx2_e,
+};
+
+struct gpuimage_block_t {
+  float r[16];
+  float g[16];
+  float b[16];
+  float a[16];
+};
+
+// Returns the squared error, indices are packed 2 bits per pixel
+static inline float GpuImageBcFitScalar(struct gpuimage_block_t * block, float palette[4][3], unsigned * out_indices) {
+  float error = 0;
+  unsigned indices = 0;
+  for (int i = 0; i < 16; i += 1) {
+    float best = 1e30f;
+    unsigned best_k = 0;
+    for (unsigned k = 0; k < 4; k += 1) {
+      float dr = block->r[i] - palette[k][0];
+      float dg = block->g[i] - palette[k][1];
+      float db = block->b[i] - palette[k][2];
+      float d = dr * dr + dg * dg + db * db;
+      if (d < best) {
+        best = d;
+        best_k = k;
+      }
+    }
+    error += best;
+    indices |= best_k << (2 * i);
+  }
+  out_indices[0] = indices;
+  return error;
+}
+
+__attribute__((target("sse2")))
+static inline float GpuImageBcFitSse2(struct gpuimage_block_t * block, float palette[4][3], unsigned * out_indices) {
+  __m128 error = _mm_setzero_ps();
+  unsigned indices = 0;
+  for (int i = 0; i < 16; i += 4) {
+    __m128 r = _mm_loadu_ps(&block->r[i]);
+    __m128 g = _mm_loadu_ps(&block->g[i]);
+    __m128 b = _mm_loadu_ps(&block->b[i]);
+    __m128 best = _mm_set1_ps(1e30f);
+    __m128 best_k = _mm_setzero_ps();
+    for (int k = 0; k < 4; k += 1) {
+      __m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[k][0]));
+      __m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[k][1]));
+      __m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[k][2]));
+      __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+      __m128 closer = _mm_cmplt_ps(d, best);
+      best = _mm_min_ps(d, best);
+      best_k = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps((float)k)), _mm_andnot_ps(closer, best_k));
+    }
+    error = _mm_add_ps(error, best);
+    int k[4];
+    _mm_storeu_si128((__m128i *)k, _mm_cvtps_epi32(best_k));
+    indices |= (k[0] | k[1] << 2 | k[2] << 4 | k[3] << 6) << (2 * i);
+  }
+  float e[4];
+  _mm_storeu_ps(e, error);
+  out_indices[0] = indices;
+  return e[0] + e[1] + e[2] + e[3];
+}
+
+__attribute__((target("avx2")))
+static inline float GpuImageBcFitAvx2(struct gpuimage_block_t * block, float palette[4][3], unsigned * out_indices) {
+  __m256 error = _mm256_setzero_ps();
+  unsigned indices = 0;
+  for (int i = 0; i < 16; i += 8) {
+    __m256 r = _mm256_loadu_ps(&block->r[i]);
+    __m256 g = _mm256_loadu_ps(&block->g[i]);
+    __m256 b = _mm256_loadu_ps(&block->b[i]);
+    __m256 best = _mm256_set1_ps(1e30f);
+    __m256i best_k = _mm256_setzero_si256();
+    for (int k = 0; k < 4; k += 1) {
+      __m256 dr = _mm256_sub_ps(r, _mm256_set1_ps(palette[k][0]));
+      __m256 dg = _mm256_sub_ps(g, _mm256_set1_ps(palette[k][1]));
+      __m256 db = _mm256_sub_ps(b, _mm256_set1_ps(palette[k][2]));
+      __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dr, dr), _mm256_mul_ps(dg, dg)), _mm256_mul_ps(db, db));
+      __m256i closer = _mm256_castps_si256(_mm256_cmp_ps(d, best, _CMP_LT_OQ));
+      best = _mm256_min_ps(d, best);
+      best_k = _mm256_blendv_epi8(best_k, _mm256_set1_epi32(k), closer);
+    }
+    error = _mm256_add_ps(error, best);
+    // Shift every lane's index into its 2-bit slot and OR the lanes together
+    __m256i shifted = _mm256_sllv_epi32(best_k, _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14));
+    __m128i lanes = _mm_or_si128(_mm256_castsi256_si128(shifted), _mm256_extracti128_si256(shifted, 1));
+    lanes = _mm_or_si128(lanes, _mm_shuffle_epi32(lanes, 0x4E));
+    lanes = _mm_or_si128(lanes, _mm_shuffle_epi32(lanes, 0xB1));
+    indices |= (unsigned)_mm_cvtsi128_si32(lanes) << (2 * i);
+  }
+  float e[8];
+  _mm256_storeu_ps(e, error);
+  out_indices[0] = indices;
+  return e[0] + e[1] + e[2] + e[3] + e[4] + e[5] + e[6] + e[7];
+}
+
+static inline unsigned GpuImageBc565(float r, float g, float b) {
+  int ri = (int)(r * (31.f / 255.f) + 0.5f);
+  int gi = (int)(g * (63.f / 255.f) + 0.5f);
+  int bi = (int)(b * (31.f / 255.f) + 0.5f);
+  ri = ri < 0 ? 0 : ri > 31 ? 31 : ri;
+  gi = gi < 0 ? 0 : gi > 63 ? 63 : gi;
+  bi = bi < 0 ? 0 : bi > 31 ? 31 : bi;
+  return (unsigned)(ri << 11 | gi << 5 | bi);
+}
+
+static inline void GpuImageBcExpand565(unsigned c, float * out_rgb) {
+  unsigned r = c >> 11 & 31;
+  unsigned g = c >> 5 & 63;
+  unsigned b = c & 31;
+  out_rgb[0] = (float)(r << 3 | r >> 2);
+  out_rgb[1] = (float)(g << 2 | g >> 4);
+  out_rgb[2] = (float)(b << 3 | b >> 2);
+}
+
+// Quantizes both endpoints, orders them for the 4 color mode and fits the indices
+static inline float GpuImageBcTry(
+    struct gpuimage_block_t * block, enum gpuimage_simd_e simd, float * e0, float * e1,
+    unsigned * out_c0, unsigned * out_c1, unsigned * out_indices)
+{
+  unsigned c0 = GpuImageBc565(e0[0], e0[1], e0[2]);
+  unsigned c1 = GpuImageBc565(e1[0], e1[1], e1[2]);
+  if (c0 < c1) {
+    unsigned c = c0;
+    c0 = c1;
+    c1 = c;
+  }
+  float palette[4][3];
+  GpuImageBcExpand565(c0, palette[0]);
+  GpuImageBcExpand565(c1, palette[1]);
+  for (int j = 0; j < 3; j += 1) {
+    palette[2][j] = (2 * palette[0][j] + palette[1][j]) / 3;
+    palette[3][j] = (palette[0][j] + 2 * palette[1][j]) / 3;
+  }
+  float error = 0;
+  unsigned indices = 0;
+  switch (simd) {
+    break; case gpuimage_simd_scalar_e: error = GpuImageBcFitScalar(block, palette, &indices);
+    break; case gpuimage_simd_sse2_e:   error = GpuImageBcFitSse2(block, palette, &indices);
+    break; case gpuimage_simd_avx2_e:   error = GpuImageBcFitAvx2(block, palette, &indices);
+  }
+  // Equal endpoints select the 3 color mode where index 3 is transparent black
+  if (c0 == c1)
+    indices = 0;
+  out_c0[0] = c0;
+  out_c1[0] = c1;
+  out_indices[0] = indices;
+  return error;
+}
+
+static inline void GpuImageBcColor(struct gpuimage_block_t * block, enum gpuimage_simd_e simd, unsigned char * out_block) {
+  float mean[3] = {0};
+  for (int i = 0; i < 16; i += 1) {
+    mean[0] += block->r[i] / 16;
+    mean[1] += block->g[i] / 16;
+    mean[2] += block->b[i] / 16;
+  }
+  float cov[6] = {0};
+  for (int i = 0; i < 16; i += 1) {
+    float r = block->r[i] - mean[0];
+    float g = block->g[i] - mean[1];
+    float b = block->b[i] - mean[2];
+    cov[0] += r * r;
+    cov[1] += r * g;
+    cov[2] += r * b;
+    cov[3] += g * g;
+    cov[4] += g * b;
+    cov[5] += b * b;
+  }
+  float axis[3] = {1, 1, 1};
+  for (int iteration = 0; iteration < 8; iteration += 1) {
+    float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+    float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+    float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+    float m = x * x > y * y ? x : y;
+    m = m * m > z * z ? m : z;
+    if (m == 0)
+      break;
+    axis[0] = x / m;
+    axis[1] = y / m;
+    axis[2] = z / m;
+  }
+  float length2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+  float t_min = 0;
+  float t_max = 0;
+  for (int i = 0; i < 16 && length2 > 0; i += 1) {
+    float t = ((block->r[i] - mean[0]) * axis[0] + (block->g[i] - mean[1]) * axis[1] + (block->b[i] - mean[2]) * axis[2]) / length2;
+    t_min = t < t_min ? t : t_min;
+    t_max = t > t_max ? t : t_max;
+  }
+  float e0[3];
+  float e1[3];
+  for (int j = 0; j < 3; j += 1) {
+    e0[j] = mean[j] + axis[j] * t_max;
+    e1[j] = mean[j] + axis[j] * t_min;
+  }
+  unsigned c0 = 0;
+  unsigned c1 = 0;
+  unsigned indices = 0;
+  float error = GpuImageBcTry(block, simd, e0, e1, &c0, &c1, &indices);
+
+  // Least squares endpoints for the chosen indices, kept only when they lower the error
+  static const float w0[4] = {1, 0, 2 / 3.f, 1 / 3.f};
+  for (int iteration = 0; iteration < 2 && error > 0; iteration += 1) {
+    float aa = 0, ab = 0, bb = 0;
+    float ap[3] = {0};
+    float bp[3] = {0};
+    for (int i = 0; i < 16; i += 1) {
+      float a = w0[indices >> (2 * i) & 3];
+      float b = 1 - a;
+      aa += a * a;
+      ab += a * b;
+      bb += b * b;
+      float p[3] = {block->r[i], block->g[i], block->b[i]};
+      for (int j = 0; j < 3; j += 1) {
+        ap[j] += a * p[j];
+        bp[j] += b * p[j];
+      }
+    }
+    float det = aa * bb - ab * ab;
+    if (det == 0)
+      break;
+    for (int j = 0; j < 3; j += 1) {
+      e0[j] = (ap[j] * bb - bp[j] * ab) / det;
+      e1[j] = (bp[j] * aa - ap[j] * ab) / det;
+    }
+    unsigned c0_new = 0;
+    unsigned c1_new = 0;
+    unsigned indices_new = 0;
+    float error_new = GpuImageBcTry(block, simd, e0, e1, &c0_new, &c1_new, &indices_new);
+    if (error_new >= error)
+      break;
+    error = error_new;
+    c0 = c0_new;
+    c1 = c1_new;
+    indices = indices_new;
+  }
+  out_block[0] = c0 & 255;
+  out_block[1] = c0 >> 8;
+  out_block[2] = c1 & 255;
+  out_block[3] = c1 >> 8;
+  out_block[4] = indices & 255;
+  out_block[5] = indices >> 8 & 255;
+  out_block[6] = indices >> 16 & 255;
+  out_block[7] = indices >> 24;
+}
+
+// 8 alpha levels between the block's max and min
+static inline void GpuImageBcAlpha(struct gpuimage_block_t * block, unsigned char * out_block) {
+  float a0 = block->a[0];
+  float a1 = block->a[0];
+  for (int i = 1; i < 16; i += 1) {
+    a0 = block->a[i] > a0 ? block->a[i] : a0;
+    a1 = block->a[i] < a1 ? block->a[i] : a1;
+  }
+  unsigned char q0 = (unsigned char)(a0 + 0.5f);
+  unsigned char q1 = (unsigned char)(a1 + 0.5f);
+  // Code 0 is a0, code 1 is a1, codes 2 to 7 step from a0 to a1
+  static const int code_of_step[8] = {0, 2, 3, 4, 5, 6, 7, 1};
+  unsigned long long bits = 0;
+  for (int i = 0; i < 16 && q0 != q1; i += 1) {
+    int step = (int)((q0 - block->a[i]) * 7 / (q0 - q1) + 0.5f);
+    step = step < 0 ? 0 : step > 7 ? 7 : step;
+    bits |= (unsigned long long)code_of_step[step] << (3 * i);
+  }
+  out_block[0] = q0;
+  out_block[1] = q1;
+  for (int i = 0; i < 6; i += 1)
+    out_block[2 + i] = bits >> (8 * i) & 255;
+}
+
+// rgba is width * height * 4 bytes, edge blocks repeat the last row and column
+static inline void GpuImageBcLoadBlock(unsigned char * rgba, int width, int height, int block_x, int block_y, struct gpuimage_block_t * out_block) {
+  for (int y = 0; y < 4; y += 1) {
+    for (int x = 0; x < 4; x += 1) {
+      int px = block_x * 4 + x < width  ? block_x * 4 + x : width  - 1;
+      int py = block_y * 4 + y < height ? block_y * 4 + y : height - 1;
+      unsigned char * p = &rgba[(py * width + px) * 4];
+      out_block->r[y * 4 + x] = p[0];
+      out_block->g[y * 4 + x] = p[1];
+      out_block->b[y * 4 + x] = p[2];
+      out_block->a[y * 4 + x] = p[3];
+    }
+  }
+}
+
+// Encodes block rows [row_first, row_end) of an image, blocks are 8 bytes for BC1 and 16 bytes for BC3
+static inline void GpuImageBcRows(
+    unsigned char * rgba, int width, int height, int is_bc3, enum gpuimage_simd_e simd,
+    int row_first, int row_end, unsigned char * out_blocks)
+{
+  int blocks_x = (width + 3) / 4;
+  int block_bytes = is_bc3 ? 16 : 8;
+  for (int by = row_first; by < row_end; by += 1) {
+    for (int bx = 0; bx < blocks_x; bx += 1) {
+      struct gpuimage_block_t block;
+      GpuImageBcLoadBlock(rgba, width, height, bx, by, &block);
+      unsigned char * out = &out_blocks[(by * blocks_x + bx) * block_bytes];
+      if (is_bc3) {
+        GpuImageBcAlpha(&block, out);
+        out += 8;
+      }
+      GpuImageBcColor(&block, simd, out);
+    }
+  }
+}
+
+static inline enum gpuimage_simd_e GpuImageBestSimd() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return gpuimage_simd_avx2_e;
+  if (__builtin_cpu_supports("sse2"))
+    return gpuimage_simd_sse2_e;
+  return gpuimage_simd_scalar_e;
+}
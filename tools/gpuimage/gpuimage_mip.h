@@ -0,0 +1,241 @@
+#pragma once
+
+// Mipmap downsampling with separable box, Kaiser-windowed sinc or Lanczos-3 filters on linear float RGBA.
+// Any size reduces to max(1, size / 2) per axis, weights are computed per output column and row, edges clamp.
+// The horizontal pass filters 4 channels of a pixel at once, the vertical pass runs along whole rows.
+
+#include <immintrin.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "gpuimage_bc.h"
+
+enum gpuimage_filter_e {
+  gpuimage_filter_box_e,
+  gpuimage_filter_kaiser_e,
+  gpuimage_filter_lanczos_e,
+};
+
+struct gpuimage_taps_t {
+  int taps;
+  int * index;
+  float * weights;
+};
+
+static inline float GpuImageSinc(float x) {
+  return x == 0 ? 1 : sinf((float)M_PI * x) / ((float)M_PI * x);
+}
+
+static inline float GpuImageBesselI0(float x) {
+  float sum = 1;
+  float term = 1;
+  for (int k = 1; k < 32; k += 1) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+// Radius in output pixels
+static inline float GpuImageFilterRadius(enum gpuimage_filter_e filter) {
+  switch (filter) {
+    break; case gpuimage_filter_box_e:     return 0.5f;
+    break; case gpuimage_filter_kaiser_e:  return 3;
+    break; case gpuimage_filter_lanczos_e: return 3;
+  }
+  return 0;
+}
+
+static inline float GpuImageFilter(enum gpuimage_filter_e filter, float x) {
+  float radius = GpuImageFilterRadius(filter);
+  if (fabsf(x) > radius)
+    return 0;
+  switch (filter) {
+    break; case gpuimage_filter_box_e: {
+      return 1;
+    }
+    break; case gpuimage_filter_kaiser_e: {
+      static const float alpha = 4;
+      float t = x / radius;
+      return GpuImageSinc(x) * GpuImageBesselI0(alpha * sqrtf(1 - t * t)) / GpuImageBesselI0(alpha);
+    }
+    break; case gpuimage_filter_lanczos_e: {
+      return GpuImageSinc(x) * GpuImageSinc(x / radius);
+    }
+  }
+  return 0;
+}
+
+static inline void GpuImageTaps(enum gpuimage_filter_e filter, int src, int dst, struct gpuimage_taps_t * out_taps) {
+  float scale = (float)src / dst;
+  float radius = GpuImageFilterRadius(filter) * scale;
+  int taps = (int)ceilf(radius * 2) + 1;
+  out_taps->taps = taps;
+  out_taps->index = malloc((size_t)dst * taps * sizeof(int));
+  out_taps->weights = malloc((size_t)dst * taps * sizeof(float));
+  for (int x = 0; x < dst; x += 1) {
+    float center = (x + 0.5f) * scale - 0.5f;
+    int first = (int)ceilf(center - radius);
+    float sum = 0;
+    for (int t = 0; t < taps; t += 1) {
+      int j = first + t;
+      float w = GpuImageFilter(filter, (j - center) / scale);
+      out_taps->index[x * taps + t] = j < 0 ? 0 : j >= src ? src - 1 : j;
+      out_taps->weights[x * taps + t] = w;
+      sum += w;
+    }
+    for (int t = 0; t < taps; t += 1)
+      out_taps->weights[x * taps + t] /= sum;
+  }
+}
+
+static inline void GpuImageTapsFree(struct gpuimage_taps_t * taps) {
+  free(taps->index);
+  free(taps->weights);
+}
+
+static inline void GpuImageMipRowsHScalar(float * src, int src_width, struct gpuimage_taps_t * taps, int dst_width, float * dst, int row_first, int row_end) {
+  for (int y = row_first; y < row_end; y += 1) {
+    for (int x = 0; x < dst_width; x += 1) {
+      float acc[4] = {0};
+      for (int t = 0; t < taps->taps; t += 1) {
+        float w = taps->weights[x * taps->taps + t];
+        float * p = &src[((size_t)y * src_width + taps->index[x * taps->taps + t]) * 4];
+        for (int c = 0; c < 4; c += 1)
+          acc[c] += w * p[c];
+      }
+      for (int c = 0; c < 4; c += 1)
+        dst[((size_t)y * dst_width + x) * 4 + c] = acc[c];
+    }
+  }
+}
+
+__attribute__((target("sse2")))
+static inline void GpuImageMipRowsHSse2(float * src, int src_width, struct gpuimage_taps_t * taps, int dst_width, float * dst, int row_first, int row_end) {
+  for (int y = row_first; y < row_end; y += 1) {
+    float * row = &src[(size_t)y * src_width * 4];
+    for (int x = 0; x < dst_width; x += 1) {
+      __m128 acc = _mm_setzero_ps();
+      for (int t = 0; t < taps->taps; t += 1)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps->weights[x * taps->taps + t]), _mm_loadu_ps(&row[taps->index[x * taps->taps + t] * 4])));
+      _mm_storeu_ps(&dst[((size_t)y * dst_width + x) * 4], acc);
+    }
+  }
+}
+
+// Two output pixels per register, both have the same tap count so their loops run together
+__attribute__((target("avx2,fma")))
+static inline void GpuImageMipRowsHAvx2(float * src, int src_width, struct gpuimage_taps_t * taps, int dst_width, float * dst, int row_first, int row_end) {
+  for (int y = row_first; y < row_end; y += 1) {
+    float * row = &src[(size_t)y * src_width * 4];
+    int x = 0;
+    for (; x + 2 <= dst_width; x += 2) {
+      __m256 acc = _mm256_setzero_ps();
+      for (int t = 0; t < taps->taps; t += 1) {
+        __m256 w = _mm256_set_m128(_mm_set1_ps(taps->weights[(x + 1) * taps->taps + t]), _mm_set1_ps(taps->weights[x * taps->taps + t]));
+        __m256 p = _mm256_set_m128(_mm_loadu_ps(&row[taps->index[(x + 1) * taps->taps + t] * 4]), _mm_loadu_ps(&row[taps->index[x * taps->taps + t] * 4]));
+        acc = _mm256_fmadd_ps(w, p, acc);
+      }
+      _mm256_storeu_ps(&dst[((size_t)y * dst_width + x) * 4], acc);
+    }
+    for (; x < dst_width; x += 1) {
+      __m128 acc = _mm_setzero_ps();
+      for (int t = 0; t < taps->taps; t += 1)
+        acc = _mm_fmadd_ps(_mm_set1_ps(taps->weights[x * taps->taps + t]), _mm_loadu_ps(&row[taps->index[x * taps->taps + t] * 4]), acc);
+      _mm_storeu_ps(&dst[((size_t)y * dst_width + x) * 4], acc);
+    }
+  }
+}
+
+static inline void GpuImageMipRowsVScalar(float * src, int width, struct gpuimage_taps_t * taps, float * dst, int row_first, int row_end) {
+  size_t n = (size_t)width * 4;
+  for (int y = row_first; y < row_end; y += 1) {
+    float * out = &dst[y * n];
+    for (size_t i = 0; i < n; i += 1)
+      out[i] = 0;
+    for (int t = 0; t < taps->taps; t += 1) {
+      float w = taps->weights[y * taps->taps + t];
+      float * in = &src[taps->index[y * taps->taps + t] * n];
+      for (size_t i = 0; i < n; i += 1)
+        out[i] += w * in[i];
+    }
+  }
+}
+
+__attribute__((target("sse2")))
+static inline void GpuImageMipRowsVSse2(float * src, int width, struct gpuimage_taps_t * taps, float * dst, int row_first, int row_end) {
+  size_t n = (size_t)width * 4;
+  for (int y = row_first; y < row_end; y += 1) {
+    float * out = &dst[y * n];
+    for (size_t i = 0; i < n; i += 4) {
+      __m128 acc = _mm_setzero_ps();
+      for (int t = 0; t < taps->taps; t += 1)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps->weights[y * taps->taps + t]), _mm_loadu_ps(&src[taps->index[y * taps->taps + t] * n + i])));
+      _mm_storeu_ps(&out[i], acc);
+    }
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static inline void GpuImageMipRowsVAvx2(float * src, int width, struct gpuimage_taps_t * taps, float * dst, int row_first, int row_end) {
+  size_t n = (size_t)width * 4;
+  for (int y = row_first; y < row_end; y += 1) {
+    float * out = &dst[y * n];
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m256 acc = _mm256_setzero_ps();
+      for (int t = 0; t < taps->taps; t += 1)
+        acc = _mm256_fmadd_ps(_mm256_set1_ps(taps->weights[y * taps->taps + t]), _mm256_loadu_ps(&src[taps->index[y * taps->taps + t] * n + i]), acc);
+      _mm256_storeu_ps(&out[i], acc);
+    }
+    for (; i < n; i += 4) {
+      __m128 acc = _mm_setzero_ps();
+      for (int t = 0; t < taps->taps; t += 1)
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps->weights[y * taps->taps + t]), _mm_loadu_ps(&src[taps->index[y * taps->taps + t] * n + i])));
+      _mm_storeu_ps(&out[i], acc);
+    }
+  }
+}
+
+static inline void GpuImageMipRowsH(enum gpuimage_simd_e simd, float * src, int src_width, struct gpuimage_taps_t * taps, int dst_width, float * dst, int row_first, int row_end) {
+  switch (simd) {
+    break; case gpuimage_simd_scalar_e: GpuImageMipRowsHScalar(src, src_width, taps, dst_width, dst, row_first, row_end);
+    break; case gpuimage_simd_sse2_e:   GpuImageMipRowsHSse2(src, src_width, taps, dst_width, dst, row_first, row_end);
+    break; case gpuimage_simd_avx2_e:   GpuImageMipRowsHAvx2(src, src_width, taps, dst_width, dst, row_first, row_end);
+  }
+}
+
+static inline void GpuImageMipRowsV(enum gpuimage_simd_e simd, float * src, int width, struct gpuimage_taps_t * taps, float * dst, int row_first, int row_end) {
+  switch (simd) {
+    break; case gpuimage_simd_scalar_e: GpuImageMipRowsVScalar(src, width, taps, dst, row_first, row_end);
+    break; case gpuimage_simd_sse2_e:   GpuImageMipRowsVSse2(src, width, taps, dst, row_first, row_end);
+    break; case gpuimage_simd_avx2_e:   GpuImageMipRowsVAvx2(src, width, taps, dst, row_first, row_end);
+  }
+}
+
+static inline float GpuImageSrgbToLinear(float c) {
+  return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static inline float GpuImageLinearToSrgb(float c) {
+  return c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1 / 2.4f) - 0.055f;
+}
+
+// Alpha is never gamma corrected
+static inline void GpuImageToFloat(unsigned char * rgba, ptrdiff_t pixels, int gamma, float * out) {
+  float lut[256];
+  for (int i = 0; i < 256; i += 1)
+    lut[i] = gamma ? GpuImageSrgbToLinear(i / 255.f) : i / 255.f;
+  for (ptrdiff_t i = 0; i < pixels * 4; i += 1)
+    out[i] = (i & 3) == 3 ? rgba[i] / 255.f : lut[rgba[i]];
+}
+
+// Negative filter lobes can overshoot, values are clamped before quantizing
+static inline void GpuImageToBytes(float * rgbaf, ptrdiff_t pixels, int gamma, unsigned char * out) {
+  for (ptrdiff_t i = 0; i < pixels * 4; i += 1) {
+    float c = rgbaf[i] < 0 ? 0 : rgbaf[i] > 1 ? 1 : rgbaf[i];
+    if (gamma && (i & 3) != 3)
+      c = GpuImageLinearToSrgb(c);
+    out[i] = (unsigned char)(c * 255 + 0.5f);
+  }
+}
@@ -0,0 +1,606 @@
+// Converts BMP and PPM images into gpulib's texture container (struct gpu_img_file_t), loaded with GpuLoadImgFile.
+// Every input is a layer, or a cubemap face with -cube in +X -X +Y -Y +Z -Z order. Inputs are read, hashed and
+// decoded in parallel, an output whose options and input contents hash the same as last time is skipped.
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gpuimage_bc.h"
+#include "gpuimage_mip.h"
+
+// Must match the container definitions in gpulib.h
+#define GPULIB_IMG_FILE_MAGIC     (0x49555047) // "GPUI"
+#define GPULIB_IMG_FILE_VERSION   (1)
+#define GPULIB_IMG_FILE_ALIGNMENT (4096)
+
+struct gpu_img_file_t {
+  unsigned magic;
+  unsigned version;
+  unsigned format;
+  unsigned pixel_format;
+  unsigned pixel_type;
+  int width;
+  int height;
+  int layer_count;
+  int face_count;
+  int mipmap_count;
+  unsigned long file_bytes;
+};
+
+struct gpu_img_file_sub_t {
+  unsigned long bytes_first;
+  unsigned long bytes_count;
+};
+
+enum gpuimage_format_e {
+  gpuimage_rgba_e,
+  gpuimage_bc1_e,
+  gpuimage_bc3_e,
+};
+
+struct gpuimage_sub_t {
+  float * linear;
+  unsigned char * rgba;
+  int width;
+  int height;
+  unsigned char * out;
+  unsigned long out_bytes;
+};
+
+struct gpuimage_t {
+  enum gpuimage_format_e format;
+  enum gpuimage_simd_e simd;
+  enum gpuimage_filter_e filter;
+  int gamma;
+  int subs_count;
+  struct gpuimage_sub_t * subs;
+  int layers_count;
+  int mipmap;
+  struct gpuimage_taps_t taps_x;
+  struct gpuimage_taps_t taps_y;
+  float ** tmp;
+  int * job_sub;
+  int * job_row;
+};
+
+struct gpuimage_parallel_t {
+  int next;
+  int count;
+  void (*fn)(void *, int);
+  void * userdata;
+};
+
+struct gpuimage_input_t {
+  char * filepath;
+  unsigned char * file;
+  long bytes;
+  unsigned long long hash;
+  unsigned char * rgba;
+  int width;
+  int height;
+};
+
+enum {GPUIMAGE_JOB_ROWS = 8};
+
+// Bump when the output of the same options and inputs changes, forces incremental rebuilds
+enum {GPUIMAGE_VERSION = 2};
+
+static unsigned char * DecodeBmp(unsigned char * file, long bytes, int * out_width, int * out_height) {
+  if (bytes < 54 || file[0] != 'B' || file[1] != 'M')
+    return NULL;
+  unsigned offset = file[10] | file[11] << 8 | file[12] << 16 | (unsigned)file[13] << 24;
+  int width = file[18] | file[19] << 8 | file[20] << 16 | file[21] << 24;
+  int height = file[22] | file[23] << 8 | file[24] << 16 | file[25] << 24;
+  int bits = file[28] | file[29] << 8;
+  int compression = file[30] | file[31] << 8;
+  int top_down = height < 0;
+  height = top_down ? -height : height;
+  int stride = (width * (bits / 8) + 3) & ~3;
+  if ((bits != 24 && bits != 32) || (compression != 0 && compression != 3) || offset + (long)stride * height > bytes)
+    return NULL;
+  // Rows are stored top to bottom, the same order the old .binary files used
+  unsigned char * rgba = malloc((size_t)width * height * 4);
+  for (int y = 0; y < height; y += 1) {
+    unsigned char * row = &file[offset + (long)stride * (top_down ? y : height - 1 - y)];
+    for (int x = 0; x < width; x += 1) {
+      unsigned char * p = &row[x * (bits / 8)];
+      unsigned char * q = &rgba[((size_t)y * width + x) * 4];
+      q[0] = p[2];
+      q[1] = p[1];
+      q[2] = p[0];
+      q[3] = bits == 32 ? p[3] : 255;
+    }
+  }
+  out_width[0] = width;
+  out_height[0] = height;
+  return rgba;
+}
+
+// Skips whitespace and comments, returns -1 past the end
+static int PpmNumber(unsigned char * file, long bytes, long * cursor) {
+  long i = cursor[0];
+  while (i < bytes && (file[i] == ' ' || file[i] == '\t' || file[i] == '\r' || file[i] == '\n' || file[i] == '#')) {
+    if (file[i] == '#')
+      while (i < bytes && file[i] != '\n')
+        i += 1;
+    else
+      i += 1;
+  }
+  if (i >= bytes || file[i] < '0' || file[i] > '9')
+    return -1;
+  int n = 0;
+  while (i < bytes && file[i] >= '0' && file[i] <= '9')
+    n = n * 10 + (file[i++] - '0');
+  cursor[0] = i;
+  return n;
+}
+
+// Binary P6 and ASCII P3, 16-bit samples keep their high byte
+static unsigned char * DecodePpm(unsigned char * file, long bytes, int * out_width, int * out_height) {
+  if (bytes < 3 || file[0] != 'P' || (file[1] != '6' && file[1] != '3'))
+    return NULL;
+  long cursor = 2;
+  int width = PpmNumber(file, bytes, &cursor);
+  int height = PpmNumber(file, bytes, &cursor);
+  int max = PpmNumber(file, bytes, &cursor);
+  int sample_bytes = max > 255 ? 2 : 1;
+  if (width <= 0 || height <= 0 || max <= 0 || max > 65535)
+    return NULL;
+  cursor += 1;
+  if (file[1] == '6' && cursor + (long)width * height * 3 * sample_bytes > bytes)
+    return NULL;
+  unsigned char * rgba = malloc((size_t)width * height * 4);
+  for (size_t i = 0; i < (size_t)width * height * 4; i += 1) {
+    if ((i & 3) == 3) {
+      rgba[i] = 255;
+      continue;
+    }
+    int v = 0;
+    if (file[1] == '6') {
+      v = sample_bytes == 2 ? file[cursor] << 8 | file[cursor + 1] : file[cursor];
+      cursor += sample_bytes;
+    } else {
+      v = PpmNumber(file, bytes, &cursor);
+      if (v < 0) {
+        free(rgba);
+        return NULL;
+      }
+    }
+    rgba[i] = (unsigned char)((v * 255 + max / 2) / max);
+  }
+  out_width[0] = width;
+  out_height[0] = height;
+  return rgba;
+}
+
+// FNV-1a over 8 byte words with a final avalanche, only used to detect changed inputs
+static unsigned long long Hash(unsigned char * p, long bytes, unsigned long long hash) {
+  long i = 0;
+  for (; i + 8 <= bytes; i += 8) {
+    unsigned long long word;
+    memcpy(&word, &p[i], 8);
+    hash = (hash ^ word) * 0x100000001B3ull;
+  }
+  for (; i < bytes; i += 1)
+    hash = (hash ^ p[i]) * 0x100000001B3ull;
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+static void ReadJob(void * userdata, int job) {
+  struct gpuimage_input_t * input = &((struct gpuimage_input_t *)userdata)[job];
+  FILE * f = fopen(input->filepath, "rb");
+  if (f == NULL)
+    return;
+  fseek(f, 0, SEEK_END);
+  input->bytes = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  input->file = malloc(input->bytes > 0 ? input->bytes : 1);
+  if ((long)fread(input->file, 1, input->bytes, f) != input->bytes) {
+    free(input->file);
+    input->file = NULL;
+  }
+  fclose(f);
+  if (input->file != NULL)
+    input->hash = Hash(input->file, input->bytes, 0xCBF29CE484222325ull);
+}
+
+static void DecodeJob(void * userdata, int job) {
+  struct gpuimage_input_t * input = &((struct gpuimage_input_t *)userdata)[job];
+  input->rgba = DecodeBmp(input->file, input->bytes, &input->width, &input->height);
+  if (input->rgba == NULL)
+    input->rgba = DecodePpm(input->file, input->bytes, &input->width, &input->height);
+  free(input->file);
+  input->file = NULL;
+}
+
+static void SwizzleJob(void * userdata, int job) {
+  struct gpuimage_sub_t * sub = &((struct gpuimage_sub_t *)userdata)[job];
+  for (size_t i = 0; i < (size_t)sub->width * sub->height * 4; i += 4) {
+    unsigned char r = sub->out[i];
+    sub->out[i] = sub->out[i + 2];
+    sub->out[i + 2] = r;
+  }
+}
+
+static void * ParallelWorker(void * userdata) {
+  struct gpuimage_parallel_t * parallel = userdata;
+  for (int job = __atomic_fetch_add(&parallel->next, 1, __ATOMIC_RELAXED); job < parallel->count; job = __atomic_fetch_add(&parallel->next, 1, __ATOMIC_RELAXED))
+    parallel->fn(parallel->userdata, job);
+  return NULL;
+}
+
+// Threads pick up jobs as they finish, the calling thread is one of them
+static void ParallelFor(void * userdata, int count, int threads_count, void (*fn)(void *, int)) {
+  struct gpuimage_parallel_t parallel = {.count = count, .fn = fn, .userdata = userdata};
+  pthread_t threads[64];
+  threads_count = threads_count < 64 ? threads_count : 64;
+  for (int i = 1; i < threads_count; i += 1)
+    pthread_create(&threads[i], NULL, ParallelWorker, &parallel);
+  ParallelWorker(&parallel);
+  for (int i = 1; i < threads_count; i += 1)
+    pthread_join(threads[i], NULL);
+}
+
+static int RowJobs(int rows) {
+  return (rows + GPUIMAGE_JOB_ROWS - 1) / GPUIMAGE_JOB_ROWS;
+}
+
+static void MipJobH(void * userdata, int job) {
+  struct gpuimage_t * image = userdata;
+  struct gpuimage_sub_t * src = &image->subs[(image->mipmap - 1) * image->layers_count];
+  int jobs = RowJobs(src->height);
+  int layer = job / jobs;
+  int row_first = job % jobs * GPUIMAGE_JOB_ROWS;
+  int row_end = row_first + GPUIMAGE_JOB_ROWS < src->height ? row_first + GPUIMAGE_JOB_ROWS : src->height;
+  struct gpuimage_sub_t * dst = &image->subs[image->mipmap * image->layers_count + layer];
+  GpuImageMipRowsH(image->simd, src[layer].linear, src->width, &image->taps_x, dst->width, image->tmp[layer], row_first, row_end);
+}
+
+static void MipJobV(void * userdata, int job) {
+  struct gpuimage_t * image = userdata;
+  struct gpuimage_sub_t * dst = &image->subs[image->mipmap * image->layers_count];
+  int jobs = RowJobs(dst->height);
+  int layer = job / jobs;
+  int row_first = job % jobs * GPUIMAGE_JOB_ROWS;
+  int row_end = row_first + GPUIMAGE_JOB_ROWS < dst->height ? row_first + GPUIMAGE_JOB_ROWS : dst->height;
+  GpuImageMipRowsV(image->simd, image->tmp[layer], dst->width, &image->taps_y, dst[layer].linear, row_first, row_end);
+}
+
+static void MipJobBytes(void * userdata, int job) {
+  struct gpuimage_t * image = userdata;
+  struct gpuimage_sub_t * sub = &image->subs[image->mipmap * image->layers_count + job];
+  sub->rgba = malloc((size_t)sub->width * sub->height * 4);
+  GpuImageToBytes(sub->linear, (ptrdiff_t)sub->width * sub->height, image->gamma, sub->rgba);
+}
+
+// Every level is filtered from the previous one in linear float, only the stored copies are quantized
+static void Mips(struct gpuimage_t * image, int mipmap_count, int threads_count) {
+  int layers = image->layers_count;
+  for (int i = 0; i < layers; i += 1) {
+    struct gpuimage_sub_t * sub = &image->subs[i];
+    sub->linear = malloc((size_t)sub->width * sub->height * 4 * sizeof(float));
+    GpuImageToFloat(sub->rgba, (ptrdiff_t)sub->width * sub->height, image->gamma, sub->linear);
+  }
+  image->tmp = calloc(layers, sizeof(float *));
+  for (int m = 1; m < mipmap_count; m += 1) {
+    struct gpuimage_sub_t * src = &image->subs[(m - 1) * layers];
+    int width = src->width > 1 ? src->width / 2 : 1;
+    int height = src->height > 1 ? src->height / 2 : 1;
+    for (int i = 0; i < layers; i += 1) {
+      struct gpuimage_sub_t * dst = &image->subs[m * layers + i];
+      dst->width = width;
+      dst->height = height;
+      dst->linear = malloc((size_t)width * height * 4 * sizeof(float));
+      image->tmp[i] = realloc(image->tmp[i], (size_t)width * src->height * 4 * sizeof(float));
+    }
+    image->mipmap = m;
+    GpuImageTaps(image->filter, src->width, width, &image->taps_x);
+    GpuImageTaps(image->filter, src->height, height, &image->taps_y);
+    ParallelFor(image, layers * RowJobs(src->height), threads_count, MipJobH);
+    ParallelFor(image, layers * RowJobs(height), threads_count, MipJobV);
+    ParallelFor(image, layers, threads_count, MipJobBytes);
+    GpuImageTapsFree(&image->taps_x);
+    GpuImageTapsFree(&image->taps_y);
+  }
+}
+
+static void EncodeJob(void * userdata, int job) {
+  struct gpuimage_t * image = userdata;
+  struct gpuimage_sub_t * sub = &image->subs[image->job_sub[job]];
+  int rows = (sub->height + 3) / 4;
+  int row_first = image->job_row[job];
+  int row_end = row_first + GPUIMAGE_JOB_ROWS < rows ? row_first + GPUIMAGE_JOB_ROWS : rows;
+  GpuImageBcRows(sub->rgba, sub->width, sub->height, image->format == gpuimage_bc3_e, image->simd, row_first, row_end, sub->out);
+}
+
+// Splits every subresource into runs of block rows
+static void Encode(struct gpuimage_t * image, int threads_count) {
+  int jobs_count = 0;
+  for (int s = 0; s < image->subs_count; s += 1)
+    jobs_count += RowJobs((image->subs[s].height + 3) / 4);
+  image->job_sub = malloc(jobs_count * sizeof(int));
+  image->job_row = malloc(jobs_count * sizeof(int));
+  for (int s = 0, j = 0; s < image->subs_count; s += 1) {
+    for (int row = 0; row < (image->subs[s].height + 3) / 4; row += GPUIMAGE_JOB_ROWS, j += 1) {
+      image->job_sub[j] = s;
+      image->job_row[j] = row;
+    }
+  }
+  ParallelFor(image, jobs_count, threads_count, EncodeJob);
+  free(image->job_sub);
+  free(image->job_row);
+}
+
+static double Seconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int Usage() {
+  fprintf(stderr,
+      "Usage: gpuimage [-rgba | -bgra | -bc1 | -bc3] [-srgb] [-cube] [-mips] [-box | -kaiser | -lanczos] [-linear] [-threads N] [-force] [-bench] [-o out.gpuimg] input.bmp|input.ppm...\n"
+      "       gpuimage [options] -list manifest.txt\n"
+      "  -rgba     uncompressed RGBA8, the default\n"
+      "  -bgra     uncompressed RGBA8 stored as BGRA, the GpuPixLayout of RGBA8 that uploads without a repack\n"
+      "  -bc1      S3TC DXT1, 4 bits per pixel, alpha is dropped\n"
+      "  -bc3      S3TC DXT5, 8 bits per pixel\n"
+      "  -srgb     sRGB texture formats\n"
+      "  -cube     every 6 inputs are one cubemap layer in +X -X +Y -Y +Z -Z order\n"
+      "  -mips     store a full mipmap chain, filtered offline so loading never generates mipmaps\n"
+      "  -kaiser   Kaiser-windowed sinc mipmap filter, the default\n"
+      "  -lanczos  Lanczos-3 mipmap filter\n"
+      "  -box      2x2 box mipmap filter\n"
+      "  -linear   filter color as stored instead of converting sRGB to linear first, for data textures\n"
+      "  -threads  decoder and encoder threads, defaults to the number of cores\n"
+      "  -force    rebuild even if out.gpuimg.hash matches the options and input contents\n"
+      "  -bench    time the BC encoder on the inputs with every SIMD path instead of writing a file\n"
+      "  -list     convert one output per manifest line, each line holds the options and inputs of one output,\n"
+      "            options given before -list apply to every line\n");
+  return 1;
+}
+
+// Returns 0 on success or when the output is up to date
+static int Convert(int argc, char ** argv) {
+  enum gpuimage_format_e format = gpuimage_rgba_e;
+  int bgra = 0;
+  int force = 0;
+  int srgb = 0;
+  int cube = 0;
+  int mips = 0;
+  int bench = 0;
+  int gamma = 1;
+  enum gpuimage_filter_e filter = gpuimage_filter_kaiser_e;
+  int threads_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  char * out_filepath = "gpuimage.gpuimg";
+  char ** inputs = malloc(argc * sizeof(char *));
+  int inputs_count = 0;
+  for (int i = 1; i < argc; i += 1) {
+    if      (strcmp(argv[i], "-rgba") == 0) format = gpuimage_rgba_e, bgra = 0;
+    else if (strcmp(argv[i], "-bgra") == 0) format = gpuimage_rgba_e, bgra = 1;
+    else if (strcmp(argv[i], "-force") == 0) force = 1;
+    else if (strcmp(argv[i], "-bc1") == 0)  format = gpuimage_bc1_e, bgra = 0;
+    else if (strcmp(argv[i], "-bc3") == 0)  format = gpuimage_bc3_e, bgra = 0;
+    else if (strcmp(argv[i], "-srgb") == 0) srgb = 1;
+    else if (strcmp(argv[i], "-cube") == 0) cube = 1;
+    else if (strcmp(argv[i], "-mips") == 0) mips = 1;
+    else if (strcmp(argv[i], "-bench") == 0) bench = 1;
+    else if (strcmp(argv[i], "-linear") == 0) gamma = 0;
+    else if (strcmp(argv[i], "-box") == 0) filter = gpuimage_filter_box_e;
+    else if (strcmp(argv[i], "-kaiser") == 0) filter = gpuimage_filter_kaiser_e;
+    else if (strcmp(argv[i], "-lanczos") == 0) filter = gpuimage_filter_lanczos_e;
+    else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) threads_count = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_filepath = argv[++i];
+    else if (argv[i][0] == '-') return Usage();
+    else inputs[inputs_count++] = argv[i];
+  }
+  int face_count = cube ? 6 : 1;
+  if (inputs_count == 0 || inputs_count % face_count != 0)
+    return Usage();
+  threads_count = threads_count > 0 ? threads_count : 1;
+
+  struct gpuimage_input_t * loaded = calloc(inputs_count, sizeof(struct gpuimage_input_t));
+  for (int i = 0; i < inputs_count; i += 1)
+    loaded[i].filepath = inputs[i];
+  ParallelFor(loaded, inputs_count, threads_count, ReadJob);
+
+  // Everything that changes the output bytes, thread count and input paths don't
+  unsigned options[] = {GPUIMAGE_VERSION, format, bgra, srgb, cube, mips, gamma, filter, inputs_count};
+  unsigned long long hash = Hash((unsigned char *)options, sizeof(options), 0xCBF29CE484222325ull);
+  for (int i = 0; i < inputs_count; i += 1) {
+    if (loaded[i].file == NULL) {
+      fprintf(stderr, "gpuimage: can't read %s\n", inputs[i]);
+      return 1;
+    }
+    hash = Hash((unsigned char *)&loaded[i].hash, sizeof(loaded[i].hash), hash);
+  }
+  char hash_string[17] = {0};
+  snprintf(hash_string, sizeof(hash_string), "%016llx", hash);
+  char * hash_filepath = malloc(strlen(out_filepath) + sizeof(".hash"));
+  sprintf(hash_filepath, "%s.hash", out_filepath);
+  if (!force && !bench && access(out_filepath, F_OK) == 0) {
+    char stored[17] = {0};
+    FILE * f = fopen(hash_filepath, "rb");
+    if (f != NULL) {
+      size_t n = fread(stored, 1, 16, f);
+      fclose(f);
+      if (n == 16 && strcmp(stored, hash_string) == 0) {
+        printf("%s is up to date\n", out_filepath);
+        for (int i = 0; i < inputs_count; i += 1)
+          free(loaded[i].file);
+        free(loaded);
+        free(inputs);
+        free(hash_filepath);
+        return 0;
+      }
+    }
+  }
+
+  ParallelFor(loaded, inputs_count, threads_count, DecodeJob);
+  int width = loaded[0].width;
+  int height = loaded[0].height;
+  for (int i = 0; i < inputs_count; i += 1) {
+    if (loaded[i].rgba == NULL) {
+      fprintf(stderr, "gpuimage: can't decode %s, only 24 and 32 bit uncompressed BMPs and P3 or P6 PPMs are supported\n", inputs[i]);
+      return 1;
+    }
+    if (loaded[i].width != width || loaded[i].height != height) {
+      fprintf(stderr, "gpuimage: %s is %dx%d, previous inputs are %dx%d\n", inputs[i], loaded[i].width, loaded[i].height, width, height);
+      return 1;
+    }
+  }
+
+  int mipmap_count = 1;
+  while (mips && (width >> mipmap_count > 0 || height >> mipmap_count > 0))
+    mipmap_count += 1;
+
+  // Subresources in container order: mipmap, then layer, then face
+  struct gpuimage_t image = {.format = format, .simd = GpuImageBestSimd(), .filter = filter, .gamma = gamma};
+  image.subs_count = mipmap_count * inputs_count;
+  image.subs = calloc(image.subs_count, sizeof(struct gpuimage_sub_t));
+  image.layers_count = inputs_count;
+  for (int i = 0; i < inputs_count; i += 1)
+    image.subs[i] = (struct gpuimage_sub_t){.rgba = loaded[i].rgba, .width = width, .height = height};
+  if (mipmap_count > 1) {
+    double t = Seconds();
+    Mips(&image, mipmap_count, threads_count);
+    if (bench)
+      printf("mipmaps: %.1f ms on %d threads\n", (Seconds() - t) * 1000, threads_count);
+  }
+  for (int s = 0; s < image.subs_count; s += 1) {
+    struct gpuimage_sub_t * sub = &image.subs[s];
+    if (format == gpuimage_rgba_e)
+      sub->out_bytes = (unsigned long)sub->width * sub->height * 4;
+    else
+      sub->out_bytes = (unsigned long)((sub->width + 3) / 4) * ((sub->height + 3) / 4) * (format == gpuimage_bc3_e ? 16 : 8);
+    sub->out = format == gpuimage_rgba_e ? sub->rgba : malloc(sub->out_bytes);
+  }
+
+  if (bench) {
+    static char * names[] = {"scalar", "sse2", "avx2"};
+    if (format == gpuimage_rgba_e)
+      image.format = gpuimage_bc1_e;
+    double pixels = 0;
+    for (int s = 0; s < image.subs_count; s += 1)
+      pixels += (double)image.subs[s].width * image.subs[s].height;
+    for (int simd = gpuimage_simd_scalar_e; simd <= (int)GpuImageBestSimd(); simd += 1) {
+      image.simd = simd;
+      double t = Seconds();
+      Encode(&image, 1);
+      double t_one = Seconds() - t;
+      t = Seconds();
+      Encode(&image, threads_count);
+      double t_all = Seconds() - t;
+      printf("%s %s: %.1f Mpix/s on 1 thread, %.1f Mpix/s on %d threads\n",
+          image.format == gpuimage_bc3_e ? "bc3" : "bc1", names[simd], pixels / t_one * 1e-6, pixels / t_all * 1e-6, threads_count);
+    }
+    return 0;
+  }
+
+  if (format != gpuimage_rgba_e)
+    Encode(&image, threads_count);
+  if (bgra)
+    ParallelFor(image.subs, image.subs_count, threads_count, SwizzleJob);
+
+  static const unsigned formats[3][2] = {
+    {0x8058, 0x8C43}, // GL_RGBA8, GL_SRGB8_ALPHA8
+    {0x83F0, 0x8C4C}, // GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+    {0x83F3, 0x8C4F}, // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+  };
+  struct gpu_img_file_t header = {
+    .magic        = GPULIB_IMG_FILE_MAGIC,
+    .version      = GPULIB_IMG_FILE_VERSION,
+    .format       = formats[format][srgb],
+    .pixel_format = format == gpuimage_rgba_e ? (bgra ? 0x80E1 : 0x1908) : 0, // GL_BGRA, GL_RGBA
+    .pixel_type   = format == gpuimage_rgba_e ? (bgra ? 0x8367 : 0x1401) : 0, // GL_UNSIGNED_INT_8_8_8_8_REV, GL_UNSIGNED_BYTE
+    .width        = width,
+    .height       = height,
+    .layer_count  = inputs_count / face_count,
+    .face_count   = face_count,
+    .mipmap_count = mipmap_count,
+  };
+  struct gpu_img_file_sub_t * table = calloc(image.subs_count, sizeof(struct gpu_img_file_sub_t));
+  unsigned long offset = sizeof(header) + image.subs_count * sizeof(struct gpu_img_file_sub_t);
+  for (int s = 0; s < image.subs_count; s += 1) {
+    offset = (offset + GPULIB_IMG_FILE_ALIGNMENT - 1) / GPULIB_IMG_FILE_ALIGNMENT * GPULIB_IMG_FILE_ALIGNMENT;
+    table[s].bytes_first = offset;
+    table[s].bytes_count = image.subs[s].out_bytes;
+    offset += image.subs[s].out_bytes;
+  }
+  header.file_bytes = offset;
+
+  FILE * f = fopen(out_filepath, "wb");
+  if (f == NULL) {
+    fprintf(stderr, "gpuimage: can't write %s\n", out_filepath);
+    return 1;
+  }
+  static unsigned char zeros[GPULIB_IMG_FILE_ALIGNMENT];
+  fwrite(&header, sizeof(header), 1, f);
+  fwrite(table, sizeof(struct gpu_img_file_sub_t), image.subs_count, f);
+  unsigned long written = sizeof(header) + image.subs_count * sizeof(struct gpu_img_file_sub_t);
+  for (int s = 0; s < image.subs_count; s += 1) {
+    fwrite(zeros, 1, table[s].bytes_first - written, f);
+    fwrite(image.subs[s].out, 1, table[s].bytes_count, f);
+    written = table[s].bytes_first + table[s].bytes_count;
+  }
+  fclose(f);
+
+  // Written last, an interrupted conversion never looks up to date
+  f = fopen(hash_filepath, "wb");
+  if (f != NULL) {
+    fputs(hash_string, f);
+    fclose(f);
+  }
+  printf("%s: %dx%d, %d layers, %d mipmaps, %lu bytes\n", out_filepath, width, height, inputs_count / face_count, mipmap_count, header.file_bytes);
+
+  for (int s = 0; s < image.subs_count; s += 1) {
+    if (image.subs[s].out != image.subs[s].rgba)
+      free(image.subs[s].out);
+    free(image.subs[s].rgba);
+  }
+  free(image.subs);
+  free(table);
+  free(loaded);
+  free(inputs);
+  free(hash_filepath);
+  return 0;
+}
+
+int main(int argc, char ** argv) {
+  int list = 0;
+  for (int i = 1; i < argc; i += 1)
+    list = strcmp(argv[i], "-list") == 0 ? i : list;
+  if (list == 0)
+    return Convert(argc, argv);
+  if (list + 1 >= argc)
+    return Usage();
+
+  FILE * f = fopen(argv[list + 1], "rb");
+  if (f == NULL) {
+    fprintf(stderr, "gpuimage: can't read %s\n", argv[list + 1]);
+    return 1;
+  }
+  // Each line runs after the options that came before -list, blank lines and # comments are skipped
+  char line[4096];
+  char ** line_argv = malloc((list + sizeof(line) / 2) * sizeof(char *));
+  int failed = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    int line_argc = list;
+    for (int i = 0; i < list; i += 1)
+      line_argv[i] = argv[i];
+    for (char * token = strtok(line, " \t\r\n"); token != NULL && token[0] != '#'; token = strtok(NULL, " \t\r\n"))
+      line_argv[line_argc++] = token;
+    if (line_argc > list)
+      failed |= Convert(line_argc, line_argv);
+  }
+  fclose(f);
+  free(line_argv);
+  return failed;
+}
@@ -0,0 +1,504 @@
+#pragma once
+
+// Triangle and vertex order optimisation for indexed triangle lists. Tipsify (Sander, Nehab and Barczak 2007) orders
+// triangles for a FIFO post-transform cache and splits them into clusters wherever it runs into a dead end, clusters are
+// split further while their cache miss ratio stays within a threshold and sorted so that outward facing ones draw first.
+// Vertices are then renumbered in first use order so fetches walk the vertex streams forward. Culling clusters are grown
+// over shared vertices and levels of detail come from quadric error edge collapses.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {GPUMESH_CACHE_SIZE = 16};
+
+// Misses of a FIFO cache of cache_size vertices, stamps hold per vertex insertion times and time the current one
+static inline int GpuMeshCacheUpdate(unsigned * triangle, int cache_size, int * stamps, int * time) {
+  int misses = 0;
+  for (int k = 0; k < 3; k += 1) {
+    if (time[0] - stamps[triangle[k]] > cache_size) {
+      stamps[triangle[k]] = time[0];
+      time[0] += 1;
+      misses += 1;
+    }
+  }
+  return misses;
+}
+
+static inline int GpuMeshCacheMisses(unsigned * indices, int index_count, int vertex_count, int cache_size) {
+  int * stamps = calloc(vertex_count, sizeof(int));
+  int time = cache_size + 1;
+  int misses = 0;
+  for (int i = 0; i + 3 <= index_count; i += 3)
+    misses += GpuMeshCacheUpdate(&indices[i], cache_size, stamps, &time);
+  free(stamps);
+  return misses;
+}
+
+// Writes index_count reordered indices and the first triangle of every cluster, returns the cluster count
+static inline int GpuMeshTipsify(unsigned * indices, int index_count, int vertex_count, int cache_size, unsigned * out_indices, int * out_clusters) {
+  int triangle_count = index_count / 3;
+  int * offsets = calloc(vertex_count + 1, sizeof(int));
+  for (int i = 0; i < triangle_count * 3; i += 1)
+    offsets[indices[i] + 1] += 1;
+  for (int v = 0; v < vertex_count; v += 1)
+    offsets[v + 1] += offsets[v];
+  int * live = malloc(vertex_count * sizeof(int));
+  int * fill = malloc(vertex_count * sizeof(int));
+  for (int v = 0; v < vertex_count; v += 1) {
+    live[v] = offsets[v + 1] - offsets[v];
+    fill[v] = offsets[v];
+  }
+  int * adjacency = malloc((triangle_count * 3 + 1) * sizeof(int));
+  for (int i = 0; i < triangle_count * 3; i += 1)
+    adjacency[fill[indices[i]]++] = i / 3;
+  int * stamps = calloc(vertex_count, sizeof(int));
+  int * dead_end = malloc((triangle_count * 3 + 1) * sizeof(int));
+  int * candidates = malloc((triangle_count * 3 + 1) * sizeof(int));
+  char * emitted = calloc(triangle_count + 1, 1);
+  int dead_end_count = 0;
+  int time = cache_size + 1;
+  int cursor = 0;
+  int out_count = 0;
+  int cluster_count = 0;
+
+  for (int fan = -1;;) {
+    if (fan < 0) {
+      while (dead_end_count > 0 && fan < 0) {
+        int v = dead_end[--dead_end_count];
+        fan = live[v] > 0 ? v : -1;
+      }
+      while (fan < 0 && cursor < vertex_count) {
+        fan = live[cursor] > 0 ? cursor : -1;
+        cursor += fan < 0;
+      }
+      if (fan < 0)
+        break;
+      out_clusters[cluster_count++] = out_count / 3;
+    }
+    int candidates_count = 0;
+    for (int a = offsets[fan]; a < offsets[fan + 1]; a += 1) {
+      int t = adjacency[a];
+      if (emitted[t])
+        continue;
+      emitted[t] = 1;
+      for (int k = 0; k < 3; k += 1) {
+        unsigned v = indices[t * 3 + k];
+        out_indices[out_count++] = v;
+        dead_end[dead_end_count++] = v;
+        candidates[candidates_count++] = v;
+        live[v] -= 1;
+        if (time - stamps[v] > cache_size)
+          stamps[v] = time++;
+      }
+    }
+    // Prefer the vertex that entered the cache earliest among those whose remaining triangles still hit the cache
+    int next = -1;
+    int next_priority = -1;
+    for (int c = 0; c < candidates_count; c += 1) {
+      int v = candidates[c];
+      if (live[v] <= 0)
+        continue;
+      int priority = time - stamps[v] + 2 * live[v] <= cache_size ? time - stamps[v] : 0;
+      if (priority > next_priority) {
+        next = v;
+        next_priority = priority;
+      }
+    }
+    fan = next;
+  }
+  free(offsets);
+  free(live);
+  free(fill);
+  free(adjacency);
+  free(stamps);
+  free(dead_end);
+  free(candidates);
+  free(emitted);
+  return cluster_count;
+}
+
+struct gpumesh_cluster_t {
+  float key;
+  int first;
+  int count;
+};
+
+static inline int GpuMeshClusterCompare(const void * a, const void * b) {
+  const struct gpumesh_cluster_t * x = a;
+  const struct gpumesh_cluster_t * y = b;
+  return x->key > y->key ? -1 : x->key < y->key ? 1 : x->first - y->first;
+}
+
+// Clusters are split where their running miss ratio reaches threshold times the whole cluster's, then sorted by how far
+// their centroid lies along their normal from the mesh centroid, so the silhouette draws before what it hides
+static inline void GpuMeshOverdraw(
+    unsigned * indices, int index_count, int vertex_count, float * positions, int * clusters, int cluster_count,
+    int cache_size, float threshold, unsigned * out_indices)
+{
+  int triangle_count = index_count / 3;
+  struct gpumesh_cluster_t * sorted = malloc((triangle_count + 1) * sizeof(struct gpumesh_cluster_t));
+  int sorted_count = 0;
+  int * stamps = calloc(vertex_count, sizeof(int));
+  int time = cache_size + 1;
+  for (int c = 0; c < cluster_count; c += 1) {
+    int first = clusters[c];
+    int end = c + 1 < cluster_count ? clusters[c + 1] : triangle_count;
+    time += cache_size + 1;
+    int misses = 0;
+    for (int t = first; t < end; t += 1)
+      misses += GpuMeshCacheUpdate(&indices[t * 3], cache_size, stamps, &time);
+    float target = threshold * misses / (end - first);
+    int sub_first = first;
+    int sub_misses = 0;
+    time += cache_size + 1;
+    for (int t = first; t < end; t += 1) {
+      sub_misses += GpuMeshCacheUpdate(&indices[t * 3], cache_size, stamps, &time);
+      if (sub_misses <= target * (t + 1 - sub_first) && t + 1 < end) {
+        sorted[sorted_count++] = (struct gpumesh_cluster_t){0, sub_first, t + 1 - sub_first};
+        sub_first = t + 1;
+        sub_misses = 0;
+        time += cache_size + 1;
+      }
+    }
+    // What is left after the last split never reached the target ratio, it goes back into the cluster before it
+    if (sub_first > first)
+      sorted[sorted_count - 1].count += end - sub_first;
+    else
+      sorted[sorted_count++] = (struct gpumesh_cluster_t){0, sub_first, end - sub_first};
+  }
+  free(stamps);
+
+  float mesh_centroid[3] = {0, 0, 0};
+  float mesh_area = 0;
+  for (int pass = 0; pass < 2; pass += 1) {
+    for (int s = 0; s < sorted_count; s += 1) {
+      float centroid[3] = {0, 0, 0};
+      float normal[3] = {0, 0, 0};
+      float area = 0;
+      for (int t = sorted[s].first; t < sorted[s].first + sorted[s].count; t += 1) {
+        float * a = &positions[indices[t * 3 + 0] * 3];
+        float * b = &positions[indices[t * 3 + 1] * 3];
+        float * d = &positions[indices[t * 3 + 2] * 3];
+        float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        float e1[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+        float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+        float w = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        for (int k = 0; k < 3; k += 1) {
+          centroid[k] += w * (a[k] + b[k] + d[k]) / 3;
+          normal[k] += n[k];
+        }
+        area += w;
+      }
+      if (pass == 0) {
+        for (int k = 0; k < 3; k += 1)
+          mesh_centroid[k] += centroid[k];
+        mesh_area += area;
+        continue;
+      }
+      float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+      sorted[s].key = 0;
+      for (int k = 0; area > 0 && length > 0 && k < 3; k += 1)
+        sorted[s].key += (centroid[k] / area - mesh_centroid[k]) * normal[k] / length;
+    }
+    for (int k = 0; pass == 0 && k < 3; k += 1)
+      mesh_centroid[k] = mesh_area > 0 ? mesh_centroid[k] / mesh_area : 0;
+  }
+  qsort(sorted, sorted_count, sizeof(struct gpumesh_cluster_t), GpuMeshClusterCompare);
+  int out_count = 0;
+  for (int s = 0; s < sorted_count; s += 1) {
+    memcpy(&out_indices[out_count], &indices[sorted[s].first * 3], sorted[s].count * 3 * sizeof(unsigned));
+    out_count += sorted[s].count * 3;
+  }
+  free(sorted);
+}
+
+// out_remap[old vertex] = new vertex, referenced vertices first in order of first use, returns how many were referenced
+static inline int GpuMeshFetchRemap(unsigned * indices, int index_count, int vertex_count, unsigned * out_remap) {
+  memset(out_remap, 0xFF, vertex_count * sizeof(unsigned));
+  int next = 0;
+  for (int i = 0; i < index_count; i += 1)
+    if (out_remap[indices[i]] == ~0u)
+      out_remap[indices[i]] = next++;
+  int referenced = next;
+  for (int v = 0; v < vertex_count; v += 1)
+    if (out_remap[v] == ~0u)
+      out_remap[v] = next++;
+  return referenced;
+}
+
+// Grows clusters of up to max_triangles from the first triangle not yet in one, always adding the neighbour that shares
+// the most vertices with the cluster and, among those, faces closest to its average normal. Past half of max_triangles a
+// cluster stops at a neighbour facing more than 45 degrees away. Writes the triangles cluster by cluster and the first
+// triangle of every cluster, returns the cluster count.
+static inline int GpuMeshClusterize(
+    unsigned * indices, int index_count, int vertex_count, float * positions, int max_triangles, unsigned * out_indices,
+    int * out_clusters)
+{
+  int triangle_count = index_count / 3;
+  int * offsets = calloc(vertex_count + 1, sizeof(int));
+  for (int i = 0; i < triangle_count * 3; i += 1)
+    offsets[indices[i] + 1] += 1;
+  for (int v = 0; v < vertex_count; v += 1)
+    offsets[v + 1] += offsets[v];
+  int * fill = malloc((vertex_count + 1) * sizeof(int));
+  memcpy(fill, offsets, vertex_count * sizeof(int));
+  int * adjacency = malloc((triangle_count * 3 + 1) * sizeof(int));
+  for (int i = 0; i < triangle_count * 3; i += 1)
+    adjacency[fill[indices[i]]++] = i / 3;
+  float * normals = malloc((triangle_count * 3 + 1) * sizeof(float));
+  for (int t = 0; t < triangle_count; t += 1) {
+    float * a = &positions[indices[t * 3 + 0] * 3];
+    float * b = &positions[indices[t * 3 + 1] * 3];
+    float * d = &positions[indices[t * 3 + 2] * 3];
+    float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float e1[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+    float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+    float l = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    for (int k = 0; k < 3; k += 1)
+      normals[t * 3 + k] = l > 0 ? n[k] / l : 0;
+  }
+  int * vertex_cluster = malloc((vertex_count + 1) * sizeof(int));
+  memset(vertex_cluster, 0xFF, vertex_count * sizeof(int));
+  int * triangle_cluster = malloc((triangle_count + 1) * sizeof(int));
+  memset(triangle_cluster, 0xFF, triangle_count * sizeof(int));
+  int * candidates = malloc((triangle_count + 1) * sizeof(int));
+  int out_count = 0;
+  int cluster_count = 0;
+
+  for (int seed = 0; seed < triangle_count; seed += 1) {
+    if (triangle_cluster[seed] >= 0)
+      continue;
+    int cluster = cluster_count++;
+    out_clusters[cluster] = out_count / 3;
+    float axis[3] = {0, 0, 0};
+    int candidates_count = 0;
+    for (int t = seed, size = 0; t >= 0; size += 1) {
+      triangle_cluster[t] = cluster;
+      for (int k = 0; k < 3; k += 1) {
+        unsigned v = indices[t * 3 + k];
+        out_indices[out_count++] = v;
+        axis[k] += normals[t * 3 + k];
+        if (vertex_cluster[v] == cluster)
+          continue;
+        vertex_cluster[v] = cluster;
+        // Triangles already queued for this cluster are marked with -2 - cluster so they are queued once
+        for (int a = offsets[v]; a < offsets[v + 1]; a += 1) {
+          if (triangle_cluster[adjacency[a]] != -1)
+            continue;
+          triangle_cluster[adjacency[a]] = -2 - cluster;
+          candidates[candidates_count++] = adjacency[a];
+        }
+      }
+      t = -1;
+      if (size + 1 == max_triangles)
+        break;
+      float l = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+      float best_score = -4;
+      int best = -1;
+      for (int c = 0; c < candidates_count; c += 1) {
+        int u = candidates[c];
+        int shared = 0;
+        for (int k = 0; k < 3; k += 1)
+          shared += vertex_cluster[indices[u * 3 + k]] == cluster;
+        float dot = l > 0 ? (normals[u * 3] * axis[0] + normals[u * 3 + 1] * axis[1] + normals[u * 3 + 2] * axis[2]) / l : 1;
+        float score = shared + dot;
+        if (score > best_score) {
+          best_score = score;
+          best = c;
+        }
+      }
+      if (best < 0)
+        break;
+      int u = candidates[best];
+      float dot = l > 0 ? (normals[u * 3] * axis[0] + normals[u * 3 + 1] * axis[1] + normals[u * 3 + 2] * axis[2]) / l : 1;
+      if (size + 1 >= max_triangles / 2 && dot < 0.7071f)
+        break;
+      candidates[best] = candidates[--candidates_count];
+      t = u;
+    }
+    // Queued triangles left over go back to being free for the clusters after this one
+    for (int c = 0; c < candidates_count; c += 1)
+      triangle_cluster[candidates[c]] = -1;
+  }
+  free(offsets);
+  free(fill);
+  free(adjacency);
+  free(normals);
+  free(vertex_cluster);
+  free(triangle_cluster);
+  free(candidates);
+  return cluster_count;
+}
+
+struct gpumesh_collapse_t {
+  double cost;
+  unsigned from;
+  unsigned to;
+};
+
+static inline int GpuMeshCollapseCompare(const void * a, const void * b) {
+  const struct gpumesh_collapse_t * x = a;
+  const struct gpumesh_collapse_t * y = b;
+  return x->cost < y->cost ? -1 : x->cost > y->cost ? 1 : 0;
+}
+
+static inline int GpuMeshEdgeCompare(const void * a, const void * b) {
+  unsigned long x = *(const unsigned long *)a;
+  unsigned long y = *(const unsigned long *)b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+// Quadric of the planes a vertex lies on: xx, xy, xz, xw, yy, yz, yw, zz, zw, ww and then how many planes were summed
+static inline double GpuMeshQuadricError(double * q, float * p) {
+  double x = p[0], y = p[1], z = p[2];
+  return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x + q[4] * y * y + 2 * q[5] * y * z +
+      2 * q[6] * y + q[7] * z * z + 2 * q[8] * z + q[9];
+}
+
+static inline void GpuMeshTriangleCross(float * a, float * b, float * c, double * out_n) {
+  double e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+  double e1[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+  out_n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+  out_n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+  out_n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+// Quadric error edge collapse (Garland and Heckbert 1997) that only moves a vertex onto a neighbour, so every result
+// indexes the same vertex streams. Vertices on open or non-manifold edges, uv and normal seams included, never move.
+// Each pass sorts every collapse by cost and applies the cheapest ones that flip no triangle and touch no vertex around
+// one applied before. Writes the simplified indices, returns their count and in out_error the largest root mean square
+// distance of a moved vertex to the planes it collapsed, an estimate of how far the surface moved.
+static inline int GpuMeshSimplify(
+    unsigned * indices, int index_count, int vertex_count, float * positions, int target_index_count,
+    unsigned * out_indices, float * out_error)
+{
+  int count = index_count / 3 * 3;
+  memcpy(out_indices, indices, count * sizeof(unsigned));
+  double * quadrics = calloc((size_t)vertex_count * 11 + 1, sizeof(double));
+  for (int t = 0; t < count; t += 3) {
+    float * a = &positions[indices[t] * 3];
+    double n[3];
+    GpuMeshTriangleCross(a, &positions[indices[t + 1] * 3], &positions[indices[t + 2] * 3], n);
+    double l = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (l == 0)
+      continue;
+    double plane[4] = {n[0] / l, n[1] / l, n[2] / l, -(n[0] * a[0] + n[1] * a[1] + n[2] * a[2]) / l};
+    for (int k = 0; k < 3; k += 1) {
+      double * q = &quadrics[indices[t + k] * 11];
+      for (int i = 0, e = 0; i < 4; i += 1)
+        for (int j = i; j < 4; j += 1)
+          q[e++] += plane[i] * plane[j];
+      q[10] += 1;
+    }
+  }
+  char * locked = calloc(vertex_count + 1, 1);
+  unsigned long * edges = malloc((count + 1) * sizeof(unsigned long));
+  for (int i = 0; i < count; i += 1) {
+    unsigned a = indices[i];
+    unsigned b = indices[i % 3 == 2 ? i - 2 : i + 1];
+    edges[i] = a < b ? (unsigned long)a << 32 | b : (unsigned long)b << 32 | a;
+  }
+  qsort(edges, count, sizeof(unsigned long), GpuMeshEdgeCompare);
+  for (int i = 0, run = 1; i < count; i += run) {
+    for (run = 1; i + run < count && edges[i + run] == edges[i]; run += 1)
+      ;
+    if (run != 2) {
+      locked[edges[i] >> 32] = 1;
+      locked[edges[i] & 0xFFFFFFFF] = 1;
+    }
+  }
+  free(edges);
+
+  int * offsets = malloc((vertex_count + 1) * sizeof(int));
+  int * fill = malloc((vertex_count + 1) * sizeof(int));
+  int * adjacency = malloc((count + 1) * sizeof(int));
+  char * touched = malloc(vertex_count + 1);
+  struct gpumesh_collapse_t * collapses = malloc((count * 2 + 1) * sizeof(struct gpumesh_collapse_t));
+  double error = 0;
+  while (count > target_index_count) {
+    memset(offsets, 0, (vertex_count + 1) * sizeof(int));
+    for (int i = 0; i < count; i += 1)
+      offsets[out_indices[i] + 1] += 1;
+    for (int v = 0; v < vertex_count; v += 1)
+      offsets[v + 1] += offsets[v];
+    memcpy(fill, offsets, vertex_count * sizeof(int));
+    for (int i = 0; i < count; i += 1)
+      adjacency[fill[out_indices[i]]++] = i / 3;
+    int collapse_count = 0;
+    for (int i = 0; i < count; i += 1) {
+      unsigned a = out_indices[i];
+      unsigned b = out_indices[i % 3 == 2 ? i - 2 : i + 1];
+      for (int k = 0; k < 2; k += 1) {
+        unsigned from = k ? b : a;
+        unsigned to = k ? a : b;
+        if (locked[from])
+          continue;
+        double cost = GpuMeshQuadricError(&quadrics[from * 11], &positions[to * 3]) + GpuMeshQuadricError(&quadrics[to * 11], &positions[to * 3]);
+        collapses[collapse_count++] = (struct gpumesh_collapse_t){cost < 0 ? 0 : cost, from, to};
+      }
+    }
+    qsort(collapses, collapse_count, sizeof(struct gpumesh_collapse_t), GpuMeshCollapseCompare);
+    memset(touched, 0, vertex_count);
+    int removed = 0;
+    int applied = 0;
+    for (int c = 0; c < collapse_count && count - removed * 3 > target_index_count; c += 1) {
+      unsigned from = collapses[c].from;
+      unsigned to = collapses[c].to;
+      if (touched[from] || touched[to])
+        continue;
+      int flips = 0;
+      int degenerate = 0;
+      for (int a = offsets[from]; a < offsets[from + 1] && !flips; a += 1) {
+        unsigned * tri = &out_indices[adjacency[a] * 3];
+        if (tri[0] == to || tri[1] == to || tri[2] == to) {
+          degenerate += 1;
+          continue;
+        }
+        float * p[3];
+        for (int k = 0; k < 3; k += 1)
+          p[k] = &positions[(tri[k] == from ? to : tri[k]) * 3];
+        double before[3];
+        double after[3];
+        GpuMeshTriangleCross(&positions[tri[0] * 3], &positions[tri[1] * 3], &positions[tri[2] * 3], before);
+        GpuMeshTriangleCross(p[0], p[1], p[2], after);
+        flips = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0;
+      }
+      if (flips)
+        continue;
+      for (int a = offsets[from]; a < offsets[from + 1]; a += 1)
+        for (int k = 0; k < 3; k += 1)
+          touched[out_indices[adjacency[a] * 3 + k]] = 1;
+      for (int a = offsets[from]; a < offsets[from + 1]; a += 1)
+        for (int k = 0; k < 3; k += 1)
+          if (out_indices[adjacency[a] * 3 + k] == from)
+            out_indices[adjacency[a] * 3 + k] = to;
+      double planes = quadrics[from * 11 + 10] + quadrics[to * 11 + 10];
+      error = planes > 0 && collapses[c].cost / planes > error ? collapses[c].cost / planes : error;
+      for (int k = 0; k < 11; k += 1)
+        quadrics[to * 11 + k] += quadrics[from * 11 + k];
+      removed += degenerate;
+      applied += 1;
+    }
+    int kept = 0;
+    for (int i = 0; i < count; i += 3) {
+      unsigned * tri = &out_indices[i];
+      if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0])
+        continue;
+      memmove(&out_indices[kept], tri, 3 * sizeof(unsigned));
+      kept += 3;
+    }
+    count = kept;
+    if (applied == 0)
+      break;
+  }
+  free(quadrics);
+  free(locked);
+  free(offsets);
+  free(fill);
+  free(adjacency);
+  free(touched);
+  free(collapses);
+  out_error[0] = (float)sqrt(error);
+  return count;
+}
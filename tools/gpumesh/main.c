@@ -0,0 +1,843 @@
+// Converts meshes into gpulib's mesh pack (struct gpu_mesh_file_t), loaded with GpuLoadMeshFile.
+// Inputs are Wavefront OBJ files, every object or group becomes a draw command, unquantized mesh packs, or a directory
+// of the older MeshVB/MeshIB/MeshUV/MeshNormals/MeshID .binary files together with the MeshIBVB.h header generated for them.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gpumesh_opt.h"
+
+// Must match the container definitions in gpulib.h
+#define GPULIB_MESH_FILE_MAGIC      (0x4D555047) // "GPUM"
+#define GPULIB_MESH_FILE_VERSION    (4)
+#define GPULIB_MESH_FILE_ALIGNMENT  (4096)
+#define GPULIB_MESH_FILE_NAME_BYTES (32)
+
+struct gpu_cmd_t {
+  unsigned count;
+  unsigned instance_count;
+  unsigned first;
+  unsigned base_vertex;
+  unsigned instance_first;
+};
+
+struct gpu_mesh_file_t {
+  unsigned magic;
+  unsigned version;
+  unsigned vertex_count;
+  unsigned index_type;
+  unsigned stream_count;
+  unsigned cmd_count;
+  unsigned long file_bytes;
+  float aabb_min[3];
+  float aabb_max[3];
+  unsigned cluster_count;
+  unsigned cluster_triangles;
+  unsigned lod_count;
+  unsigned lod_levels;
+};
+
+struct gpu_mesh_file_stream_t {
+  char name[GPULIB_MESH_FILE_NAME_BYTES];
+  unsigned format;
+  unsigned count;
+  unsigned long bytes_first;
+  unsigned long bytes_count;
+};
+
+struct gpu_mesh_cluster_t {
+  float center[3];
+  float radius;
+  float cone_axis[3];
+  float cone_cutoff;
+  unsigned cmd;
+  unsigned first;
+  unsigned count;
+};
+
+struct gpu_mesh_lod_t {
+  unsigned cmd;
+  unsigned first;
+  unsigned count;
+  float error;
+};
+
+// Streams no input has are left out of the pack, ids hold the command of every vertex
+struct gpumesh_t {
+  int has_uvs;
+  int has_normals;
+  int has_ids;
+  int vertex_count;
+  float * positions;
+  float * uvs;
+  float * normals;
+  unsigned * ids;
+  int index_count;
+  unsigned * indices;
+  int cmd_count;
+  struct gpu_cmd_t * cmds;
+  char (* names)[GPULIB_MESH_FILE_NAME_BYTES];
+  int cluster_count;
+  int cluster_triangles;
+  struct gpu_mesh_cluster_t * clusters;
+  int lod_count;
+  int lod_levels;
+  struct gpu_mesh_lod_t * lods;
+};
+
+static void * ReadFile(char * filepath, long * out_bytes) {
+  FILE * f = fopen(filepath, "rb");
+  if (f == NULL)
+    return NULL;
+  fseek(f, 0, SEEK_END);
+  long bytes = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char * data = malloc(bytes + 1);
+  if ((long)fread(data, 1, bytes, f) != bytes) {
+    free(data);
+    data = NULL;
+  } else {
+    data[bytes] = 0;
+  }
+  fclose(f);
+  out_bytes[0] = bytes;
+  return data;
+}
+
+static void AddCmd(struct gpumesh_t * mesh, char * name, int index_first) {
+  mesh->cmds = realloc(mesh->cmds, (mesh->cmd_count + 1) * sizeof(struct gpu_cmd_t));
+  mesh->names = realloc(mesh->names, (mesh->cmd_count + 1) * GPULIB_MESH_FILE_NAME_BYTES);
+  mesh->cmds[mesh->cmd_count] = (struct gpu_cmd_t){.instance_count = 1, .first = index_first};
+  memset(mesh->names[mesh->cmd_count], 0, GPULIB_MESH_FILE_NAME_BYTES);
+  strncpy(mesh->names[mesh->cmd_count], name, GPULIB_MESH_FILE_NAME_BYTES - 1);
+  mesh->cmd_count += 1;
+}
+
+// The command table is parsed out of the generated header, counts come from the .binary file sizes
+static int LoadLegacy(char * dir, struct gpumesh_t * mesh) {
+  char path[4096];
+  long bytes = 0;
+  snprintf(path, sizeof(path), "%s/MeshIBVB.h", dir);
+  char * header = ReadFile(path, &bytes);
+  snprintf(path, sizeof(path), "%s/MeshVB.binary", dir);
+  mesh->positions = ReadFile(path, &bytes);
+  mesh->vertex_count = (int)(bytes / (3 * sizeof(float)));
+  snprintf(path, sizeof(path), "%s/MeshIB.binary", dir);
+  mesh->indices = ReadFile(path, &bytes);
+  mesh->index_count = (int)(bytes / sizeof(unsigned));
+  if (header == NULL || mesh->positions == NULL || mesh->indices == NULL) {
+    fprintf(stderr, "gpumesh: %s needs MeshIBVB.h, MeshVB.binary and MeshIB.binary\n", dir);
+    return 0;
+  }
+  snprintf(path, sizeof(path), "%s/MeshUV.binary", dir);
+  mesh->uvs = ReadFile(path, &bytes);
+  snprintf(path, sizeof(path), "%s/MeshNormals.binary", dir);
+  mesh->normals = ReadFile(path, &bytes);
+  snprintf(path, sizeof(path), "%s/MeshID.binary", dir);
+  mesh->ids = ReadFile(path, &bytes);
+  mesh->has_uvs = mesh->uvs != NULL;
+  mesh->has_normals = mesh->normals != NULL;
+  mesh->has_ids = mesh->ids != NULL;
+
+  for (char * p = strstr(header, "e_draw_"); p != NULL && strncmp(p, "e_draw_count", 12) != 0; p = strstr(p, "e_draw_")) {
+    p += 7;
+    char name[GPULIB_MESH_FILE_NAME_BYTES] = {0};
+    for (int i = 0; i < GPULIB_MESH_FILE_NAME_BYTES - 1 && p[i] != ',' && p[i] != '\n' && p[i] != ' '; i += 1)
+      name[i] = p[i];
+    AddCmd(mesh, name, 0);
+  }
+  static const char assignment[] = "out_draw_commands_array_of_size_e_draw_count_times_5[";
+  for (char * p = strstr(header, assignment); p != NULL; p = strstr(p, assignment)) {
+    p += sizeof(assignment) - 1;
+    int field = atoi(p);
+    char * name = strstr(p, "e_draw_") + 7;
+    char * value = strstr(p, "] = ") + 4;
+    for (int c = 0; c < mesh->cmd_count; c += 1) {
+      size_t n = strlen(mesh->names[c]);
+      if (strncmp(mesh->names[c], name, n) == 0 && name[n] == ']')
+        ((unsigned *)&mesh->cmds[c])[field] = (unsigned)strtoul(value, NULL, 10);
+    }
+  }
+  free(header);
+  return mesh->cmd_count > 0;
+}
+
+struct gpumesh_obj_key_t {
+  int v;
+  int vt;
+  int vn;
+  int vertex;
+};
+
+// Appends to mesh, unique v/vt/vn triples of a file become vertices, polygons are triangulated as fans
+static int LoadObj(char * filepath, struct gpumesh_t * mesh) {
+  long bytes = 0;
+  char * text = ReadFile(filepath, &bytes);
+  if (text == NULL) {
+    fprintf(stderr, "gpumesh: can't read %s\n", filepath);
+    return 0;
+  }
+  int v_count = 0, vt_count = 0, vn_count = 0;
+  float * v = NULL;
+  float * vt = NULL;
+  float * vn = NULL;
+  int table_count = 1 << 16;
+  struct gpumesh_obj_key_t * table = malloc(table_count * sizeof(struct gpumesh_obj_key_t));
+  memset(table, 0xFF, table_count * sizeof(struct gpumesh_obj_key_t));
+  int keys = 0;
+  int cmd_first = mesh->cmd_count;
+
+  for (char * line = strtok(text, "\n"); line != NULL; line = strtok(NULL, "\n")) {
+    if (strncmp(line, "v ", 2) == 0) {
+      v = realloc(v, (v_count + 1) * 3 * sizeof(float));
+      sscanf(line + 2, "%f %f %f", &v[v_count * 3], &v[v_count * 3 + 1], &v[v_count * 3 + 2]);
+      v_count += 1;
+    } else if (strncmp(line, "vt ", 3) == 0) {
+      vt = realloc(vt, (vt_count + 1) * 2 * sizeof(float));
+      sscanf(line + 3, "%f %f", &vt[vt_count * 2], &vt[vt_count * 2 + 1]);
+      vt_count += 1;
+    } else if (strncmp(line, "vn ", 3) == 0) {
+      vn = realloc(vn, (vn_count + 1) * 3 * sizeof(float));
+      sscanf(line + 3, "%f %f %f", &vn[vn_count * 3], &vn[vn_count * 3 + 1], &vn[vn_count * 3 + 2]);
+      vn_count += 1;
+    } else if (strncmp(line, "o ", 2) == 0 || strncmp(line, "g ", 2) == 0) {
+      char * name = line + 2;
+      name[strcspn(name, "\r")] = 0;
+      if (mesh->cmd_count > cmd_first && mesh->cmds[mesh->cmd_count - 1].count == 0)
+        strncpy(mesh->names[mesh->cmd_count - 1], name, GPULIB_MESH_FILE_NAME_BYTES - 1);
+      else
+        AddCmd(mesh, name, mesh->index_count);
+    } else if (strncmp(line, "f ", 2) == 0) {
+      if (mesh->cmd_count == cmd_first) {
+        char * name = strrchr(filepath, '/') != NULL ? strrchr(filepath, '/') + 1 : filepath;
+        AddCmd(mesh, name, mesh->index_count);
+      }
+      int corners[64];
+      int corners_count = 0;
+      for (char * p = line + 2; *p != 0 && corners_count < 64;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r')
+          p += 1;
+        if (*p == 0)
+          break;
+        int idx[3] = {0, 0, 0};
+        for (int k = 0; k < 3; k += 1) {
+          if (*p != '/' && *p != ' ' && *p != 0 && *p != '\r')
+            idx[k] = (int)strtol(p, &p, 10);
+          if (*p != '/')
+            break;
+          p += 1;
+        }
+        idx[0] = idx[0] < 0 ? v_count + idx[0] : idx[0] - 1;
+        idx[1] = idx[1] < 0 ? vt_count + idx[1] : idx[1] - 1;
+        idx[2] = idx[2] < 0 ? vn_count + idx[2] : idx[2] - 1;
+        if (keys * 2 >= table_count) {
+          struct gpumesh_obj_key_t * old = table;
+          table_count *= 2;
+          table = malloc(table_count * sizeof(struct gpumesh_obj_key_t));
+          memset(table, 0xFF, table_count * sizeof(struct gpumesh_obj_key_t));
+          for (int i = 0; i < table_count / 2; i += 1) {
+            if (old[i].vertex < 0)
+              continue;
+            unsigned h = ((unsigned)old[i].v * 73856093u ^ (unsigned)old[i].vt * 19349663u ^ (unsigned)old[i].vn * 83492791u) & (table_count - 1);
+            while (table[h].vertex >= 0)
+              h = (h + 1) & (table_count - 1);
+            table[h] = old[i];
+          }
+          free(old);
+        }
+        unsigned h = ((unsigned)idx[0] * 73856093u ^ (unsigned)idx[1] * 19349663u ^ (unsigned)idx[2] * 83492791u) & (table_count - 1);
+        while (table[h].vertex >= 0 && (table[h].v != idx[0] || table[h].vt != idx[1] || table[h].vn != idx[2]))
+          h = (h + 1) & (table_count - 1);
+        if (table[h].vertex < 0) {
+          int n = mesh->vertex_count;
+          table[h] = (struct gpumesh_obj_key_t){idx[0], idx[1], idx[2], n};
+          keys += 1;
+          mesh->positions = realloc(mesh->positions, (n + 1) * 3 * sizeof(float));
+          mesh->uvs = realloc(mesh->uvs, (n + 1) * 2 * sizeof(float));
+          mesh->normals = realloc(mesh->normals, (n + 1) * 3 * sizeof(float));
+          mesh->ids = realloc(mesh->ids, (n + 1) * sizeof(unsigned));
+          for (int c = 0; c < 3; c += 1)
+            mesh->positions[n * 3 + c] = idx[0] >= 0 && idx[0] < v_count ? v[idx[0] * 3 + c] : 0;
+          for (int c = 0; c < 2; c += 1)
+            mesh->uvs[n * 2 + c] = idx[1] >= 0 && idx[1] < vt_count ? vt[idx[1] * 2 + c] : 0;
+          for (int c = 0; c < 3; c += 1)
+            mesh->normals[n * 3 + c] = idx[2] >= 0 && idx[2] < vn_count ? vn[idx[2] * 3 + c] : 0;
+          mesh->ids[n] = mesh->cmd_count - 1;
+          mesh->vertex_count += 1;
+        }
+        corners[corners_count++] = table[h].vertex;
+      }
+      for (int i = 2; i < corners_count; i += 1) {
+        mesh->indices = realloc(mesh->indices, (mesh->index_count + 3) * sizeof(unsigned));
+        mesh->indices[mesh->index_count++] = corners[0];
+        mesh->indices[mesh->index_count++] = corners[i - 1];
+        mesh->indices[mesh->index_count++] = corners[i];
+        mesh->cmds[mesh->cmd_count - 1].count += 3;
+      }
+    }
+  }
+  // Empty objects, a name followed by another name, draw nothing and are dropped
+  for (int c = cmd_first; c < mesh->cmd_count;) {
+    if (mesh->cmds[c].count == 0) {
+      memmove(&mesh->cmds[c], &mesh->cmds[c + 1], (mesh->cmd_count - c - 1) * sizeof(struct gpu_cmd_t));
+      memmove(mesh->names[c], mesh->names[c + 1], (mesh->cmd_count - c - 1) * GPULIB_MESH_FILE_NAME_BYTES);
+      mesh->cmd_count -= 1;
+      for (int i = 0; i < mesh->vertex_count; i += 1)
+        mesh->ids[i] -= mesh->ids[i] > (unsigned)c;
+    } else {
+      c += 1;
+    }
+  }
+  mesh->has_uvs |= vt_count > 0;
+  mesh->has_normals |= vn_count > 0;
+  mesh->has_ids = 1;
+  free(table);
+  free(v);
+  free(vt);
+  free(vn);
+  free(text);
+  return 1;
+}
+
+// Unquantized packs only, streams are matched by name
+static int LoadPack(char * filepath, struct gpumesh_t * mesh) {
+  long bytes = 0;
+  char * data = ReadFile(filepath, &bytes);
+  struct gpu_mesh_file_t * header = (struct gpu_mesh_file_t *)data;
+  if (data == NULL || bytes < (long)sizeof(struct gpu_mesh_file_t) || header->magic != GPULIB_MESH_FILE_MAGIC ||
+      header->version != GPULIB_MESH_FILE_VERSION || header->file_bytes != (unsigned long)bytes)
+  {
+    fprintf(stderr, "gpumesh: %s is not a version %d mesh pack\n", filepath, GPULIB_MESH_FILE_VERSION);
+    free(data);
+    return 0;
+  }
+  struct gpu_mesh_file_stream_t * streams = (struct gpu_mesh_file_stream_t *)(header + 1);
+  struct gpu_cmd_t * cmds = (struct gpu_cmd_t *)(streams + header->stream_count);
+  char (* names)[GPULIB_MESH_FILE_NAME_BYTES] = (void *)(cmds + header->cmd_count);
+  int vertex_first = mesh->vertex_count;
+  int index_first = mesh->index_count;
+  int cmd_first = mesh->cmd_count;
+  mesh->vertex_count += header->vertex_count;
+  mesh->positions = realloc(mesh->positions, mesh->vertex_count * 3 * sizeof(float));
+  mesh->uvs = realloc(mesh->uvs, mesh->vertex_count * 2 * sizeof(float));
+  mesh->normals = realloc(mesh->normals, mesh->vertex_count * 3 * sizeof(float));
+  mesh->ids = realloc(mesh->ids, mesh->vertex_count * sizeof(unsigned));
+  memset(&mesh->uvs[vertex_first * 2], 0, header->vertex_count * 2 * sizeof(float));
+  memset(&mesh->normals[vertex_first * 3], 0, header->vertex_count * 3 * sizeof(float));
+  for (unsigned i = 0; i < header->vertex_count; i += 1)
+    mesh->ids[vertex_first + i] = cmd_first;
+  // Levels of detail follow the indices of the commands and are generated again
+  unsigned cmd_indices = 0;
+  for (unsigned c = 0; c < header->cmd_count; c += 1)
+    cmd_indices = cmds[c].first + cmds[c].count > cmd_indices ? cmds[c].first + cmds[c].count : cmd_indices;
+  int has_positions = 0;
+  for (unsigned i = 0; i < header->stream_count; i += 1) {
+    void * src = data + streams[i].bytes_first;
+    if (strcmp(streams[i].name, "position") == 0 && streams[i].format == 0x8815) { // GL_RGB32F
+      memcpy(&mesh->positions[vertex_first * 3], src, streams[i].bytes_count);
+      has_positions = 1;
+    } else if (strcmp(streams[i].name, "uv") == 0 && streams[i].format == 0x8230) { // GL_RG32F
+      memcpy(&mesh->uvs[vertex_first * 2], src, streams[i].bytes_count);
+      mesh->has_uvs = 1;
+    } else if (strcmp(streams[i].name, "normal") == 0 && streams[i].format == 0x8815) { // GL_RGB32F
+      memcpy(&mesh->normals[vertex_first * 3], src, streams[i].bytes_count);
+      mesh->has_normals = 1;
+    } else if (strcmp(streams[i].name, "id") == 0 && streams[i].format == 0x8236) { // GL_R32UI
+      for (unsigned v = 0; v < header->vertex_count; v += 1)
+        mesh->ids[vertex_first + v] = cmd_first + ((unsigned *)src)[v];
+      mesh->has_ids = 1;
+    } else if (streams[i].format == 0) {
+      cmd_indices = cmd_indices < streams[i].count ? cmd_indices : streams[i].count;
+      mesh->index_count += cmd_indices;
+      mesh->indices = realloc(mesh->indices, mesh->index_count * sizeof(unsigned));
+      for (unsigned k = 0; k < cmd_indices; k += 1)
+        mesh->indices[index_first + k] = vertex_first + (header->index_type == 0x1403 ? ((unsigned short *)src)[k] : ((unsigned *)src)[k]); // GL_UNSIGNED_SHORT
+    } else {
+      fprintf(stderr, "gpumesh: %s stream %s is already quantized\n", filepath, streams[i].name);
+      free(data);
+      return 0;
+    }
+  }
+  for (unsigned c = 0; c < header->cmd_count; c += 1) {
+    AddCmd(mesh, names[c], 0);
+    mesh->cmds[cmd_first + c] = cmds[c];
+    mesh->cmds[cmd_first + c].first += index_first;
+  }
+  free(data);
+  return has_positions;
+}
+
+static void RemapStream(void * stream, int element_bytes, int vertex_count, unsigned * remap) {
+  char * copy = malloc((size_t)vertex_count * element_bytes);
+  memcpy(copy, stream, (size_t)vertex_count * element_bytes);
+  for (int v = 0; v < vertex_count; v += 1)
+    memcpy((char *)stream + (size_t)remap[v] * element_bytes, copy + (size_t)v * element_bytes, element_bytes);
+  free(copy);
+}
+
+static void TriangleNormal(float * a, float * b, float * c, float * out_n) {
+  float e0[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+  float e1[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+  float n[3] = {e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0]};
+  float l = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  for (int k = 0; k < 3; k += 1)
+    out_n[k] = l > 0 ? n[k] / l : 0;
+}
+
+static void AddCluster(struct gpumesh_t * mesh, int cmd, int triangle_first, int triangle_count) {
+  struct gpu_cmd_t * c = &mesh->cmds[cmd];
+  float * positions = &mesh->positions[c->base_vertex * 3];
+  unsigned * indices = &mesh->indices[triangle_first * 3];
+  float lo[3] = {0, 0, 0};
+  float hi[3] = {0, 0, 0};
+  float axis[3] = {0, 0, 0};
+  for (int i = 0; i < triangle_count * 3; i += 1) {
+    for (int k = 0; k < 3; k += 1) {
+      float p = positions[indices[i] * 3 + k];
+      lo[k] = i == 0 || p < lo[k] ? p : lo[k];
+      hi[k] = i == 0 || p > hi[k] ? p : hi[k];
+    }
+  }
+  for (int t = 0; t < triangle_count; t += 1) {
+    float n[3];
+    TriangleNormal(&positions[indices[t * 3] * 3], &positions[indices[t * 3 + 1] * 3], &positions[indices[t * 3 + 2] * 3], n);
+    for (int k = 0; k < 3; k += 1)
+      axis[k] += n[k];
+  }
+  struct gpu_mesh_cluster_t cluster = {
+    .center = {(lo[0] + hi[0]) / 2, (lo[1] + hi[1]) / 2, (lo[2] + hi[2]) / 2},
+    .cone_cutoff = 1,
+    .cmd = cmd,
+    .first = triangle_first * 3,
+    .count = triangle_count * 3,
+  };
+  for (int i = 0; i < triangle_count * 3; i += 1) {
+    float * p = &positions[indices[i] * 3];
+    float d[3] = {p[0] - cluster.center[0], p[1] - cluster.center[1], p[2] - cluster.center[2]};
+    float r = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    cluster.radius = r > cluster.radius ? r : cluster.radius;
+  }
+  float l = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+  float min_dot = l > 0 ? 1 : -1;
+  for (int t = 0; t < triangle_count && l > 0; t += 1) {
+    float n[3];
+    TriangleNormal(&positions[indices[t * 3] * 3], &positions[indices[t * 3 + 1] * 3], &positions[indices[t * 3 + 2] * 3], n);
+    float dot = (n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2]) / l;
+    min_dot = n[0] == 0 && n[1] == 0 && n[2] == 0 ? min_dot : dot < min_dot ? dot : min_dot;
+  }
+  for (int k = 0; k < 3 && l > 0; k += 1)
+    cluster.cone_axis[k] = axis[k] / l;
+  if (min_dot > 0)
+    cluster.cone_cutoff = sqrtf(1 - min_dot * min_dot);
+  mesh->clusters = realloc(mesh->clusters, (mesh->cluster_count + 1) * sizeof(struct gpu_mesh_cluster_t));
+  mesh->clusters[mesh->cluster_count++] = cluster;
+  mesh->cluster_triangles = triangle_count > mesh->cluster_triangles ? triangle_count : mesh->cluster_triangles;
+}
+
+// With regroup the triangles of every command are regrouped into spatially compact clusters of up to max_triangles, see
+// GpuMeshClusterize, and each cluster is then reordered for the vertex cache on its own. Without it, and for commands
+// sharing indices with an earlier one, triangles keep their order and are cut into runs of max_triangles.
+static void BuildClusters(struct gpumesh_t * mesh, int max_triangles, int regroup) {
+  int triangle_count = mesh->index_count / 3;
+  unsigned * clustered = malloc((mesh->index_count + 1) * sizeof(unsigned));
+  int * clusters = malloc((triangle_count + 1) * sizeof(int));
+  int * fans = malloc((triangle_count + 1) * sizeof(int));
+  char * done = calloc(triangle_count + 1, 1);
+  for (int c = 0; c < mesh->cmd_count; c += 1) {
+    struct gpu_cmd_t * cmd = &mesh->cmds[c];
+    int first = cmd->first / 3;
+    int end = (cmd->first + cmd->count) / 3;
+    int shared = cmd->first % 3 != 0 || cmd->count % 3 != 0 || cmd->first + cmd->count > (unsigned)mesh->index_count;
+    for (int t = first; !shared && t < end; t += 1)
+      shared = done[t];
+    if (shared || !regroup) {
+      for (int t = first; t < end; t += max_triangles)
+        AddCluster(mesh, c, t, end - t < max_triangles ? end - t : max_triangles);
+      continue;
+    }
+    memset(&done[first], 1, end - first);
+    unsigned * indices = &mesh->indices[cmd->first];
+    int cluster_count = GpuMeshClusterize(indices, cmd->count, mesh->vertex_count, &mesh->positions[cmd->base_vertex * 3], max_triangles, clustered, clusters);
+    memcpy(indices, clustered, cmd->count * sizeof(unsigned));
+    for (int k = 0; k < cluster_count; k += 1) {
+      int cluster_end = k + 1 < cluster_count ? clusters[k + 1] : end - first;
+      unsigned * cluster = &indices[clusters[k] * 3];
+      int cluster_indices = (cluster_end - clusters[k]) * 3;
+      GpuMeshTipsify(cluster, cluster_indices, mesh->vertex_count, GPUMESH_CACHE_SIZE, clustered, fans);
+      if (GpuMeshCacheMisses(clustered, cluster_indices, mesh->vertex_count, GPUMESH_CACHE_SIZE) < GpuMeshCacheMisses(cluster, cluster_indices, mesh->vertex_count, GPUMESH_CACHE_SIZE))
+        memcpy(cluster, clustered, cluster_indices * sizeof(unsigned));
+      AddCluster(mesh, c, first + clusters[k], cluster_end - clusters[k]);
+    }
+  }
+  free(clustered);
+  free(clusters);
+  free(fans);
+  free(done);
+}
+
+static void AddLod(struct gpumesh_t * mesh, int cmd, int first, int count, float error) {
+  mesh->lods = realloc(mesh->lods, (mesh->lod_count + 1) * sizeof(struct gpu_mesh_lod_t));
+  mesh->lods[mesh->lod_count++] = (struct gpu_mesh_lod_t){cmd, first, count, error};
+}
+
+// Appends up to level_count - 1 simplified levels of every command to the indices, each with half the triangles of the
+// one before and reordered for the vertex cache. A command stops at the first level that keeps over 3/4 of them.
+static void BuildLods(struct gpumesh_t * mesh, int level_count) {
+  int cmd_indices = mesh->index_count;
+  unsigned * simplified = malloc((cmd_indices + 1) * sizeof(unsigned));
+  unsigned * tipsified = malloc((cmd_indices + 1) * sizeof(unsigned));
+  int * fans = malloc((cmd_indices / 3 + 1) * sizeof(int));
+  for (int c = 0; c < mesh->cmd_count; c += 1) {
+    struct gpu_cmd_t * cmd = &mesh->cmds[c];
+    int levels = 1;
+    AddLod(mesh, c, cmd->first, cmd->count, 0);
+    int count = cmd->count / 3 * 3;
+    if (cmd->first + cmd->count > (unsigned)cmd_indices)
+      count = 0;
+    for (int level = 1; level < level_count; level += 1) {
+      float error = 0;
+      int target = count / 6 * 3;
+      if (target < 3)
+        break;
+      int simplified_count = GpuMeshSimplify(&mesh->indices[cmd->first], cmd->count / 3 * 3, mesh->vertex_count, &mesh->positions[cmd->base_vertex * 3], target, simplified, &error);
+      if (simplified_count == 0 || simplified_count * 4 > count * 3)
+        break;
+      GpuMeshTipsify(simplified, simplified_count, mesh->vertex_count, GPUMESH_CACHE_SIZE, tipsified, fans);
+      if (GpuMeshCacheMisses(tipsified, simplified_count, mesh->vertex_count, GPUMESH_CACHE_SIZE) < GpuMeshCacheMisses(simplified, simplified_count, mesh->vertex_count, GPUMESH_CACHE_SIZE))
+        memcpy(simplified, tipsified, simplified_count * sizeof(unsigned));
+      mesh->indices = realloc(mesh->indices, (mesh->index_count + simplified_count) * sizeof(unsigned));
+      memcpy(&mesh->indices[mesh->index_count], simplified, simplified_count * sizeof(unsigned));
+      AddLod(mesh, c, mesh->index_count, simplified_count, error);
+      mesh->index_count += simplified_count;
+      count = simplified_count;
+      levels += 1;
+    }
+    mesh->lod_levels = levels > mesh->lod_levels ? levels : mesh->lod_levels;
+  }
+  free(simplified);
+  free(tipsified);
+  free(fans);
+}
+
+// Triangles of every command are reordered on their own, commands sharing indices with an earlier one or that would miss
+// the cache more often are left as they are, then regrouped into clusters of up to max_triangles. Vertices are renumbered
+// only when no command has a base_vertex, ACMR and ATVR are printed for the whole pack.
+static void Optimize(struct gpumesh_t * mesh, int max_triangles) {
+  int triangle_count = mesh->index_count / 3;
+  int misses_before = GpuMeshCacheMisses(mesh->indices, mesh->index_count, mesh->vertex_count, GPUMESH_CACHE_SIZE);
+  unsigned * tipsified = malloc((mesh->index_count + 1) * sizeof(unsigned));
+  unsigned * sorted = malloc((mesh->index_count + 1) * sizeof(unsigned));
+  int * clusters = malloc((triangle_count + 1) * sizeof(int));
+  char * done = calloc(triangle_count + 1, 1);
+  int base_vertex = 0;
+  for (int c = 0; c < mesh->cmd_count; c += 1) {
+    struct gpu_cmd_t * cmd = &mesh->cmds[c];
+    base_vertex |= cmd->base_vertex != 0;
+    int shared = cmd->first % 3 != 0 || cmd->count % 3 != 0 || cmd->first + cmd->count > (unsigned)mesh->index_count;
+    for (unsigned t = cmd->first / 3; !shared && t < (cmd->first + cmd->count) / 3; t += 1)
+      shared = done[t];
+    if (shared || cmd->count == 0)
+      continue;
+    memset(&done[cmd->first / 3], 1, cmd->count / 3);
+    unsigned * indices = &mesh->indices[cmd->first];
+    int cluster_count = GpuMeshTipsify(indices, cmd->count, mesh->vertex_count, GPUMESH_CACHE_SIZE, tipsified, clusters);
+    GpuMeshOverdraw(tipsified, cmd->count, mesh->vertex_count, &mesh->positions[cmd->base_vertex * 3], clusters, cluster_count, GPUMESH_CACHE_SIZE, 1.05f, sorted);
+    if (GpuMeshCacheMisses(sorted, cmd->count, mesh->vertex_count, GPUMESH_CACHE_SIZE) < GpuMeshCacheMisses(indices, cmd->count, mesh->vertex_count, GPUMESH_CACHE_SIZE))
+      memcpy(indices, sorted, cmd->count * sizeof(unsigned));
+  }
+  BuildClusters(mesh, max_triangles, 1);
+  int referenced = mesh->vertex_count;
+  if (!base_vertex) {
+    unsigned * remap = malloc((mesh->vertex_count + 1) * sizeof(unsigned));
+    referenced = GpuMeshFetchRemap(mesh->indices, mesh->index_count, mesh->vertex_count, remap);
+    for (int i = 0; i < mesh->index_count; i += 1)
+      mesh->indices[i] = remap[mesh->indices[i]];
+    RemapStream(mesh->positions, 3 * sizeof(float), mesh->vertex_count, remap);
+    if (mesh->has_uvs)
+      RemapStream(mesh->uvs, 2 * sizeof(float), mesh->vertex_count, remap);
+    if (mesh->has_normals)
+      RemapStream(mesh->normals, 3 * sizeof(float), mesh->vertex_count, remap);
+    if (mesh->has_ids)
+      RemapStream(mesh->ids, sizeof(unsigned), mesh->vertex_count, remap);
+    free(remap);
+  }
+  int misses_after = GpuMeshCacheMisses(mesh->indices, mesh->index_count, mesh->vertex_count, GPUMESH_CACHE_SIZE);
+  printf("ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %d-vertex FIFO cache%s\n",
+      (double)misses_before / triangle_count, (double)misses_after / triangle_count,
+      (double)misses_before / referenced, (double)misses_after / referenced, GPUMESH_CACHE_SIZE,
+      base_vertex ? ", vertices kept in place for commands with a base_vertex" : "");
+  free(tipsified);
+  free(sorted);
+  free(clusters);
+  free(done);
+}
+
+// Round to nearest even, overflow becomes infinity and values below the smallest normal flush to zero
+static unsigned short FloatToHalf(float f) {
+  unsigned x = 0;
+  memcpy(&x, &f, 4);
+  unsigned sign = (x >> 16) & 0x8000;
+  int exponent = (int)((x >> 23) & 0xFF) - 127 + 15;
+  unsigned mantissa = x & 0x7FFFFF;
+  if (((x >> 23) & 0xFF) == 0xFF)
+    return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+  if (exponent >= 31)
+    return sign | 0x7C00;
+  if (exponent <= 0)
+    return sign;
+  unsigned h = sign | (exponent << 10) | (mantissa >> 13);
+  unsigned rest = mantissa & 0x1FFF;
+  if (rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+    h += 1;
+  return h;
+}
+
+static void DecodeOctahedral(float u, float v, float * out_n) {
+  float x = u * 2 - 1, y = v * 2 - 1, z = 1 - fabsf(x) - fabsf(y);
+  float t = z < 0 ? -z : 0;
+  x += x >= 0 ? -t : t;
+  y += y >= 0 ? -t : t;
+  float l = sqrtf(x * x + y * y + z * z);
+  out_n[0] = x / l;
+  out_n[1] = y / l;
+  out_n[2] = z / l;
+}
+
+// Of the four roundings around the projected point keeps the one that decodes closest to n, as GpuDecodeOctahedral does
+static void EncodeOctahedral(float * n, int bits, unsigned * out_uv) {
+  float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+  float l2 = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  if (l1 == 0) {
+    out_uv[0] = out_uv[1] = (1u << (bits - 1));
+    return;
+  }
+  float x = n[0] / l1, y = n[1] / l1;
+  if (n[2] < 0) {
+    float ox = (1 - fabsf(y)) * (x >= 0 ? 1 : -1);
+    float oy = (1 - fabsf(x)) * (y >= 0 ? 1 : -1);
+    x = ox;
+    y = oy;
+  }
+  float max = (float)((1u << bits) - 1);
+  float u = (x * 0.5f + 0.5f) * max, v = (y * 0.5f + 0.5f) * max;
+  float best = -2;
+  for (int i = 0; i < 4; i += 1) {
+    float qu = (i & 1) ? ceilf(u) : floorf(u);
+    float qv = (i & 2) ? ceilf(v) : floorf(v);
+    float d[3];
+    DecodeOctahedral(qu / max, qv / max, d);
+    float dot = (d[0] * n[0] + d[1] * n[1] + d[2] * n[2]) / l2;
+    if (dot > best) {
+      best = dot;
+      out_uv[0] = (unsigned)qu;
+      out_uv[1] = (unsigned)qv;
+    }
+  }
+}
+
+// normal_bits is 0 for float normals or 8 or 16 for octahedral ones, quantize also narrows positions and uvs.
+// Indices are narrowed to 16 bits when they all fit unless index32 is set.
+static int Write(struct gpumesh_t * mesh, char * out_filepath, int quantize, int normal_bits, int index32) {
+  float aabb_min[3] = {0, 0, 0};
+  float aabb_max[3] = {0, 0, 0};
+  for (int i = 0; i < mesh->vertex_count; i += 1) {
+    for (int c = 0; c < 3; c += 1) {
+      float p = mesh->positions[i * 3 + c];
+      aabb_min[c] = i == 0 || p < aabb_min[c] ? p : aabb_min[c];
+      aabb_max[c] = i == 0 || p > aabb_max[c] ? p : aabb_max[c];
+    }
+  }
+  unsigned short * positions = NULL;
+  unsigned short * uvs = NULL;
+  void * normals = NULL;
+  if (quantize) {
+    positions = calloc(mesh->vertex_count, 4 * sizeof(unsigned short));
+    for (int i = 0; i < mesh->vertex_count; i += 1) {
+      for (int c = 0; c < 3; c += 1) {
+        float extent = aabb_max[c] - aabb_min[c];
+        float q = extent > 0 ? (mesh->positions[i * 3 + c] - aabb_min[c]) / extent : 0;
+        positions[i * 4 + c] = (unsigned short)(q * 65535 + 0.5f);
+      }
+    }
+  }
+  if (quantize && mesh->has_uvs) {
+    uvs = malloc(mesh->vertex_count * 2 * sizeof(unsigned short));
+    for (int i = 0; i < mesh->vertex_count * 2; i += 1)
+      uvs[i] = FloatToHalf(mesh->uvs[i]);
+  }
+  if (normal_bits != 0 && mesh->has_normals) {
+    normals = malloc(mesh->vertex_count * 2 * (normal_bits / 8));
+    for (int i = 0; i < mesh->vertex_count; i += 1) {
+      unsigned uv[2];
+      EncodeOctahedral(&mesh->normals[i * 3], normal_bits, uv);
+      for (int c = 0; c < 2; c += 1) {
+        if (normal_bits == 8)
+          ((unsigned char *)normals)[i * 2 + c] = (unsigned char)uv[c];
+        else
+          ((unsigned short *)normals)[i * 2 + c] = (unsigned short)uv[c];
+      }
+    }
+  }
+
+  struct gpu_mesh_file_stream_t streams[5] = {0};
+  void * datas[5] = {0};
+  int stream_count = 0;
+  struct {
+    char * name;
+    unsigned format;
+    unsigned element_bytes;
+    void * data;
+  } sources[] = {
+    {"position", 0x8815, 3 * sizeof(float),          quantize ? NULL : mesh->positions}, // GL_RGB32F
+    {"position", 0x805B, 4 * sizeof(unsigned short), positions},                         // GL_RGBA16
+    {"uv",       0x8230, 2 * sizeof(float),          quantize ? NULL : mesh->uvs},       // GL_RG32F
+    {"uv",       0x822F, 2 * sizeof(unsigned short), uvs},                               // GL_RG16F
+    {"normal",   0x8815, 3 * sizeof(float),          normal_bits ? NULL : mesh->normals}, // GL_RGB32F
+    {"normal",   0x822B, 2 * sizeof(unsigned char),  normal_bits == 8 ? normals : NULL}, // GL_RG8
+    {"normal",   0x822C, 2 * sizeof(unsigned short), normal_bits == 16 ? normals : NULL}, // GL_RG16
+    {"id",       0x8236, sizeof(unsigned),           mesh->ids},                         // GL_R32UI
+  };
+  for (int i = 0; i < (int)(sizeof(sources) / sizeof(sources[0])); i += 1) {
+    if ((strcmp(sources[i].name, "uv") == 0 && !mesh->has_uvs) || (strcmp(sources[i].name, "normal") == 0 && !mesh->has_normals) ||
+        (strcmp(sources[i].name, "id") == 0 && !mesh->has_ids))
+      continue;
+    if (sources[i].data == NULL)
+      continue;
+    strncpy(streams[stream_count].name, sources[i].name, GPULIB_MESH_FILE_NAME_BYTES - 1);
+    streams[stream_count].format = sources[i].format;
+    streams[stream_count].count = mesh->vertex_count;
+    streams[stream_count].bytes_count = (unsigned long)mesh->vertex_count * sources[i].element_bytes;
+    datas[stream_count] = sources[i].data;
+    stream_count += 1;
+  }
+  unsigned short * indices16 = NULL;
+  for (int i = 0; i < mesh->index_count && !index32; i += 1)
+    index32 = mesh->indices[i] > 0xFFFF;
+  if (!index32) {
+    indices16 = malloc(mesh->index_count * sizeof(unsigned short));
+    for (int i = 0; i < mesh->index_count; i += 1)
+      indices16[i] = (unsigned short)mesh->indices[i];
+  }
+  strncpy(streams[stream_count].name, "index", GPULIB_MESH_FILE_NAME_BYTES - 1);
+  streams[stream_count].count = mesh->index_count;
+  streams[stream_count].bytes_count = (unsigned long)mesh->index_count * (index32 ? sizeof(unsigned) : sizeof(unsigned short));
+  datas[stream_count] = index32 ? (void *)mesh->indices : (void *)indices16;
+  stream_count += 1;
+
+  unsigned long offset = sizeof(struct gpu_mesh_file_t) + stream_count * sizeof(struct gpu_mesh_file_stream_t) +
+      mesh->cmd_count * (sizeof(struct gpu_cmd_t) + GPULIB_MESH_FILE_NAME_BYTES) + mesh->cluster_count * sizeof(struct gpu_mesh_cluster_t) +
+      mesh->lod_count * sizeof(struct gpu_mesh_lod_t);
+  for (int i = 0; i < stream_count; i += 1) {
+    offset = (offset + GPULIB_MESH_FILE_ALIGNMENT - 1) / GPULIB_MESH_FILE_ALIGNMENT * GPULIB_MESH_FILE_ALIGNMENT;
+    streams[i].bytes_first = offset;
+    offset += streams[i].bytes_count;
+  }
+  struct gpu_mesh_file_t header = {
+    .magic        = GPULIB_MESH_FILE_MAGIC,
+    .version      = GPULIB_MESH_FILE_VERSION,
+    .vertex_count = mesh->vertex_count,
+    .index_type   = index32 ? 0x1405 : 0x1403, // GL_UNSIGNED_INT, GL_UNSIGNED_SHORT
+    .stream_count = stream_count,
+    .cmd_count    = mesh->cmd_count,
+    .file_bytes   = offset,
+    .aabb_min     = {aabb_min[0], aabb_min[1], aabb_min[2]},
+    .aabb_max     = {aabb_max[0], aabb_max[1], aabb_max[2]},
+    .cluster_count     = mesh->cluster_count,
+    .cluster_triangles = mesh->cluster_triangles,
+    .lod_count         = mesh->lod_count,
+    .lod_levels        = mesh->lod_levels,
+  };
+
+  FILE * f = fopen(out_filepath, "wb");
+  if (f == NULL) {
+    fprintf(stderr, "gpumesh: can't write %s\n", out_filepath);
+    return 0;
+  }
+  static unsigned char zeros[GPULIB_MESH_FILE_ALIGNMENT];
+  fwrite(&header, sizeof(header), 1, f);
+  fwrite(streams, sizeof(struct gpu_mesh_file_stream_t), stream_count, f);
+  fwrite(mesh->cmds, sizeof(struct gpu_cmd_t), mesh->cmd_count, f);
+  fwrite(mesh->names, GPULIB_MESH_FILE_NAME_BYTES, mesh->cmd_count, f);
+  fwrite(mesh->clusters, sizeof(struct gpu_mesh_cluster_t), mesh->cluster_count, f);
+  fwrite(mesh->lods, sizeof(struct gpu_mesh_lod_t), mesh->lod_count, f);
+  unsigned long written = sizeof(struct gpu_mesh_file_t) + stream_count * sizeof(struct gpu_mesh_file_stream_t) +
+      mesh->cmd_count * (sizeof(struct gpu_cmd_t) + GPULIB_MESH_FILE_NAME_BYTES) + mesh->cluster_count * sizeof(struct gpu_mesh_cluster_t) +
+      mesh->lod_count * sizeof(struct gpu_mesh_lod_t);
+  for (int i = 0; i < stream_count; i += 1) {
+    fwrite(zeros, 1, streams[i].bytes_first - written, f);
+    fwrite(datas[i], 1, streams[i].bytes_count, f);
+    written = streams[i].bytes_first + streams[i].bytes_count;
+  }
+  fclose(f);
+  free(positions);
+  free(uvs);
+  free(normals);
+  free(indices16);
+  printf("%s: %d vertices, %d %d-bit indices, %d commands, %d clusters, %d levels of detail, %d streams, %lu bytes\n",
+      out_filepath, mesh->vertex_count, mesh->index_count, index32 ? 32 : 16, mesh->cmd_count, mesh->cluster_count,
+      mesh->lod_count, stream_count, offset);
+  return 1;
+}
+
+static int Usage() {
+  fprintf(stderr,
+      "Usage: gpumesh [-o out.gpumesh] [-quantize] [-oct8] [-index32] [-noopt] [-cluster n] [-lod n] input.obj|input.gpumesh...\n"
+      "       gpumesh [-o out.gpumesh] [-quantize] [-oct8] [-index32] [-noopt] [-cluster n] [-lod n] -legacy meshes_dir\n"
+      "  -legacy   convert MeshVB/MeshIB/MeshUV/MeshNormals/MeshID .binary files and their generated MeshIBVB.h\n"
+      "  -quantize 16-bit positions in the mesh bounds, half float uvs and 2x16-bit octahedral normals\n"
+      "  -oct8     2x8-bit octahedral normals, implies -quantize\n"
+      "  -index32  keep 32-bit indices, by default they are narrowed to 16 bits when every index fits\n"
+      "  -noopt    keep the input triangle and vertex order, by default both are reordered for the vertex cache and overdraw\n"
+      "  -cluster  most triangles per culling cluster, 128 by default\n"
+      "  -lod      levels of detail per command from 1 to 5, the full one included, 4 by default\n");
+  return 1;
+}
+
+int main(int argc, char ** argv) {
+  char * out_filepath = "gpumesh.gpumesh";
+  char * legacy_dir = NULL;
+  int quantize = 0;
+  int normal_bits = 0;
+  int index32 = 0;
+  int optimize = 1;
+  int cluster_triangles = 128;
+  int lod_levels = 4;
+  char ** inputs = malloc(argc * sizeof(char *));
+  int inputs_count = 0;
+  for (int i = 1; i < argc; i += 1) {
+    if      (strcmp(argv[i], "-legacy") == 0 && i + 1 < argc) legacy_dir = argv[++i];
+    else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out_filepath = argv[++i];
+    else if (strcmp(argv[i], "-quantize") == 0) quantize = 1, normal_bits = normal_bits ? normal_bits : 16;
+    else if (strcmp(argv[i], "-oct8") == 0) quantize = 1, normal_bits = 8;
+    else if (strcmp(argv[i], "-index32") == 0) index32 = 1;
+    else if (strcmp(argv[i], "-noopt") == 0) optimize = 0;
+    else if (strcmp(argv[i], "-cluster") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) cluster_triangles = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-lod") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 1 && atoi(argv[i + 1]) <= 5) lod_levels = atoi(argv[++i]);
+    else if (argv[i][0] == '-') return Usage();
+    else inputs[inputs_count++] = argv[i];
+  }
+  if ((legacy_dir == NULL) == (inputs_count == 0))
+    return Usage();
+
+  struct gpumesh_t mesh = {0};
+  if (legacy_dir != NULL && !LoadLegacy(legacy_dir, &mesh))
+    return 1;
+  for (int i = 0; i < inputs_count; i += 1) {
+    size_t n = strlen(inputs[i]);
+    int pack = n > 8 && strcmp(inputs[i] + n - 8, ".gpumesh") == 0;
+    if (!(pack ? LoadPack(inputs[i], &mesh) : LoadObj(inputs[i], &mesh)))
+      return 1;
+  }
+  if (mesh.index_count == 0) {
+    fprintf(stderr, "gpumesh: no triangles in the inputs\n");
+    return 1;
+  }
+  BuildLods(&mesh, lod_levels);
+  if (optimize)
+    Optimize(&mesh, cluster_triangles);
+  else
+    BuildClusters(&mesh, cluster_triangles, 0);
+  return Write(&mesh, out_filepath, quantize, normal_bits, index32) ? 0 : 1;
+}